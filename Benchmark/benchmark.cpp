@@ -0,0 +1,613 @@
+//
+//  benchmark.cpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+/*!
+ * \brief Timings of the public matrix and vector operations
+ * \details Every operation is run over a sweep of element types and sizes, next to a
+ * naive baseline where one makes sense: the same computation written as plain loops over
+ * a std::vector. Each measurement is calibrated to run for about --min-time seconds, and
+ * the best of --repetitions runs is reported.
+ *
+ * The output has one record per measurement, as CSV (the default) or as a JSON array:
+ *
+ * \verbatim
+ * op,impl,type,rows,cols,iterations,ns_per_op,gb_per_s,gflop_per_s
+ * mat_add,mymat,double,4,4,20971520,3.125,40.96,5.12
+ * \endverbatim
+ *
+ * GB/s counts the bytes an operation must read and write at least once, and GFLOP/s the
+ * arithmetic operations of the textbook algorithm, so that the two implementations of an
+ * operation are compared on the same scale.
+ *
+ * \verbatim
+ * benchmark [--format csv|json] [--filter text] [--min-time seconds] [--repetitions n] [--serial]
+ * \endverbatim
+ *
+ * --filter keeps the measurements whose "op/impl/type/rowsxcols" name contains the text,
+ * and --serial runs everything on the calling thread (see myexec.h).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "myvecbatch.h"
+#include "mydecomp.h"
+#include "mysparse.h"
+
+using namespace MyMatrix;
+using namespace MyVector;
+
+namespace {
+
+// Make the compiler assume value is read, and memory written, so that a benchmarked
+// operation can neither be removed nor hoisted out of the timing loop
+template <typename T>
+inline void doNotOptimize(const T &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void * volatile sink;
+    sink = &value;
+#endif
+}
+
+template <typename T> const char* typeName();
+template <> const char* typeName<float>() { return "float"; }
+template <> const char* typeName<double>() { return "double"; }
+template <> const char* typeName<int>() { return "int32"; }
+
+struct Options {
+    std::string format = "csv";
+    std::string filter;
+    double minTime = 0.2;
+    int repetitions = 3;
+    bool serial = false;
+};
+
+class Bench {
+public:
+    explicit Bench(const Options &options) : options_(options) {}
+
+    // Time f, that performs one operation moving bytes and computing flops
+    template <typename F>
+    void run(const char *op, const char *impl, const char *type, size_t rows, size_t cols,
+             double bytes, double flops, F &&f);
+
+    void begin();
+    void end();
+
+private:
+    template <typename F>
+    static double seconds(size_t iterations, F &f);
+
+    Options options_;
+    size_t count_ = 0;
+};
+
+template <typename F>
+double Bench::seconds(size_t iterations, F &f)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        f();
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+template <typename F>
+void Bench::run(const char *op, const char *impl, const char *type, size_t rows, size_t cols,
+                double bytes, double flops, F &&f)
+{
+    std::string name = std::string(op) + "/" + impl + "/" + type + "/" + std::to_string(rows) + "x" + std::to_string(cols);
+    if (!options_.filter.empty() && name.find(options_.filter) == std::string::npos) {
+        return;
+    }
+
+    // Grow the iteration count until a run is long enough to time, then size it so
+    // that all the repetitions take about minTime
+    f();
+    double runTime = options_.minTime / options_.repetitions;
+    size_t iterations = 1;
+    double elapsed = seconds(iterations, f);
+    while (elapsed < runTime / 10 && iterations < (size_t(1) << 40)) {
+        iterations *= elapsed > 0 ? std::clamp(static_cast<size_t>(runTime / 10 / elapsed * 2), size_t(2), size_t(100)) : 100;
+        elapsed = seconds(iterations, f);
+    }
+    iterations = std::max<size_t>(1, static_cast<size_t>(runTime / (elapsed / iterations)));
+
+    double best = std::numeric_limits<double>::infinity();
+    for (int r = 0; r < options_.repetitions; ++r) {
+        best = std::min(best, seconds(iterations, f) / iterations);
+    }
+    double ns = best * 1e9;
+
+    std::ostream &os = std::cout;
+    if (options_.format == "json") {
+        os << (count_ ? ",\n" : "") << "  {\"op\": \"" << op << "\", \"impl\": \"" << impl << "\", \"type\": \"" << type
+           << "\", \"rows\": " << rows << ", \"cols\": " << cols << ", \"iterations\": " << iterations
+           << ", \"ns_per_op\": " << ns << ", \"gb_per_s\": " << bytes / ns << ", \"gflop_per_s\": " << flops / ns << "}";
+    }
+    else {
+        os << op << "," << impl << "," << type << "," << rows << "," << cols << "," << iterations << ","
+           << ns << "," << bytes / ns << "," << flops / ns << "\n";
+    }
+    os.flush();
+    ++count_;
+}
+
+void Bench::begin()
+{
+    if (options_.format == "json") {
+        std::cout << "[\n";
+    }
+    else {
+        std::cout << "op,impl,type,rows,cols,iterations,ns_per_op,gb_per_s,gflop_per_s\n";
+    }
+}
+
+void Bench::end()
+{
+    if (options_.format == "json") {
+        std::cout << "\n]\n";
+    }
+}
+
+// Small values, so that integer arithmetic can't overflow
+template <typename Iter>
+void fillRandom(Iter first, Iter last, unsigned seed)
+{
+    using T = typename std::iterator_traits<Iter>::value_type;
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> dist(-9, 9);
+    std::generate(first, last, [&] { return static_cast<T>(dist(gen)) / (std::is_integral_v<T> ? T(1) : T(8)); });
+}
+
+// A well conditioned symmetric positive definite matrix
+template <typename M>
+void fillSpd(M &m, size_t n)
+{
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j < n; ++j) {
+            m(i,j) = i == j ? static_cast<typename M::value_type>(n) : static_cast<typename M::value_type>(1) / static_cast<typename M::value_type>(1 + i + j);
+        }
+    }
+}
+
+// Element-wise operations, shared by MyMat and MyDynMat. The accumulating operations
+// add zeros for integer types, so that repeating them can't overflow.
+template <typename T, typename M>
+void benchElementWise(Bench &bench, const char *impl, M &a, M &b, M &c, size_t rows, size_t cols)
+{
+    const char *type = typeName<T>();
+    double n = static_cast<double>(rows * cols);
+    double es = sizeof(T);
+    double scale = 1;
+    M inc = a;
+    if constexpr (std::is_integral_v<T>) {
+        inc *= 0;
+    }
+    doNotOptimize(a);
+    doNotOptimize(b);
+    doNotOptimize(inc);
+    doNotOptimize(scale);
+
+    bench.run("mat_add", impl, type, rows, cols, 3 * n * es, n, [&] { c = a + b; doNotOptimize(c); });
+    bench.run("mat_sub", impl, type, rows, cols, 3 * n * es, n, [&] { c = a - b; doNotOptimize(c); });
+    bench.run("mat_axpy_expr", impl, type, rows, cols, 3 * n * es, 2 * n, [&] { c = a + 2 * b; doNotOptimize(c); });
+    bench.run("mat_add_assign", impl, type, rows, cols, 3 * n * es, n, [&] { c += inc; doNotOptimize(c); });
+    bench.run("mat_sub_assign", impl, type, rows, cols, 3 * n * es, n, [&] { c -= inc; doNotOptimize(c); });
+    bench.run("mat_scale", impl, type, rows, cols, 2 * n * es, n, [&] { c *= scale; doNotOptimize(c); });
+    bench.run("mat_copy_transposed", impl, type, rows, cols, 2 * n * es, 0, [&] { c = a.copyTransposed(); doNotOptimize(c); });
+    c = a;
+    bench.run("mat_equal", impl, type, rows, cols, 2 * n * es, 0, [&] { bool eq = a == c; doNotOptimize(eq); });
+    std::ostringstream os;
+    bench.run("mat_render", impl, type, rows, cols, n * es, 0, [&] { os.str(""); os << a; doNotOptimize(os); });
+}
+
+// The naive baselines, on a row-major std::vector
+template <typename T>
+void benchNaiveMatrix(Bench &bench, size_t rows, size_t cols, bool product)
+{
+    const char *type = typeName<T>();
+    size_t count = rows * cols;
+    double n = static_cast<double>(count);
+    double es = sizeof(T);
+    std::vector<T> a(count), b(count), c(count);
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    std::vector<T> inc = a;
+    if constexpr (std::is_integral_v<T>) {
+        std::fill(inc.begin(), inc.end(), T(0));
+    }
+    double scale = 1;
+    doNotOptimize(a);
+    doNotOptimize(b);
+    doNotOptimize(inc);
+    doNotOptimize(scale);
+
+    bench.run("mat_add", "naive", type, rows, cols, 3 * n * es, n, [&] {
+        for (size_t k = 0; k < count; ++k) {
+            c[k] = a[k] + b[k];
+        }
+        doNotOptimize(c);
+    });
+    bench.run("mat_sub", "naive", type, rows, cols, 3 * n * es, n, [&] {
+        for (size_t k = 0; k < count; ++k) {
+            c[k] = a[k] - b[k];
+        }
+        doNotOptimize(c);
+    });
+    bench.run("mat_axpy_expr", "naive", type, rows, cols, 3 * n * es, 2 * n, [&] {
+        for (size_t k = 0; k < count; ++k) {
+            c[k] = a[k] + 2 * b[k];
+        }
+        doNotOptimize(c);
+    });
+    bench.run("mat_add_assign", "naive", type, rows, cols, 3 * n * es, n, [&] {
+        for (size_t k = 0; k < count; ++k) {
+            c[k] += inc[k];
+        }
+        doNotOptimize(c);
+    });
+    bench.run("mat_scale", "naive", type, rows, cols, 2 * n * es, n, [&] {
+        for (size_t k = 0; k < count; ++k) {
+            c[k] = static_cast<T>(c[k] * scale);
+        }
+        doNotOptimize(c);
+    });
+    bench.run("mat_copy_transposed", "naive", type, rows, cols, 2 * n * es, 0, [&] {
+        for (size_t i = 0; i < rows; ++i) {
+            for (size_t j = 0; j < cols; ++j) {
+                c[j * rows + i] = a[i * cols + j];
+            }
+        }
+        doNotOptimize(c);
+    });
+    c = a;
+    bench.run("mat_equal", "naive", type, rows, cols, 2 * n * es, 0, [&] {
+        bool eq = std::equal(a.begin(), a.end(), c.begin());
+        doNotOptimize(eq);
+    });
+
+    if (product) {
+        size_t m = rows;
+        bench.run("mat_multiply", "naive", type, m, m, 3 * n * es, 2.0 * n * static_cast<double>(m), [&] {
+            for (size_t i = 0; i < m; ++i) {
+                for (size_t j = 0; j < m; ++j) {
+                    T sum = 0;
+                    for (size_t p = 0; p < m; ++p) {
+                        sum += a[i * m + p] * b[p * m + j];
+                    }
+                    c[i * m + j] = sum;
+                }
+            }
+            doNotOptimize(c);
+        });
+    }
+}
+
+template <typename T, size_t N>
+void benchFixedMatrix(Bench &bench)
+{
+    MyMat<T,N,N> a, b, c;
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    benchElementWise<T>(bench, "mymat", a, b, c, N, N);
+
+    double n = N * N;
+    bench.run("mat_multiply", "mymat", typeName<T>(), N, N, 3 * n * sizeof(T), 2 * n * N, [&] { c = a * b; doNotOptimize(c); });
+
+    if constexpr (std::is_floating_point_v<T>) {
+        MyMat<T,N,N> spd;
+        fillSpd(spd, N);
+        MyMat<T,N,1> rhs, x;
+        fillRandom(rhs.begin(), rhs.end(), 3);
+        doNotOptimize(spd);
+        double flops = 2.0 * n * N / 3;
+        bench.run("mat_lu_solve", "mymat", typeName<T>(), N, N, n * sizeof(T), flops, [&] { bool ok = solve(spd, rhs, x); doNotOptimize(ok); doNotOptimize(x); });
+        bench.run("mat_determinant", "mymat", typeName<T>(), N, N, n * sizeof(T), flops, [&] { T d = determinant(spd); doNotOptimize(d); });
+        bench.run("mat_cholesky", "mymat", typeName<T>(), N, N, 2 * n * sizeof(T), flops / 2, [&] { c = spd; bool ok = choleskyDecompose(c); doNotOptimize(ok); });
+    }
+    benchNaiveMatrix<T>(bench, N, N, true);
+}
+
+template <typename T>
+void benchDynamicMatrix(Bench &bench, size_t size)
+{
+    MyDynMat<T> a(size, size), b(size, size), c(size, size);
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    benchElementWise<T>(bench, "mydynmat", a, b, c, size, size);
+
+    double n = static_cast<double>(size * size);
+    double cube = n * static_cast<double>(size);
+    bench.run("mat_multiply", "mydynmat", typeName<T>(), size, size, 3 * n * sizeof(T), 2 * cube, [&] { c = a * b; doNotOptimize(c); });
+
+    if constexpr (std::is_floating_point_v<T>) {
+        MyDynMat<T> spd(size, size);
+        fillSpd(spd, size);
+        doNotOptimize(spd);
+        std::vector<size_t> pivots;
+        std::vector<T> tau;
+        // The decompositions work in place, the copy of the input is part of the timing
+        bench.run("mat_lu", "mydynmat", typeName<T>(), size, size, 2 * n * sizeof(T), 2 * cube / 3, [&] { c = spd; bool ok = luDecompose(c, pivots); doNotOptimize(ok); });
+        bench.run("mat_cholesky", "mydynmat", typeName<T>(), size, size, 2 * n * sizeof(T), cube / 3, [&] { c = spd; bool ok = choleskyDecompose(c); doNotOptimize(ok); });
+        bench.run("mat_qr", "mydynmat", typeName<T>(), size, size, 2 * n * sizeof(T), 4 * cube / 3, [&] { c = spd; qrDecompose(c, tau); doNotOptimize(c); });
+    }
+    benchNaiveMatrix<T>(bench, size, size, size <= 512);
+}
+
+template <typename T, typename V>
+void benchVectorOps(Bench &bench, const char *impl, V &a, V &b, V &c, size_t size)
+{
+    const char *type = typeName<T>();
+    double n = static_cast<double>(size);
+    double es = sizeof(T);
+    double scale = 1;
+    doNotOptimize(a);
+    doNotOptimize(b);
+    doNotOptimize(scale);
+
+    bench.run("vec_add", impl, type, size, 1, 3 * n * es, n, [&] { c = a + b; doNotOptimize(c); });
+    bench.run("vec_sub", impl, type, size, 1, 3 * n * es, n, [&] { c = a - b; doNotOptimize(c); });
+    bench.run("vec_scale", impl, type, size, 1, 2 * n * es, n, [&] { c = a * scale; doNotOptimize(c); });
+    bench.run("vec_dot", impl, type, size, 1, 2 * n * es, 2 * n, [&] { double d = dotProduct(a, b); doNotOptimize(d); });
+    bench.run("vec_magnitude", impl, type, size, 1, n * es, 2 * n, [&] { double m = magnitude(a); doNotOptimize(m); });
+    if constexpr (std::is_floating_point_v<T>) {
+        bench.run("vec_normalize", impl, type, size, 1, 2 * n * es, 3 * n, [&] { c = a; c.normalize(); doNotOptimize(c); });
+    }
+    c = a;
+    bench.run("vec_equal", impl, type, size, 1, 2 * n * es, 0, [&] { bool eq = a == c; doNotOptimize(eq); });
+    std::ostringstream os;
+    bench.run("vec_render", impl, type, size, 1, n * es, 0, [&] { os.str(""); os << a; doNotOptimize(os); });
+}
+
+template <typename T>
+void benchNaiveVector(Bench &bench, size_t size)
+{
+    const char *type = typeName<T>();
+    double n = static_cast<double>(size);
+    double es = sizeof(T);
+    std::vector<T> a(size), b(size), c(size);
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    doNotOptimize(a);
+    doNotOptimize(b);
+
+    bench.run("vec_add", "naive", type, size, 1, 3 * n * es, n, [&] {
+        for (size_t k = 0; k < size; ++k) {
+            c[k] = a[k] + b[k];
+        }
+        doNotOptimize(c);
+    });
+    bench.run("vec_dot", "naive", type, size, 1, 2 * n * es, 2 * n, [&] {
+        T d = 0;
+        for (size_t k = 0; k < size; ++k) {
+            d += a[k] * b[k];
+        }
+        doNotOptimize(d);
+    });
+    if constexpr (std::is_floating_point_v<T>) {
+        bench.run("vec_normalize", "naive", type, size, 1, 2 * n * es, 3 * n, [&] {
+            T m = 0;
+            for (size_t k = 0; k < size; ++k) {
+                m += a[k] * a[k];
+            }
+            T inv = 1 / std::sqrt(m);
+            for (size_t k = 0; k < size; ++k) {
+                c[k] = a[k] * inv;
+            }
+            doNotOptimize(c);
+        });
+    }
+}
+
+template <typename T, size_t N>
+void benchFixedVector(Bench &bench)
+{
+    MyVec<T,N> a, b, c;
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    benchVectorOps<T>(bench, "myvec", a, b, c, N);
+    if constexpr (N == 3) {
+        bench.run("vec_cross", "myvec", typeName<T>(), 3, 1, 9 * sizeof(T), 9, [&] { c = crossProduct(a, b); doNotOptimize(c); });
+        std::vector<T> x(a.begin(), a.end()), y(b.begin(), b.end()), z(3);
+        doNotOptimize(x);
+        doNotOptimize(y);
+        bench.run("vec_cross", "naive", typeName<T>(), 3, 1, 9 * sizeof(T), 9, [&] {
+            z[0] = x[1] * y[2] - x[2] * y[1];
+            z[1] = x[2] * y[0] - x[0] * y[2];
+            z[2] = x[0] * y[1] - x[1] * y[0];
+            doNotOptimize(z);
+        });
+    }
+    benchNaiveVector<T>(bench, N);
+}
+
+template <typename T>
+void benchDynamicVector(Bench &bench, size_t size)
+{
+    MyDynVec<T> a(size), b(size), c(size);
+    fillRandom(a.begin(), a.end(), 1);
+    fillRandom(b.begin(), b.end(), 2);
+    benchVectorOps<T>(bench, "mydynvec", a, b, c, size);
+    benchNaiveVector<T>(bench, size);
+}
+
+// Batches of 3D vectors against the same operation on an array of MyVec
+template <typename T>
+void benchBatch(Bench &bench, size_t count)
+{
+    const char *type = typeName<T>();
+    double n = static_cast<double>(count);
+    std::vector<MyVec<T,3>> points(count);
+    std::mt19937 gen(4);
+    std::uniform_real_distribution<T> dist(-1, 1);
+    for (auto &p : points) {
+        p = MyVec<T,3>{dist(gen), dist(gen), dist(gen)};
+    }
+    MyVecBatch<T,3> batch(points.begin(), points.end());
+    MyVecBatch<T,3> work = batch;
+    MyVec<T,3> axis{0, 0, 1};
+    MyMat<T,4,4> transform{0, -1, 0, 1,  1, 0, 0, 2,  0, 0, 1, 3,  0, 0, 0, 1};
+    std::vector<T> dots(count);
+    doNotOptimize(batch);
+
+    bench.run("batch_normalize", "myvecbatch", type, count, 3, 6 * n * sizeof(T), 9 * n, [&] { work = batch; work.normalize(); doNotOptimize(work); });
+    bench.run("batch_normalize_fast", "myvecbatch", type, count, 3, 6 * n * sizeof(T), 9 * n, [&] { work = batch; work.normalizeFast(); doNotOptimize(work); });
+    bench.run("batch_dot", "myvecbatch", type, count, 3, 4 * n * sizeof(T), 5 * n, [&] { dotProduct(batch, axis, dots.data()); doNotOptimize(dots); });
+    bench.run("batch_transform", "myvecbatch", type, count, 3, 6 * n * sizeof(T), 18 * n, [&] { transformPoints(transform, work); doNotOptimize(work); });
+
+    std::vector<MyVec<T,3>> copy = points;
+    bench.run("batch_normalize", "myvec", type, count, 3, 6 * n * sizeof(T), 9 * n, [&] {
+        copy = points;
+        for (auto &p : copy) {
+            p.normalize();
+        }
+        doNotOptimize(copy);
+    });
+    bench.run("batch_dot", "myvec", type, count, 3, 4 * n * sizeof(T), 5 * n, [&] {
+        for (size_t i = 0; i < count; ++i) {
+            dots[i] = static_cast<T>(dotProduct(points[i], axis));
+        }
+        doNotOptimize(dots);
+    });
+    bench.run("batch_transform", "myvec", type, count, 3, 6 * n * sizeof(T), 18 * n, [&] {
+        for (auto &p : copy) {
+            p = transformPoint(transform, p);
+        }
+        doNotOptimize(copy);
+    });
+}
+
+// The 5-point Laplacian of a grid x grid mesh
+template <typename T>
+void benchSparse(Bench &bench, size_t grid)
+{
+    size_t size = grid * grid;
+    MyCooMat<T> coo(size, size);
+    coo.reserve(5 * size);
+    for (size_t i = 0; i < grid; ++i) {
+        for (size_t j = 0; j < grid; ++j) {
+            size_t r = i * grid + j;
+            coo.add(r, r, 4);
+            if (i > 0) coo.add(r, r - grid, -1);
+            if (i + 1 < grid) coo.add(r, r + grid, -1);
+            if (j > 0) coo.add(r, r - 1, -1);
+            if (j + 1 < grid) coo.add(r, r + 1, -1);
+        }
+    }
+    MyCsrMat<T> a(coo);
+    MyDynVec<T> x(size), y(size);
+    fillRandom(x.begin(), x.end(), 5);
+    doNotOptimize(a);
+    doNotOptimize(x);
+
+    double nnz = static_cast<double>(a.nonZeros());
+    double n = static_cast<double>(size);
+    double bytes = nnz * (sizeof(T) + sizeof(typename MyCsrMat<T>::index_type)) + n * (sizeof(size_t) + 2 * sizeof(T));
+    bench.run("sparse_spmv", "mycsrmat", typeName<T>(), size, size, bytes, 2 * nnz, [&] { multiply(a, x, y); doNotOptimize(y); });
+
+    MyDynMat<T> b(size, 8), c(size, 8);
+    fillRandom(b.begin(), b.end(), 6);
+    doNotOptimize(b);
+    bytes = nnz * (sizeof(T) + sizeof(typename MyCsrMat<T>::index_type)) + n * (sizeof(size_t) + 16 * sizeof(T));
+    bench.run("sparse_spmm", "mycsrmat", typeName<T>(), size, 8, bytes, 16 * nnz, [&] { multiply(a, b.view(), c.view()); doNotOptimize(c); });
+}
+
+template <typename T>
+void benchType(Bench &bench)
+{
+    benchFixedMatrix<T,2>(bench);
+    benchFixedMatrix<T,3>(bench);
+    benchFixedMatrix<T,4>(bench);
+    benchFixedMatrix<T,8>(bench);
+    benchFixedMatrix<T,16>(bench);
+    benchFixedMatrix<T,32>(bench);
+    for (size_t size : {64, 256, 1024}) {
+        benchDynamicMatrix<T>(bench, size);
+    }
+
+    benchFixedVector<T,2>(bench);
+    benchFixedVector<T,3>(bench);
+    benchFixedVector<T,4>(bench);
+    benchFixedVector<T,16>(bench);
+    for (size_t size : {1024, 65536, 1 << 20}) {
+        benchDynamicVector<T>(bench, size);
+    }
+
+    if constexpr (std::is_floating_point_v<T>) {
+        for (size_t count : {1024, 65536}) {
+            benchBatch<T>(bench, count);
+        }
+        for (size_t grid : {64, 512}) {
+            benchSparse<T>(bench, grid);
+        }
+    }
+}
+
+void usage(const char *program)
+{
+    std::cerr << "usage: " << program << " [--format csv|json] [--filter text] [--min-time seconds] [--repetitions n] [--serial]\n";
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (!std::strcmp(arg, "--format") && hasValue) {
+            options.format = argv[++i];
+        }
+        else if (!std::strcmp(arg, "--filter") && hasValue) {
+            options.filter = argv[++i];
+        }
+        else if (!std::strcmp(arg, "--min-time") && hasValue) {
+            options.minTime = std::atof(argv[++i]);
+        }
+        else if (!std::strcmp(arg, "--repetitions") && hasValue) {
+            options.repetitions = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (!std::strcmp(arg, "--serial")) {
+            options.serial = true;
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+    if (options.format != "csv" && options.format != "json") {
+        usage(argv[0]);
+        return 1;
+    }
+
+    MyExec::ScopedContext context(options.serial ? MyExec::seq : MyExec::par);
+    Bench bench(options);
+    bench.begin();
+    benchType<float>(bench);
+    benchType<double>(bench);
+    benchType<int>(bench);
+    bench.end();
+    return 0;
+}
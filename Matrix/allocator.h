@@ -0,0 +1,186 @@
+//
+//  allocator.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef ALLOCATOR_H
+#define ALLOCATOR_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <memory>
+#include <vector>
+#include <algorithm>
+#include "mystats.h"
+
+/*!
+ * \brief Allocators for the heap-backed (dynamic) containers
+ * \details The dynamic containers (MyDynMat, MyDynVec) take a standard allocator
+ * as a template parameter. Two are provided here:
+ *
+ * AlignedAllocator hands out storage aligned to a cache line (64 bytes by default),
+ * which is what the SIMD kernels prefer.
+ *
+ * ArenaAllocator draws from an Arena: a monotonic buffer that carves allocations out of
+ * large aligned blocks and releases everything at once in reset() or its destructor.
+ * That is useful for scratch matrices in a loop, which would otherwise pay for a
+ * malloc/free pair on every iteration. The Arena must outlive every container using it.
+ *
+ * \verbatim
+ * MyMemory::Arena arena;
+ * MyDynMat<double, MyMemory::ArenaAllocator<double>> tmp(512, 512, MyMemory::ArenaAllocator<double>(arena));
+ * \endverbatim
+ */
+namespace MyMemory {
+
+constexpr size_t cacheLine = 64;
+
+template <typename T, size_t Align = cacheLine>
+class AlignedAllocator {
+public:
+    static_assert (Align >= alignof(T) && (Align & (Align - 1)) == 0, "Alignment must be a power of two");
+
+    using value_type = T;
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) noexcept {}
+
+    T* allocate(size_t n)
+    {
+        MYSTATS_COUNT("allocate", n, 0, n * sizeof(T));
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T *p, size_t) noexcept
+    {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align> &) const noexcept { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align> &) const noexcept { return false; }
+};
+
+class Arena {
+public:
+    explicit Arena(size_t blockSize = size_t(1) << 20) :
+        blockSize_(blockSize)
+    {
+    }
+
+    ~Arena() { release(); }
+
+    Arena(const Arena &) = delete;
+    Arena& operator=(const Arena &) = delete;
+
+    // Storage for bytes at an address aligned to align, a power of two, and at least to
+    // a cache line
+    void* allocate(size_t bytes, size_t align = cacheLine)
+    {
+        assert((align & (align - 1)) == 0 && "Alignment must be a power of two");
+        align = std::max(align, cacheLine);
+        if (!blocks_.empty()) {
+            const Block &block = blocks_.back();
+            auto base = reinterpret_cast<uintptr_t>(block.ptr);
+            // Align the address itself, the block may be aligned to less than align
+            size_t offset = ((base + used_ + align - 1) & ~uintptr_t(align - 1)) - base;
+            if (offset <= block.size && bytes <= block.size - offset) {
+                used_ = offset + bytes;
+                return reinterpret_cast<void*>(base + offset);
+            }
+        }
+        // Oversized requests get a block of their own
+        size_t size = std::max(blockSize_, bytes);
+        blocks_.push_back({::operator new(size, std::align_val_t(align)), size, align});
+        used_ = bytes;
+        return blocks_.back().ptr;
+    }
+
+    // Monotonic: memory is only given back by reset() or destruction
+    void deallocate(void *, size_t) noexcept {}
+
+    // Free all blocks. Anything allocated from the arena is invalidated.
+    void reset() noexcept
+    {
+        release();
+        blocks_.clear();
+        used_ = 0;
+    }
+
+    size_t capacity() const noexcept
+    {
+        size_t total = 0;
+        for (const auto &b : blocks_) {
+            total += b.size;
+        }
+        return total;
+    }
+
+private:
+    struct Block {
+        void *ptr;
+        size_t size;
+        size_t align;
+    };
+
+    void release() noexcept
+    {
+        for (auto &b : blocks_) {
+            ::operator delete(b.ptr, std::align_val_t(b.align));
+        }
+    }
+
+    size_t blockSize_;
+    size_t used_ = 0;
+    std::vector<Block> blocks_;
+};
+
+template <typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+    // Containers sharing an arena keep sharing it when copied, moved or swapped
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    explicit ArenaAllocator(Arena &arena) noexcept :
+        arena_(&arena)
+    {
+    }
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U> &other) noexcept :
+        arena_(other.arena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T *p, size_t n) noexcept
+    {
+        arena_->deallocate(p, n * sizeof(T));
+    }
+
+    Arena* arena() const noexcept { return arena_; }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U> &rhs) const noexcept { return arena_ == rhs.arena(); }
+    template <typename U>
+    bool operator!=(const ArenaAllocator<U> &rhs) const noexcept { return arena_ != rhs.arena(); }
+
+private:
+    Arena *arena_;
+};
+
+} // namespace MyMemory
+
+#endif // ALLOCATOR_H
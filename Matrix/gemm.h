@@ -0,0 +1,301 @@
+//
+//  gemm.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef GEMM_H
+#define GEMM_H
+
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include "simd.h"
+#include "myexec.h"
+#include "mystats.h"
+
+/*!
+ * \brief Cache-blocked general matrix-matrix multiply kernel
+ * \details Computes C = alpha * A * B + beta * C on strided storage, so the same kernel
+ * serves row-major, column-major and transposed operands. Every matrix is described by
+ * a base pointer plus a row stride and a column stride (in elements).
+ *
+ * The kernel follows the usual three-level blocking scheme: B is packed into kc x nc
+ * panels that stay in L3, A into mc x kc panels that stay in L2, and a register-tiled
+ * micro-kernel computes an MR x NR block of C from one sliver of each panel. The
+ * micro-kernel is written against MySimd::Pack, so it is vectorized for float and double
+ * and falls back to scalar code for any other arithmetic type.
+ *
+ * Small products skip the packing entirely, the overhead is not worth it below a few
+ * thousand multiply-adds.
+ *
+ * Products of at least serialMultiplyAdds (see MyExec::Context) run on the thread pool:
+ * B panels are packed by all threads, then the macro-kernel is split into tiles of one
+ * A panel by a range of B slivers, with enough tiles to keep every thread busy. Each
+ * thread packs the A panels of its tiles into a buffer of its own.
+ */
+namespace MyMatrix {
+namespace detail {
+
+#if defined(__AVX512F__)
+constexpr size_t gemmSimdRows = 8;
+#elif defined(__AVX2__) && defined(__FMA__)
+constexpr size_t gemmSimdRows = 6;
+#else
+constexpr size_t gemmSimdRows = 4;
+#endif
+
+template <typename T>
+struct GemmBlocking {
+    static constexpr size_t W = MySimd::Pack<T>::width;
+    static constexpr size_t NV = W > 1 ? 2 : 4;            // vectors per micro-tile row
+    static constexpr size_t MR = W > 1 ? gemmSimdRows : 4; // micro-tile rows
+    static constexpr size_t NR = NV * W;                   // micro-tile columns
+    static constexpr size_t KC = 256;
+    static constexpr size_t MC = MR * 24;
+    static constexpr size_t NC = NR * 256;
+    static constexpr size_t smallProduct = 32 * 32 * 32;
+};
+
+// Copy an mc x kc block of A into MR-row slivers, k-major within each sliver.
+// The last sliver is zero padded.
+template <typename T>
+void packA(size_t mc, size_t kc, const T *a, ptrdiff_t rsa, ptrdiff_t csa, T *buf)
+{
+    constexpr size_t MR = GemmBlocking<T>::MR;
+    for (size_t i0 = 0; i0 < mc; i0 += MR) {
+        size_t mr = std::min(MR, mc - i0);
+        const T *src = a + static_cast<ptrdiff_t>(i0) * rsa;
+        for (size_t p = 0; p < kc; ++p) {
+            const T *col = src + static_cast<ptrdiff_t>(p) * csa;
+            for (size_t i = 0; i < mr; ++i) {
+                buf[i] = col[static_cast<ptrdiff_t>(i) * rsa];
+            }
+            for (size_t i = mr; i < MR; ++i) {
+                buf[i] = T(0);
+            }
+            buf += MR;
+        }
+    }
+}
+
+// Copy a kc x nc block of B into NR-column slivers, k-major within each sliver.
+// The last sliver is zero padded.
+template <typename T>
+void packB(size_t kc, size_t nc, const T *b, ptrdiff_t rsb, ptrdiff_t csb, T *buf)
+{
+    constexpr size_t NR = GemmBlocking<T>::NR;
+    for (size_t j0 = 0; j0 < nc; j0 += NR) {
+        size_t nr = std::min(NR, nc - j0);
+        const T *src = b + static_cast<ptrdiff_t>(j0) * csb;
+        for (size_t p = 0; p < kc; ++p) {
+            const T *row = src + static_cast<ptrdiff_t>(p) * rsb;
+            if (csb == 1) {
+                std::copy_n(row, nr, buf);
+            }
+            else {
+                for (size_t j = 0; j < nr; ++j) {
+                    buf[j] = row[static_cast<ptrdiff_t>(j) * csb];
+                }
+            }
+            std::fill(buf + nr, buf + NR, T(0));
+            buf += NR;
+        }
+    }
+}
+
+// C[mr x nr] += alpha * A_sliver * B_sliver
+template <typename T>
+void microKernel(size_t kc, T alpha, const T *pa, const T *pb,
+                 T *c, ptrdiff_t rsc, ptrdiff_t csc, size_t mr, size_t nr)
+{
+    using P = MySimd::Pack<T>;
+    using V = typename P::type;
+    constexpr size_t MR = GemmBlocking<T>::MR;
+    constexpr size_t NR = GemmBlocking<T>::NR;
+    constexpr size_t NV = GemmBlocking<T>::NV;
+    constexpr size_t W = GemmBlocking<T>::W;
+
+    V acc[MR][NV];
+    MYSIMD_UNROLL
+    for (size_t i = 0; i < MR; ++i) {
+        MYSIMD_UNROLL
+        for (size_t v = 0; v < NV; ++v) {
+            acc[i][v] = P::zero();
+        }
+    }
+
+    for (size_t p = 0; p < kc; ++p) {
+        V b[NV];
+        MYSIMD_UNROLL
+        for (size_t v = 0; v < NV; ++v) {
+            b[v] = P::load(pb + v * W);
+        }
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            V a = P::set1(pa[i]);
+            MYSIMD_UNROLL
+            for (size_t v = 0; v < NV; ++v) {
+                acc[i][v] = P::fmadd(a, b[v], acc[i][v]);
+            }
+        }
+        pa += MR;
+        pb += NR;
+    }
+
+    if (mr == MR && nr == NR && csc == 1) {
+        V va = P::set1(alpha);
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < MR; ++i) {
+            T *row = c + static_cast<ptrdiff_t>(i) * rsc;
+            MYSIMD_UNROLL
+            for (size_t v = 0; v < NV; ++v) {
+                P::store(row + v * W, P::fmadd(va, acc[i][v], P::load(row + v * W)));
+            }
+        }
+        return;
+    }
+
+    // Edge tile or strided destination: spill the accumulators and update element-wise
+    alignas(64) T tile[MR * NR];
+    for (size_t i = 0; i < MR; ++i) {
+        for (size_t v = 0; v < NV; ++v) {
+            P::store(tile + i * NR + v * W, acc[i][v]);
+        }
+    }
+    for (size_t i = 0; i < mr; ++i) {
+        for (size_t j = 0; j < nr; ++j) {
+            c[static_cast<ptrdiff_t>(i) * rsc + static_cast<ptrdiff_t>(j) * csc] += alpha * tile[i * NR + j];
+        }
+    }
+}
+
+// C *= beta, with beta == 0 clearing C so that NaNs in the destination don't propagate
+template <typename T>
+void scaleMatrix(size_t m, size_t n, T beta, T *c, ptrdiff_t rsc, ptrdiff_t csc)
+{
+    if (beta == T(1)) {
+        return;
+    }
+    MyExec::parallelFor<T>(m, n, [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            T *row = c + static_cast<ptrdiff_t>(i) * rsc;
+            for (size_t j = 0; j < n; ++j) {
+                T &v = row[static_cast<ptrdiff_t>(j) * csc];
+                v = beta == T(0) ? T(0) : beta * v;
+            }
+        }
+    });
+}
+
+// Unblocked i-p-j loop for small products. The inner loop runs along a row of B and C.
+template <typename T>
+void gemmSmall(size_t m, size_t n, size_t k, T alpha,
+               const T *a, ptrdiff_t rsa, ptrdiff_t csa,
+               const T *b, ptrdiff_t rsb, ptrdiff_t csb,
+               T *c, ptrdiff_t rsc, ptrdiff_t csc)
+{
+    for (size_t i = 0; i < m; ++i) {
+        T *crow = c + static_cast<ptrdiff_t>(i) * rsc;
+        for (size_t p = 0; p < k; ++p) {
+            T aip = alpha * a[static_cast<ptrdiff_t>(i) * rsa + static_cast<ptrdiff_t>(p) * csa];
+            const T *brow = b + static_cast<ptrdiff_t>(p) * rsb;
+            if (csb == 1 && csc == 1) {
+                for (size_t j = 0; j < n; ++j) {
+                    crow[j] += aip * brow[j];
+                }
+            }
+            else {
+                for (size_t j = 0; j < n; ++j) {
+                    crow[static_cast<ptrdiff_t>(j) * csc] += aip * brow[static_cast<ptrdiff_t>(j) * csb];
+                }
+            }
+        }
+    }
+}
+
+// C(m x n) = alpha * A(m x k) * B(k x n) + beta * C
+template <typename T>
+void gemm(size_t m, size_t n, size_t k, T alpha,
+          const T *a, ptrdiff_t rsa, ptrdiff_t csa,
+          const T *b, ptrdiff_t rsb, ptrdiff_t csb,
+          T beta, T *c, ptrdiff_t rsc, ptrdiff_t csc)
+{
+    using B = GemmBlocking<T>;
+    if (m == 0 || n == 0) {
+        return;
+    }
+    MYSTATS_SCOPE("gemm", m * n, 2 * m * n * k, (m * k + k * n + 2 * m * n) * sizeof(T));
+    scaleMatrix(m, n, beta, c, rsc, csc);
+    if (k == 0 || alpha == T(0)) {
+        return;
+    }
+    if (m * n * k <= B::smallProduct) {
+        gemmSmall(m, n, k, alpha, a, rsa, csa, b, rsb, csb, c, rsc, csc);
+        return;
+    }
+
+    MyExec::ThreadPool *pool = MyExec::current().poolFor(m * n * k, MyExec::current().serialMultiplyAdds);
+    size_t threads = pool ? pool->size() + 1 : 1;
+
+    // A thread waiting for its helpers may run another product, which then packs B on its own
+    thread_local std::vector<T> sharedB;
+    thread_local bool sharedBusy = false;
+    std::vector<T> ownB;
+    bool useShared = !sharedBusy;
+    std::vector<T> &bufB = useShared ? sharedB : ownB;
+    bufB.resize(B::KC * B::NC);
+    // Release the shared buffer on return, or when a tile throws
+    struct Release {
+        bool *busy;
+        ~Release() {
+            if (busy) {
+                *busy = false;
+            }
+        }
+    } release{useShared ? &sharedBusy : nullptr};
+    sharedBusy = true;
+
+    size_t mBlocks = (m + B::MC - 1) / B::MC;
+    for (size_t jc = 0; jc < n; jc += B::NC) {
+        size_t nc = std::min(B::NC, n - jc);
+        size_t slivers = (nc + B::NR - 1) / B::NR;
+        // Split the columns when there are too few row panels to go around
+        size_t nParts = threads > 1 ? std::min(slivers, (2 * threads + mBlocks - 1) / mBlocks) : 1;
+        size_t partSlivers = (slivers + nParts - 1) / nParts;
+        nParts = (slivers + partSlivers - 1) / partSlivers;
+
+        for (size_t pc = 0; pc < k; pc += B::KC) {
+            size_t kc = std::min(B::KC, k - pc);
+            const T *bp = b + static_cast<ptrdiff_t>(pc) * rsb + static_cast<ptrdiff_t>(jc) * csb;
+            MyExec::forEachTile(pool, nParts, [&](size_t t) {
+                size_t j0 = t * partSlivers * B::NR;
+                size_t j1 = std::min(nc, j0 + partSlivers * B::NR);
+                packB(kc, j1 - j0, bp + static_cast<ptrdiff_t>(j0) * csb, rsb, csb, bufB.data() + j0 * kc);
+            });
+
+            MyExec::forEachTile(pool, mBlocks * nParts, [&](size_t t) {
+                thread_local std::vector<T> bufA;
+                bufA.resize(B::MC * B::KC);
+                size_t ic = (t / nParts) * B::MC;
+                size_t mc = std::min(B::MC, m - ic);
+                size_t j0 = (t % nParts) * partSlivers * B::NR;
+                size_t j1 = std::min(nc, j0 + partSlivers * B::NR);
+                packA(mc, kc, a + static_cast<ptrdiff_t>(ic) * rsa + static_cast<ptrdiff_t>(pc) * csa, rsa, csa, bufA.data());
+                for (size_t jr = j0; jr < j1; jr += B::NR) {
+                    for (size_t ir = 0; ir < mc; ir += B::MR) {
+                        T *ct = c + static_cast<ptrdiff_t>(ic + ir) * rsc + static_cast<ptrdiff_t>(jc + jr) * csc;
+                        microKernel(kc, alpha, bufA.data() + ir * kc, bufB.data() + jr * kc,
+                                    ct, rsc, csc, std::min(B::MR, mc - ir), std::min(B::NR, nc - jr));
+                    }
+                }
+            });
+        }
+    }
+}
+
+} // namespace detail
+} // namespace MyMatrix
+
+#endif // GEMM_H
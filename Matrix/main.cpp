@@ -6,9 +6,21 @@
 //
 
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include "myvec.h"
 #include "mymat.h"
+#include "mydynmat.h"
+#include "mydynvec.h"
+#include "myvecbatch.h"
+#include "mydecomp.h"
+#include "mysparse.h"
+#include "myio.h"
+#include "mytext.h"
+#include "myquant.h"
+#include "myblas.h"
+#include "mystats.h"
+#include "mypipeline.h"
 
 using namespace std;
 using namespace MyVector;
@@ -78,6 +90,7 @@ int main()
     cout << "2 * vec: " << 2 * vecDouble2 << endl;
     cout << "vec * 2: " << vecDouble2 * 2 << endl;
     cout << "vec / 2: " << vecDouble2 / 2 << endl;
+    cout << "vec + vec - 2 * vec: " << vecDouble2 + vecDouble2 - 2 * vecDouble2 << endl;
 
 //    vec2 = vec3;  // different length, shouldn't compile.
     MyVec<int, 3> crossA{1, 2};
@@ -90,11 +103,10 @@ int main()
                           2, 4, 6};
 
     cout << matOrig << endl;
-    MyMat<double,2,3> matT = matOrig.transpose();
+    auto matT = matOrig.transposed();
     cout << matT << endl;
-    cout << matT.transpose() << endl;
-    cout << matT.transpose() << endl;
-//    cout << std::boolalpha << (matT == matT.transpose()) << endl;
+    cout << matT.transposed() << endl;
+//    cout << std::boolalpha << (matT == matT.transposed()) << endl;
 
     MyMat<double,1,3> exp = {1, 2, 3};
     MyMat<double,3,1> exp2 = {1,2,3};
@@ -102,7 +114,7 @@ int main()
     cout << exp << endl << exp2 << endl;
     cout << std::boolalpha << (exp == exp) << endl;
     cout << (exp == exp2) << endl;
-    cout << (exp == exp2.transpose()) << endl;
+    cout << (exp == exp2.transposed()) << endl;
     
     auto expT = exp.copyTransposed();
     cout << "exp" << endl;
@@ -127,6 +139,27 @@ int main()
     auto tc = matA.copyTransposed();
     cout << tc << endl;
     
+    cout << "MatA * MatB" << endl;
+    cout << matA * matB << endl;
+
+    MyMat<double, 2, 3> matL = {1, 2, 3,
+                                4, 5, 6};
+    MyMat<double, 3, 2> matR = {7, 8,
+                                9, 10,
+                                11, 12};
+    cout << "2x3 * 3x2" << endl;
+    cout << multiply(matL, matR) << endl;
+
+    MyMat<double, 3, 2, Layout::ColMajor> matRc = matR.view();
+    cout << (matRc == matR) << endl;
+    cout << "2x3 * its transpose" << endl;
+    cout << matL * matL.transposed() << endl;
+    cout << "Top left 2x2 of 3x2" << endl;
+    cout << matR.block(0, 0, 2, 2) << endl;
+    matA.row(0) = matA.row(1) + matA.col(2).transposed();
+    cout << "MatA row 0 = row 1 + column 2" << endl;
+    cout << matA << endl;
+
     MyVec<double> normVec { 1, 1, 1};
     cout << normVec << ",  " << normVec.normalize() << endl;
     cout << (normVec == normVec) << endl;
@@ -135,5 +168,95 @@ int main()
     MyVec<double, 2> vec11 {0,1};
 //    cout << rad2deg(vec10.angleTo(vec11)) << endl;
     cout << rad2deg(angle(vec10, vec11)) << endl;
+
+    MyDynMat<double> dynMat(2, 3, {1, 2, 3,
+                                   4, 5, 6});
+    cout << "Dynamic matrix" << endl;
+    cout << dynMat << endl;
+    cout << "Dynamic matrix * transpose" << endl;
+    cout << dynMat * dynMat.copyTransposed() << endl;
+    cout << (dynMat.toFixed<2,3>() == matL) << endl;
+
+    MyMat<double, 3, 3> sys = {2, 1, 1,
+                               1, 3, 2,
+                               1, 0, 0};
+    MyVec<double> rhs{4, 5, 6}, sol;
+    if (solve(sys, rhs, sol)) {
+        cout << "Solution: " << sol << ", determinant " << determinant(sys) << endl;
+    }
+    MyMat<double, 3, 3> sysInv;
+    inverse(sys, sysInv);
+    cout << "Inverse" << endl << sysInv << endl;
+
+    constexpr MyMat<double, 4, 4> translate = {1, 0, 0, 1,
+                                               0, 1, 0, 2,
+                                               0, 0, 1, 3,
+                                               0, 0, 0, 1};
+    constexpr MyMat<double, 4, 4> scale = {2, 0, 0, 0,
+                                           0, 2, 0, 0,
+                                           0, 0, 2, 0,
+                                           0, 0, 0, 1};
+    constexpr auto transform = translate * scale;
+    static_assert (transform(0,3) == 1 && determinant(transform) == 8, "Folded at compile time");
+    cout << "Transformed point: " << transformPoint(transform, MyVec<double>{1, 1, 1}) << endl;
+
+    MyDynVec<double> dynVec(vec3);
+    cout << "Dynamic vector: " << dynVec << ", magnitude " << magnitude(dynVec) << endl;
+
+    vector<MyVec<double>> points {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {0, 0, 0}};
+    MyVecBatch<double> batch(points.begin(), points.end());
+    batch.normalize();
+    cout << "Batch normalized magnitudes: " << magnitude(batch) << endl;
+    cout << "Batch dot with x axis: " << dotProduct(batch, MyVec<double>{1, 0, 0}) << endl;
+
+    MyCooMat<double> coo(4, 4);
+    for (size_t i = 0; i < 4; ++i) {
+        coo.add(i, i, 2);
+        if (i > 0) {
+            coo.add(i, i - 1, -1);
+        }
+    }
+    MyCsrMat<double> sparse(coo);
+    MyDynVec<double> ones{1, 1, 1, 1};
+    cout << "Sparse matrix" << endl << sparse.toDense();
+    cout << "Sparse * ones: " << sparse * ones << endl;
+
+    stringstream binary;
+    writeBinary(binary, dynMat.transposed());
+    MyDynMat<double> reloaded;
+    if (readBinary(binary, reloaded)) {
+        cout << "Reloaded transpose" << endl << reloaded;
+    }
+
+    MyDynMat<double> parsed;
+    if (parseText("0.1, 0.2\n0.3, 0.4\n", parsed)) {
+        cout << "Parsed CSV" << endl;
+        writeText(cout, parsed, ',');
+    }
+
+    MyQuantMat<int8_t> weights = quantize<int8_t>(dynMat, QuantScheme::PerRow);
+    MyQuantVec<int8_t> features = quantize<int8_t>(MyDynVec<double>{1, -1, 0.5});
+    cout << "Quantized weights" << endl << weights;
+    cout << "Quantized product: " << weights * features << endl;
+
+    MyDynVec<double> state{1, 1, 1};
+    MyDynVec<double> response{1, 1};
+    gemv(2.0, dynMat, state, 0.5, response);
+    axpy(-1.0, dynMat.row(0).block(0, 0, 1, 2), response);
+    cout << "2 * A * x + 0.5 * y - A(0, 0:1): " << response << endl;
+
+    vector<MyVec<double,3>> cloud{{1, 0, 0}, {0, 1, 0}, {0, 0, 1}, {-1, 0, 0}};
+    MyMat<double,4,4> rotateZ{0, -1, 0, 0,  1, 0, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1};
+    MyPointPipeline<double> pipeline;
+    pipeline.transform(rotateZ).transform(rotateZ).normalize().keepDot(MyVec<double,3>{1, 0, 0}, 0.5);
+    pipeline.run(rangeReader(cloud.begin(), cloud.end()), [](const MyVec<double,3> *points, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            cout << "Kept point: " << points[i] << endl;
+        }
+    });
+
+    if (MyStats::enabled()) {
+        MyStats::dump(cout);
+    }
     return 0;
 }
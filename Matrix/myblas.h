@@ -0,0 +1,100 @@
+//
+//  myblas.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYBLAS_H
+#define MYBLAS_H
+
+#include <cstddef>
+#include <type_traits>
+#include "myexec.h"
+#include "myview.h"
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "gemm.h"
+#include "mystats.h"
+
+/*!
+ * \brief BLAS style operations that write into existing matrices and vectors
+ * \details The operators of MyMat, MyDynMat and the vectors return new objects. These
+ * functions instead update an output the caller provides, with the usual alpha and beta
+ * scaling, and allocate nothing:
+ *
+ * \verbatim
+ * gemv(alpha, a, x, beta, y);        // y = alpha * a * x + beta * y
+ * axpy(alpha, x, y);                 // y = alpha * x + y
+ * scal(alpha, x);                    // x = alpha * x
+ * dot(x, y);                         // sum of x(i) * y(i)
+ * ger(alpha, x, y, a);               // a = alpha * x * y^T + a
+ * gemm(alpha, a, b, beta, c);        // c = alpha * a * b + beta * c
+ * \endverbatim
+ *
+ * Matrices are a MyMat, a MyDynMat or a MyMatView, so a transposed operand or a block is
+ * passed as a view: gemv(1, a.transposed(), x, 0, y). Vectors are a MyVec, a MyDynVec, or
+ * a view of one row or column of a matrix. The outputs are updated in place, and must
+ * not overlap the inputs. A beta of 0 overwrites the output, even when it holds NaNs.
+ *
+ * When every operand is a MyMat or a MyVec of at most 4 x 4, the loops run over the
+ * compile-time dimensions, which the compiler unrolls. Otherwise, fixed size operands
+ * included, gemv and gemm use the SIMD kernels and run on the MyExec thread pool when
+ * they are large enough (see myexec.h), gemm with the blocked kernel of gemm.h, which
+ * keeps its packing buffers from one call to the next.
+ */
+namespace MyMatrix {
+
+namespace detail {
+
+template <typename X>
+using BlasValue = typename std::decay_t<X>::value_type;
+
+template <typename X>
+struct IsBlasVector : std::false_type {};
+template <typename T, size_t N>
+struct IsBlasVector<MyVector::MyVec<T,N>> : std::true_type {};
+template <typename T, typename A>
+struct IsBlasVector<MyVector::MyDynVec<T,A>> : std::true_type {};
+template <typename T>
+struct IsBlasVector<MyMatView<T>> : std::true_type {};
+template <typename X>
+constexpr bool isBlasVector = IsBlasVector<std::decay_t<X>>::value;
+
+} // namespace detail
+
+// x = alpha * x
+template <typename X, typename = std::enable_if_t<detail::isBlasVector<X>>>
+void scal(detail::BlasValue<X> alpha, X &&x);
+
+// y = alpha * x + y
+template <typename X, typename Y, typename = std::enable_if_t<detail::isBlasVector<X> && detail::isBlasVector<Y>>>
+void axpy(detail::BlasValue<X> alpha, const X &x, Y &&y);
+
+// Sum of x(i) * y(i)
+template <typename X, typename Y, typename = std::enable_if_t<detail::isBlasVector<X> && detail::isBlasVector<Y>>>
+detail::BlasValue<X> dot(const X &x, const Y &y);
+
+// y = alpha * a * x + beta * y, y must have a.rows() elements and x a.cols()
+template <typename M, typename X, typename Y, typename = std::enable_if_t<isMatrix<M>>>
+void gemv(detail::BlasValue<M> alpha, const M &a, const X &x, detail::BlasValue<M> beta, Y &&y);
+template <typename M, typename X, typename Y, typename = std::enable_if_t<isMatrix<M>>>
+void gemv(detail::BlasValue<M> alpha, const M &a, const X &x, detail::BlasValue<M> beta, Y &&y, const MyExec::Context &);
+
+// a = alpha * x * y^T + a, a must be x.size() x y.size()
+template <typename X, typename Y, typename M, typename = std::enable_if_t<isMatrix<M>>>
+void ger(detail::BlasValue<M> alpha, const X &x, const Y &y, M &&a);
+
+// c = alpha * a * b + beta * c, c must be a.rows() x b.cols()
+template <typename MA, typename MB, typename MC, typename = std::enable_if_t<isMatrix<MA> && isMatrix<MB> && isMatrix<MC>>>
+void gemm(detail::BlasValue<MA> alpha, const MA &a, const MB &b, detail::BlasValue<MA> beta, MC &&c);
+template <typename MA, typename MB, typename MC, typename = std::enable_if_t<isMatrix<MA> && isMatrix<MB> && isMatrix<MC>>>
+void gemm(detail::BlasValue<MA> alpha, const MA &a, const MB &b, detail::BlasValue<MA> beta, MC &&c, const MyExec::Context &);
+
+} // namespace MyMatrix
+
+#include "myblas.tpp"
+
+#endif // MYBLAS_H
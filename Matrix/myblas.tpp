@@ -0,0 +1,402 @@
+//
+//  myblas.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <cassert>
+#include <numeric>
+#include <utility>
+#include "simd.h"
+
+namespace MyMatrix {
+
+namespace detail {
+
+// Dimensions of the operands known at compile time, vectors as a column
+template <typename M>
+struct FixedShape : std::false_type {};
+template <typename T, size_t R, size_t C, Layout L>
+struct FixedShape<MyMat<T,R,C,L>> : std::true_type {
+    static constexpr size_t rows = R;
+    static constexpr size_t cols = C;
+};
+template <typename T, size_t N>
+struct FixedShape<MyVector::MyVec<T,N>> : std::true_type {
+    static constexpr size_t rows = N;
+    static constexpr size_t cols = 1;
+};
+// Operands of fixed size up to 4 x 4, for which the loops over the compile-time dimensions
+// are fully unrolled. Larger ones are faster with the SIMD kernels.
+constexpr size_t smallFixedOrder = 4;
+template <typename M, bool = FixedShape<M>::value>
+struct IsSmallFixed : std::false_type {};
+template <typename M>
+struct IsSmallFixed<M, true> :
+    std::bool_constant<FixedShape<M>::rows <= smallFixedOrder && FixedShape<M>::cols <= smallFixedOrder> {};
+template <typename... M>
+constexpr bool allSmallFixed = (IsSmallFixed<std::decay_t<M>>::value && ...);
+
+// n elements, element i at data[i * stride]
+template <typename T>
+struct VecRef {
+    T *data;
+    size_t size;
+    ptrdiff_t stride;
+
+    T& operator[](size_t i) const { return data[static_cast<ptrdiff_t>(i) * stride]; }
+    operator VecRef<const T>() const { return {data, size, stride}; }
+};
+
+template <typename T, size_t N>
+VecRef<T> vecRef(MyVector::MyVec<T,N> &x) { return {x.data(), N, 1}; }
+template <typename T, size_t N>
+VecRef<const T> vecRef(const MyVector::MyVec<T,N> &x) { return {x.data(), N, 1}; }
+template <typename T, typename A>
+VecRef<T> vecRef(MyVector::MyDynVec<T,A> &x) { return {x.data(), x.size(), 1}; }
+template <typename T, typename A>
+VecRef<const T> vecRef(const MyVector::MyDynVec<T,A> &x) { return {x.data(), x.size(), 1}; }
+
+// A view of a single row or column
+template <typename T>
+VecRef<T> vecRef(const MyMatView<T> &v)
+{
+    assert(v.rows() == 1 || v.cols() == 1);
+    return {v.data(), v.size(), v.rows() == 1 ? v.colStride() : v.rowStride()};
+}
+
+template <typename X>
+constexpr bool isWritableVector = !std::is_const_v<std::remove_pointer_t<decltype(vecRef(std::declval<X&>()).data)>>;
+template <typename M>
+constexpr bool isWritableMatrix = !std::is_const_v<std::remove_pointer_t<decltype(std::declval<M&>().view().data())>>;
+
+// y = beta * y over [begin, end), with beta == 0 clearing y
+template <typename T>
+void scaleVector(size_t begin, size_t end, T beta, VecRef<T> y)
+{
+    if (beta == T(1)) {
+        return;
+    }
+    for (size_t i = begin; i < end; ++i) {
+        y[i] = beta == T(0) ? T(0) : beta * y[i];
+    }
+}
+
+template <typename T>
+T dotContiguous(size_t n, const T *x, const T *y)
+{
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    size_t i = 0;
+    T sum = T(0);
+    if constexpr (W > 1) {
+        typename P::type acc[4] = {P::zero(), P::zero(), P::zero(), P::zero()};
+        for (; i + 4 * W <= n; i += 4 * W) {
+            MYSIMD_UNROLL
+            for (size_t v = 0; v < 4; ++v) {
+                acc[v] = P::fmadd(P::load(x + i + v * W), P::load(y + i + v * W), acc[v]);
+            }
+        }
+        for (; i + W <= n; i += W) {
+            acc[0] = P::fmadd(P::load(x + i), P::load(y + i), acc[0]);
+        }
+        alignas(64) T lanes[W];
+        P::store(lanes, P::add(P::add(acc[0], acc[1]), P::add(acc[2], acc[3])));
+        sum = std::accumulate(lanes, lanes + W, T(0));
+    }
+    for (; i < n; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+template <typename T>
+T dotVectors(VecRef<const T> x, VecRef<const T> y)
+{
+    if (x.stride == 1 && y.stride == 1) {
+        return dotContiguous(x.size, x.data, y.data);
+    }
+    T sum = T(0);
+    for (size_t i = 0; i < x.size; ++i) {
+        sum += x[i] * y[i];
+    }
+    return sum;
+}
+
+// y[begin, end) += alpha * a x with the rows of a and x contiguous. Four rows at a time
+// share the loads of x.
+template <typename T>
+void gemvRows(size_t begin, size_t end, size_t n, T alpha, const T *a, ptrdiff_t rsa, const T *x, VecRef<T> y)
+{
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    size_t i = begin;
+    if constexpr (W > 1) {
+        for (; i + 4 <= end; i += 4) {
+            const T *rows[4];
+            typename P::type acc[4];
+            for (size_t r = 0; r < 4; ++r) {
+                rows[r] = a + static_cast<ptrdiff_t>(i + r) * rsa;
+                acc[r] = P::zero();
+            }
+            size_t k = 0;
+            for (; k + W <= n; k += W) {
+                auto xv = P::load(x + k);
+                MYSIMD_UNROLL
+                for (size_t r = 0; r < 4; ++r) {
+                    acc[r] = P::fmadd(P::load(rows[r] + k), xv, acc[r]);
+                }
+            }
+            for (size_t r = 0; r < 4; ++r) {
+                alignas(64) T lanes[W];
+                P::store(lanes, acc[r]);
+                T sum = std::accumulate(lanes, lanes + W, T(0));
+                for (size_t p = k; p < n; ++p) {
+                    sum += rows[r][p] * x[p];
+                }
+                y[i + r] += alpha * sum;
+            }
+        }
+    }
+    for (; i < end; ++i) {
+        y[i] += alpha * dotContiguous(n, a + static_cast<ptrdiff_t>(i) * rsa, x);
+    }
+}
+
+// y[begin, end) += alpha * a x with the columns of a contiguous, a column at a time
+template <typename T>
+void gemvCols(size_t begin, size_t end, size_t n, T alpha, const T *a, ptrdiff_t csa, VecRef<const T> x, VecRef<T> y)
+{
+    for (size_t j = 0; j < n; ++j) {
+        const T t = alpha * x[j];
+        const T *col = a + static_cast<ptrdiff_t>(j) * csa;
+        if (y.stride == 1) {
+            for (size_t i = begin; i < end; ++i) {
+                y.data[i] += t * col[i];
+            }
+        }
+        else {
+            for (size_t i = begin; i < end; ++i) {
+                y[i] += t * col[i];
+            }
+        }
+    }
+}
+
+template <typename T>
+void gemvStrided(size_t begin, size_t end, T alpha, MyMatView<const T> a, VecRef<const T> x, VecRef<T> y)
+{
+    for (size_t i = begin; i < end; ++i) {
+        T sum = T(0);
+        for (size_t j = 0; j < a.cols(); ++j) {
+            sum += a(i,j) * x[j];
+        }
+        y[i] += alpha * sum;
+    }
+}
+
+template <typename T>
+void gemvViews(T alpha, MyMatView<const T> a, VecRef<const T> x, T beta, VecRef<T> y)
+{
+    assert(x.size == a.cols() && y.size == a.rows());
+    const size_t n = a.cols();
+    MyExec::parallelFor<T>(a.rows(), n, [&](size_t begin, size_t end) {
+        scaleVector(begin, end, beta, y);
+        if (alpha == T(0) || n == 0) {
+            return;
+        }
+        if ((a.colStride() == 1 || n == 1) && x.stride == 1) {
+            gemvRows(begin, end, n, alpha, a.data(), a.rowStride(), x.data, y);
+        }
+        else if (a.rowStride() == 1) {
+            gemvCols(begin, end, n, alpha, a.data(), a.colStride(), x, y);
+        }
+        else {
+            gemvStrided(begin, end, alpha, a, x, y);
+        }
+    });
+}
+
+template <typename T>
+void gerViews(T alpha, VecRef<const T> x, VecRef<const T> y, MyMatView<T> a)
+{
+    assert(x.size == a.rows() && y.size == a.cols());
+    // Go along the contiguous dimension of a, a column-major a is the transpose of a row-major one
+    if (a.rowStride() == 1 && a.colStride() != 1) {
+        gerViews(alpha, y, x, a.transposed());
+        return;
+    }
+    const size_t n = a.cols();
+    MyExec::parallelFor<T>(a.rows(), n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const T t = alpha * x[i];
+            T *row = a.data() + static_cast<ptrdiff_t>(i) * a.rowStride();
+            if (a.colStride() == 1 && y.stride == 1) {
+                for (size_t j = 0; j < n; ++j) {
+                    row[j] += t * y.data[j];
+                }
+            }
+            else {
+                for (size_t j = 0; j < n; ++j) {
+                    row[static_cast<ptrdiff_t>(j) * a.colStride()] += t * y[j];
+                }
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+template <typename X, typename>
+void scal(detail::BlasValue<X> alpha, X &&x)
+{
+    using T = detail::BlasValue<X>;
+    static_assert (detail::isWritableVector<X>, "scal updates x");
+    auto xr = detail::vecRef(x);
+    MYSTATS_COUNT("scal", xr.size, xr.size, 2 * xr.size * sizeof(T));
+    MyExec::parallelFor<T>(xr.size, 1, [&](size_t begin, size_t end) {
+        detail::scaleVector(begin, end, alpha, xr);
+    });
+}
+
+template <typename X, typename Y, typename>
+void axpy(detail::BlasValue<X> alpha, const X &x, Y &&y)
+{
+    using T = detail::BlasValue<X>;
+    static_assert (std::is_same_v<T, detail::BlasValue<Y>>, "Vectors must have the same value type");
+    static_assert (detail::isWritableVector<Y>, "axpy updates y");
+    auto xr = detail::vecRef(x);
+    auto yr = detail::vecRef(y);
+    assert(xr.size == yr.size);
+    MYSTATS_COUNT("axpy", xr.size, 2 * xr.size, 3 * xr.size * sizeof(T));
+    if (alpha == T(0)) {
+        return;
+    }
+    MyExec::parallelFor<T>(xr.size, 1, [&](size_t begin, size_t end) {
+        if (xr.stride == 1 && yr.stride == 1) {
+            for (size_t i = begin; i < end; ++i) {
+                yr.data[i] += alpha * xr.data[i];
+            }
+        }
+        else {
+            for (size_t i = begin; i < end; ++i) {
+                yr[i] += alpha * xr[i];
+            }
+        }
+    });
+}
+
+template <typename X, typename Y, typename>
+detail::BlasValue<X> dot(const X &x, const Y &y)
+{
+    using T = detail::BlasValue<X>;
+    static_assert (std::is_same_v<T, detail::BlasValue<Y>>, "Vectors must have the same value type");
+    detail::VecRef<const T> xr = detail::vecRef(x);
+    detail::VecRef<const T> yr = detail::vecRef(y);
+    assert(xr.size == yr.size);
+    MYSTATS_COUNT("dot", xr.size, 2 * xr.size, 2 * xr.size * sizeof(T));
+    return detail::dotVectors(xr, yr);
+}
+
+template <typename M, typename X, typename Y, typename>
+void gemv(detail::BlasValue<M> alpha, const M &a, const X &x, detail::BlasValue<M> beta, Y &&y)
+{
+    using T = detail::BlasValue<M>;
+    static_assert (std::is_same_v<T, detail::BlasValue<X>> && std::is_same_v<T, detail::BlasValue<Y>>,
+                   "Operands must have the same value type");
+    static_assert (detail::isWritableVector<Y>, "gemv updates y");
+    MYSTATS_COUNT("gemv", a.rows(), 2 * a.rows() * a.cols(), (a.rows() * a.cols() + a.cols() + 2 * a.rows()) * sizeof(T));
+    if constexpr (detail::allSmallFixed<M, X, Y>) {
+        constexpr size_t R = detail::FixedShape<M>::rows;
+        constexpr size_t C = detail::FixedShape<M>::cols;
+        static_assert (detail::FixedShape<std::decay_t<X>>::rows == C && detail::FixedShape<std::decay_t<Y>>::rows == R,
+                       "gemv needs a.cols() elements in x and a.rows() in y");
+        for (size_t i = 0; i < R; ++i) {
+            T sum = T(0);
+            for (size_t j = 0; j < C; ++j) {
+                sum += a(i,j) * x[j];
+            }
+            y[i] = beta == T(0) ? alpha * sum : alpha * sum + beta * y[i];
+        }
+    }
+    else {
+        detail::gemvViews<T>(alpha, a.view(), detail::vecRef(x), beta, detail::vecRef(y));
+    }
+}
+
+template <typename M, typename X, typename Y, typename>
+void gemv(detail::BlasValue<M> alpha, const M &a, const X &x, detail::BlasValue<M> beta, Y &&y, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    gemv(alpha, a, x, beta, std::forward<Y>(y));
+}
+
+template <typename X, typename Y, typename M, typename>
+void ger(detail::BlasValue<M> alpha, const X &x, const Y &y, M &&a)
+{
+    using T = detail::BlasValue<M>;
+    static_assert (std::is_same_v<T, detail::BlasValue<X>> && std::is_same_v<T, detail::BlasValue<Y>>,
+                   "Operands must have the same value type");
+    static_assert (detail::isWritableMatrix<M>, "ger updates a");
+    MYSTATS_COUNT("ger", a.rows() * a.cols(), 2 * a.rows() * a.cols(), (2 * a.rows() * a.cols() + a.rows() + a.cols()) * sizeof(T));
+    if constexpr (detail::allSmallFixed<X, Y, M>) {
+        constexpr size_t R = detail::FixedShape<std::decay_t<M>>::rows;
+        constexpr size_t C = detail::FixedShape<std::decay_t<M>>::cols;
+        static_assert (detail::FixedShape<std::decay_t<X>>::rows == R && detail::FixedShape<std::decay_t<Y>>::rows == C,
+                       "ger needs a.rows() elements in x and a.cols() in y");
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                a(i,j) += alpha * x[i] * y[j];
+            }
+        }
+    }
+    else if (alpha != T(0)) {
+        detail::gerViews<T>(alpha, detail::vecRef(x), detail::vecRef(y), a.view());
+    }
+}
+
+template <typename MA, typename MB, typename MC, typename>
+void gemm(detail::BlasValue<MA> alpha, const MA &a, const MB &b, detail::BlasValue<MA> beta, MC &&c)
+{
+    using T = detail::BlasValue<MA>;
+    static_assert (std::is_same_v<T, detail::BlasValue<MB>> && std::is_same_v<T, detail::BlasValue<MC>>,
+                   "Matrices must have the same value type");
+    static_assert (detail::isWritableMatrix<MC>, "gemm updates c");
+    if constexpr (detail::allSmallFixed<MA, MB, MC>) {
+        constexpr size_t R = detail::FixedShape<MA>::rows;
+        constexpr size_t K = detail::FixedShape<MA>::cols;
+        constexpr size_t C = detail::FixedShape<MB>::cols;
+        static_assert (detail::FixedShape<MB>::rows == K && detail::FixedShape<std::decay_t<MC>>::rows == R &&
+                       detail::FixedShape<std::decay_t<MC>>::cols == C, "gemm needs a.cols() == b.rows() and c a.rows() x b.cols()");
+        MYSTATS_COUNT("gemm", R * C, 2 * R * C * K, (R * K + K * C + 2 * R * C) * sizeof(T));
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                T sum = T(0);
+                for (size_t p = 0; p < K; ++p) {
+                    sum += a(i,p) * b(p,j);
+                }
+                c(i,j) = beta == T(0) ? alpha * sum : alpha * sum + beta * c(i,j);
+            }
+        }
+    }
+    else {
+        auto av = a.view();
+        auto bv = b.view();
+        auto cv = c.view();
+        assert(av.cols() == bv.rows() && cv.rows() == av.rows() && cv.cols() == bv.cols());
+        detail::gemm<T>(av.rows(), bv.cols(), av.cols(), alpha,
+                        av.data(), av.rowStride(), av.colStride(),
+                        bv.data(), bv.rowStride(), bv.colStride(),
+                        beta, cv.data(), cv.rowStride(), cv.colStride());
+    }
+}
+
+template <typename MA, typename MB, typename MC, typename>
+void gemm(detail::BlasValue<MA> alpha, const MA &a, const MB &b, detail::BlasValue<MA> beta, MC &&c, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    gemm(alpha, a, b, beta, std::forward<MC>(c));
+}
+
+} // namespace MyMatrix
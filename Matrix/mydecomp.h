@@ -0,0 +1,112 @@
+//
+//  mydecomp.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYDECOMP_H
+#define MYDECOMP_H
+
+#include <array>
+#include <vector>
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "mystats.h"
+
+/*!
+ * \brief Matrix decompositions, and the linear solves built on them
+ * \details The decompositions work in place, on a matrix or a view of one:
+ *
+ * - luDecompose factors a square A as PA = LU with partial pivoting. L is unit lower
+ *   triangular and stored below the diagonal, U on and above it. pivots[k] is the row
+ *   that was swapped with row k at step k.
+ * - choleskyDecompose factors a symmetric positive definite A as A = LL^T, reading the
+ *   lower triangle only. A is replaced by L, with zeros above the diagonal.
+ * - qrDecompose factors an m x n A as A = QR with Householder reflections. R is stored on
+ *   and above the diagonal, and the reflectors below it, with their scale factors in tau.
+ *
+ * luSolve, choleskySolve and qrSolve take a factored matrix and overwrite the right hand
+ * sides B (one per column) with the solution, so a factorization can be reused for any
+ * number of solves. qrSolve gives the least squares solution when A has more rows than
+ * columns.
+ *
+ * solve, inverse and determinant are the one-call versions for square matrices, using LU.
+ * They return false, or a zero determinant, when the matrix is singular:
+ *
+ * \verbatim
+ * MyMat<double,3,3> a = ...;
+ * MyVec<double,3> b = ..., x;
+ * if (solve(a, b, x)) { ... }
+ * \endverbatim
+ *
+ * For MyMat of order up to 8, the algorithms are instantiated with compile-time
+ * extents and fully unrolled. Larger matrices use blocked right-looking algorithms, that
+ * do most of the work as matrix-matrix multiplies. The decompositions require a floating
+ * point type.
+ *
+ * inverse and determinant of a MyMat of order up to 4 use the closed forms of smallmat.h
+ * instead of LU, and are constexpr. The determinant then also works for integers.
+ */
+namespace MyMatrix {
+
+// In-place decompositions, false when the matrix is singular (LU) or not positive definite (Cholesky)
+template <typename T>
+bool luDecompose(MyMatView<T> a, size_t *pivots);
+template <typename T, size_t N, Layout L>
+bool luDecompose(MyMat<T,N,N,L> &a, std::array<size_t,N> &pivots);
+template <typename T, typename A>
+bool luDecompose(MyDynMat<T,A> &a, std::vector<size_t> &pivots);
+
+template <typename T>
+bool choleskyDecompose(MyMatView<T> a);
+template <typename T, size_t N, Layout L>
+bool choleskyDecompose(MyMat<T,N,N,L> &a);
+template <typename T, typename A>
+bool choleskyDecompose(MyDynMat<T,A> &a);
+
+// tau has min(rows, cols) elements
+template <typename T>
+void qrDecompose(MyMatView<T> a, T *tau);
+template <typename T, size_t R, size_t C, Layout L>
+void qrDecompose(MyMat<T,R,C,L> &a, std::array<T,(R < C ? R : C)> &tau);
+template <typename T, typename A>
+void qrDecompose(MyDynMat<T,A> &a, std::vector<T> &tau);
+
+// Solve with a factored matrix, b is overwritten with the solution
+template <typename U, typename T>
+void luSolve(MyMatView<U> lu, const size_t *pivots, MyMatView<T> b);
+template <typename U, typename T>
+void choleskySolve(MyMatView<U> l, MyMatView<T> b);
+// The solution is in the first qr.cols() rows of b, false when R is singular
+template <typename U, typename T>
+bool qrSolve(MyMatView<U> qr, const T *tau, MyMatView<T> b);
+
+// Solve ax = b, false when a is singular
+template <typename T, size_t N, size_t K, Layout L, Layout L2>
+bool solve(const MyMat<T,N,N,L> &a, const MyMat<T,N,K,L2> &b, MyMat<T,N,K,L2> &x);
+template <typename T, size_t N, Layout L>
+bool solve(const MyMat<T,N,N,L> &a, const MyVector::MyVec<T,N> &b, MyVector::MyVec<T,N> &x);
+template <typename T, typename A, typename A2>
+bool solve(const MyDynMat<T,A> &a, const MyDynMat<T,A2> &b, MyDynMat<T,A2> &x);
+template <typename T, typename A, typename A2>
+bool solve(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &b, MyVector::MyDynVec<T,A2> &x);
+
+// Inverse, false when a is singular
+template <typename T, size_t N, Layout L>
+constexpr bool inverse(const MyMat<T,N,N,L> &a, MyMat<T,N,N,L> &inv);
+template <typename T, typename A>
+bool inverse(const MyDynMat<T,A> &a, MyDynMat<T,A> &inv);
+
+template <typename T, size_t N, Layout L>
+constexpr T determinant(const MyMat<T,N,N,L> &a);
+template <typename T, typename A>
+T determinant(const MyDynMat<T,A> &a);
+
+} // namespace MyMatrix
+
+#include "mydecomp.tpp"
+
+#endif // MYDECOMP_H
@@ -0,0 +1,798 @@
+//
+//  mydecomp.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include "simd.h"
+
+namespace MyMatrix {
+
+namespace detail {
+
+// Fixed-size matrices up to this order use the fully unrolled kernels
+constexpr size_t unrollOrder = 8;
+
+// Panel width of the blocked algorithms
+constexpr size_t decompBlock = 32;
+
+// Compile-time extents and strides. The kernels below take either these or plain
+// size_t/ptrdiff_t, and every loop whose bounds are both extents is expanded at compile time.
+template <size_t N>
+using Extent = std::integral_constant<size_t, N>;
+template <ptrdiff_t S>
+using Step = std::integral_constant<ptrdiff_t, S>;
+
+template <typename I>
+struct IsExtent : std::false_type {};
+template <size_t N>
+struct IsExtent<Extent<N>> : std::true_type {};
+template <typename I>
+constexpr bool isExtent = IsExtent<I>::value;
+
+// i + 1
+template <typename I>
+constexpr auto next(I i)
+{
+    if constexpr (isExtent<I>) {
+        return Extent<I::value + 1>();
+    }
+    else {
+        return i + 1;
+    }
+}
+
+// n - 1 - i, to walk [0, n) backwards
+template <typename N, typename I>
+constexpr auto reverse(N n, I i)
+{
+    if constexpr (isExtent<N> && isExtent<I>) {
+        return Extent<N::value - 1 - I::value>();
+    }
+    else {
+        return n - 1 - i;
+    }
+}
+
+template <typename M, typename N>
+constexpr auto minOf(M m, N n)
+{
+    if constexpr (isExtent<M> && isExtent<N>) {
+        return Extent<(M::value < N::value ? M::value : N::value)>();
+    }
+    else {
+        return std::min<size_t>(m, n);
+    }
+}
+
+// Call f(i) for i in [begin, end)
+template <typename B, typename E, typename F>
+inline void forRange(B begin, E end, F &&f)
+{
+    if constexpr (isExtent<B> && isExtent<E>) {
+        if constexpr (B::value < E::value) {
+            f(begin);
+            forRange(Extent<B::value + 1>(), end, f);
+        }
+    }
+    else {
+        for (size_t i = begin; i < static_cast<size_t>(end); ++i) {
+            f(i);
+        }
+    }
+}
+
+template <typename T, typename I, typename J, typename RS, typename CS>
+inline T& entry(T *a, I i, J j, RS rs, CS cs)
+{
+    return a[static_cast<ptrdiff_t>(i) * static_cast<ptrdiff_t>(rs) + static_cast<ptrdiff_t>(j) * static_cast<ptrdiff_t>(cs)];
+}
+
+// LU with partial pivoting of an m x n matrix, row swaps limited to its n columns
+template <typename T, typename M, typename N, typename RS, typename CS>
+MYSIMD_FLATTEN bool luUnblocked(T *a, M m, N n, RS rs, CS cs, size_t *piv)
+{
+    bool ok = true;
+    forRange(Extent<0>(), minOf(m, n), [&](auto k) {
+        size_t p = k;
+        T best = std::abs(entry(a, k, k, rs, cs));
+        forRange(next(k), m, [&](auto i) {
+            T v = std::abs(entry(a, i, k, rs, cs));
+            if (v > best) {
+                best = v;
+                p = i;
+            }
+        });
+        piv[k] = p;
+        if (p != k) {
+            forRange(Extent<0>(), n, [&](auto j) {
+                std::swap(entry(a, k, j, rs, cs), entry(a, p, j, rs, cs));
+            });
+        }
+
+        T d = entry(a, k, k, rs, cs);
+        if (d == T(0)) {
+            ok = false;
+            return;
+        }
+        T inv = T(1) / d;
+        forRange(next(k), m, [&](auto i) {
+            T l = entry(a, i, k, rs, cs) *= inv;
+            forRange(next(k), n, [&](auto j) {
+                entry(a, i, j, rs, cs) -= l * entry(a, k, j, rs, cs);
+            });
+        });
+    });
+    return ok;
+}
+
+// Cholesky of the lower triangle, the upper triangle isn't read or written
+template <typename T, typename N, typename RS, typename CS>
+MYSIMD_FLATTEN bool choleskyUnblocked(T *a, N n, RS rs, CS cs)
+{
+    bool ok = true;
+    forRange(Extent<0>(), n, [&](auto j) {
+        if (!ok) {
+            return;
+        }
+        T d = entry(a, j, j, rs, cs);
+        forRange(Extent<0>(), j, [&](auto p) {
+            d -= entry(a, j, p, rs, cs) * entry(a, j, p, rs, cs);
+        });
+        if (!(d > T(0))) {
+            ok = false;
+            return;
+        }
+
+        T l = std::sqrt(d);
+        T inv = T(1) / l;
+        entry(a, j, j, rs, cs) = l;
+        forRange(next(j), n, [&](auto i) {
+            T s = entry(a, i, j, rs, cs);
+            forRange(Extent<0>(), j, [&](auto p) {
+                s -= entry(a, i, p, rs, cs) * entry(a, j, p, rs, cs);
+            });
+            entry(a, i, j, rs, cs) = s * inv;
+        });
+    });
+    return ok;
+}
+
+// Householder QR of an m x n matrix, work holds n elements
+template <typename T, typename M, typename N, typename RS, typename CS>
+MYSIMD_FLATTEN void qrUnblocked(T *a, M m, N n, RS rs, CS cs, T *tau, T *work)
+{
+    forRange(Extent<0>(), minOf(m, n), [&](auto k) {
+        T alpha = entry(a, k, k, rs, cs);
+        T sigma = 0;
+        forRange(next(k), m, [&](auto i) {
+            sigma += entry(a, i, k, rs, cs) * entry(a, i, k, rs, cs);
+        });
+        if (sigma == T(0)) {
+            tau[k] = T(0);
+            return;
+        }
+
+        // H = I - tau v v^T, with v(k) = 1, maps column k to (beta, 0, ..., 0)
+        T norm = std::sqrt(alpha * alpha + sigma);
+        T beta = alpha >= T(0) ? -norm : norm;
+        T t = (beta - alpha) / beta;
+        T scale = T(1) / (alpha - beta);
+        tau[k] = t;
+        forRange(next(k), m, [&](auto i) {
+            entry(a, i, k, rs, cs) *= scale;
+        });
+        entry(a, k, k, rs, cs) = beta;
+
+        // Apply H to the columns on the right, a row at a time: work = tau v^T A, A -= v work
+        forRange(next(k), n, [&](auto j) {
+            work[j] = entry(a, k, j, rs, cs);
+        });
+        forRange(next(k), m, [&](auto i) {
+            T v = entry(a, i, k, rs, cs);
+            forRange(next(k), n, [&](auto j) {
+                work[j] += v * entry(a, i, j, rs, cs);
+            });
+        });
+        forRange(next(k), n, [&](auto j) {
+            work[j] *= t;
+            entry(a, k, j, rs, cs) -= work[j];
+        });
+        forRange(next(k), m, [&](auto i) {
+            T v = entry(a, i, k, rs, cs);
+            forRange(next(k), n, [&](auto j) {
+                entry(a, i, j, rs, cs) -= v * work[j];
+            });
+        });
+    });
+}
+
+// Solve LUx = Pb for the k columns of b
+template <typename T, typename N, typename RS, typename CS, typename K, typename BRS, typename BCS>
+MYSIMD_FLATTEN void luSubstitute(const T *lu, N n, RS rs, CS cs, const size_t *piv, T *b, K k, BRS brs, BCS bcs)
+{
+    forRange(Extent<0>(), n, [&](auto i) {
+        if (piv[i] != i) {
+            forRange(Extent<0>(), k, [&](auto c) {
+                std::swap(entry(b, i, c, brs, bcs), entry(b, piv[i], c, brs, bcs));
+            });
+        }
+    });
+    forRange(Extent<0>(), n, [&](auto i) {
+        forRange(Extent<0>(), i, [&](auto p) {
+            T l = entry(lu, i, p, rs, cs);
+            forRange(Extent<0>(), k, [&](auto c) {
+                entry(b, i, c, brs, bcs) -= l * entry(b, p, c, brs, bcs);
+            });
+        });
+    });
+    forRange(Extent<0>(), n, [&](auto r) {
+        auto i = reverse(n, r);
+        forRange(next(i), n, [&](auto p) {
+            T u = entry(lu, i, p, rs, cs);
+            forRange(Extent<0>(), k, [&](auto c) {
+                entry(b, i, c, brs, bcs) -= u * entry(b, p, c, brs, bcs);
+            });
+        });
+        T inv = T(1) / entry(lu, i, i, rs, cs);
+        forRange(Extent<0>(), k, [&](auto c) {
+            entry(b, i, c, brs, bcs) *= inv;
+        });
+    });
+}
+
+// Solve LL^Tx = b for the k columns of b
+template <typename T, typename N, typename RS, typename CS, typename K, typename BRS, typename BCS>
+MYSIMD_FLATTEN void choleskySubstitute(const T *l, N n, RS rs, CS cs, T *b, K k, BRS brs, BCS bcs)
+{
+    forRange(Extent<0>(), n, [&](auto i) {
+        forRange(Extent<0>(), i, [&](auto p) {
+            T v = entry(l, i, p, rs, cs);
+            forRange(Extent<0>(), k, [&](auto c) {
+                entry(b, i, c, brs, bcs) -= v * entry(b, p, c, brs, bcs);
+            });
+        });
+        T inv = T(1) / entry(l, i, i, rs, cs);
+        forRange(Extent<0>(), k, [&](auto c) {
+            entry(b, i, c, brs, bcs) *= inv;
+        });
+    });
+    forRange(Extent<0>(), n, [&](auto r) {
+        auto i = reverse(n, r);
+        forRange(next(i), n, [&](auto p) {
+            T v = entry(l, p, i, rs, cs);
+            forRange(Extent<0>(), k, [&](auto c) {
+                entry(b, i, c, brs, bcs) -= v * entry(b, p, c, brs, bcs);
+            });
+        });
+        T inv = T(1) / entry(l, i, i, rs, cs);
+        forRange(Extent<0>(), k, [&](auto c) {
+            entry(b, i, c, brs, bcs) *= inv;
+        });
+    });
+}
+
+// Blocked right-looking LU of an n x n matrix
+template <typename T, typename RS, typename CS>
+bool luBlocked(T *a, size_t n, RS rs, CS cs, size_t *piv)
+{
+    if (n <= decompBlock) {
+        return luUnblocked(a, n, n, rs, cs, piv);
+    }
+
+    // The panel is factored in a packed copy: in place, each of its rows would be on a different page
+    std::vector<T> panel;
+
+    bool ok = true;
+    for (size_t k0 = 0; k0 < n; k0 += decompBlock) {
+        size_t kb = std::min(decompBlock, n - k0);
+        size_t k1 = k0 + kb;
+        size_t m = n - k0;
+
+        // Factor the panel of columns [k0, k1), then apply its row swaps to the other columns
+        panel.resize(m * kb);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < kb; ++j) {
+                panel[i * kb + j] = entry(a, k0 + i, k0 + j, rs, cs);
+            }
+        }
+        ok &= luUnblocked(panel.data(), m, kb, static_cast<ptrdiff_t>(kb), Step<1>(), piv + k0);
+        for (size_t i = 0; i < m; ++i) {
+            for (size_t j = 0; j < kb; ++j) {
+                entry(a, k0 + i, k0 + j, rs, cs) = panel[i * kb + j];
+            }
+        }
+        for (size_t k = k0; k < k1; ++k) {
+            piv[k] += k0;
+            size_t p = piv[k];
+            if (p != k) {
+                for (size_t j = 0; j < k0; ++j) {
+                    std::swap(entry(a, k, j, rs, cs), entry(a, p, j, rs, cs));
+                }
+                for (size_t j = k1; j < n; ++j) {
+                    std::swap(entry(a, k, j, rs, cs), entry(a, p, j, rs, cs));
+                }
+            }
+        }
+        if (k1 == n) {
+            break;
+        }
+
+        // U12 = L11^-1 A12, the columns are independent
+        MyExec::parallelFor<T>(n - k1, kb, [&](size_t begin, size_t end) {
+            for (size_t i = k0 + 1; i < k1; ++i) {
+                for (size_t p = k0; p < i; ++p) {
+                    T l = entry(a, i, p, rs, cs);
+                    for (size_t j = k1 + begin; j < k1 + end; ++j) {
+                        entry(a, i, j, rs, cs) -= l * entry(a, p, j, rs, cs);
+                    }
+                }
+            }
+        });
+
+        // A22 -= L21 U12
+        gemm<T>(n - k1, n - k1, kb, T(-1), &entry(a, k1, k0, rs, cs), rs, cs, &entry(a, k0, k1, rs, cs), rs, cs,
+                T(1), &entry(a, k1, k1, rs, cs), rs, cs);
+    }
+    return ok;
+}
+
+// Blocked right-looking Cholesky of an n x n matrix, the upper triangle is left undefined
+template <typename T, typename RS, typename CS>
+bool choleskyBlocked(T *a, size_t n, RS rs, CS cs)
+{
+    for (size_t k0 = 0; k0 < n; k0 += decompBlock) {
+        size_t kb = std::min(decompBlock, n - k0);
+        size_t k1 = k0 + kb;
+        if (!choleskyUnblocked(&entry(a, k0, k0, rs, cs), kb, rs, cs)) {
+            return false;
+        }
+        if (k1 == n) {
+            break;
+        }
+
+        // L21 = A21 L11^-T, the rows are independent
+        MyExec::parallelFor<T>(n - k1, kb, [&](size_t begin, size_t end) {
+            for (size_t i = k1 + begin; i < k1 + end; ++i) {
+                for (size_t j = k0; j < k1; ++j) {
+                    T s = entry(a, i, j, rs, cs);
+                    for (size_t p = k0; p < j; ++p) {
+                        s -= entry(a, i, p, rs, cs) * entry(a, j, p, rs, cs);
+                    }
+                    entry(a, i, j, rs, cs) = s / entry(a, j, j, rs, cs);
+                }
+            }
+        });
+
+        // A22 -= L21 L21^T, the upper triangle of A22 is updated too but never read
+        gemm<T>(n - k1, n - k1, kb, T(-1), &entry(a, k1, k0, rs, cs), rs, cs, &entry(a, k1, k0, rs, cs), cs, rs,
+                T(1), &entry(a, k1, k1, rs, cs), rs, cs);
+    }
+    return true;
+}
+
+// Blocked Householder QR of an m x n matrix. Each panel of reflectors is applied to the
+// remaining columns at once, in the compact WY form H = I - V T V^T.
+template <typename T, typename RS, typename CS>
+void qrBlocked(T *a, size_t m, size_t n, RS rs, CS cs, T *tau)
+{
+    // V is unit lower trapezoidal, T upper triangular, and W holds V^T A2
+    std::vector<T> v;
+    std::vector<T> t;
+    std::vector<T> w;
+
+    if (n <= decompBlock) {
+        w.resize(n);
+        qrUnblocked(a, m, n, rs, cs, tau, w.data());
+        return;
+    }
+
+    size_t kmin = std::min(m, n);
+    for (size_t k0 = 0; k0 < kmin; k0 += decompBlock) {
+        size_t kb = std::min(decompBlock, kmin - k0);
+        size_t mm = m - k0;
+        size_t nn = n - k0 - kb;
+
+        // Factor a packed copy of the panel, which is then also the storage for V
+        v.resize(mm * kb);
+        for (size_t i = 0; i < mm; ++i) {
+            for (size_t j = 0; j < kb; ++j) {
+                v[i * kb + j] = entry(a, k0 + i, k0 + j, rs, cs);
+            }
+        }
+        w.resize(kb);
+        qrUnblocked(v.data(), mm, kb, static_cast<ptrdiff_t>(kb), Step<1>(), tau + k0, w.data());
+        for (size_t i = 0; i < mm; ++i) {
+            for (size_t j = 0; j < kb; ++j) {
+                entry(a, k0 + i, k0 + j, rs, cs) = v[i * kb + j];
+            }
+        }
+        if (nn == 0) {
+            continue;
+        }
+
+        for (size_t i = 0; i < mm; ++i) {
+            for (size_t j = i; j < kb; ++j) {
+                v[i * kb + j] = T(i == j);
+            }
+        }
+
+        // T(0:i, i) = -tau_i T(0:i, 0:i) V(:, 0:i)^T v_i
+        t.assign(kb * kb, T(0));
+        w.resize(kb);
+        for (size_t i = 0; i < kb; ++i) {
+            T ti = tau[k0 + i];
+            t[i * kb + i] = ti;
+            for (size_t j = 0; j < i; ++j) {
+                T s = 0;
+                for (size_t r = i; r < mm; ++r) {
+                    s += v[r * kb + j] * v[r * kb + i];
+                }
+                w[j] = s;
+            }
+            for (size_t j = 0; j < i; ++j) {
+                T s = 0;
+                for (size_t p = j; p < i; ++p) {
+                    s += t[j * kb + p] * w[p];
+                }
+                t[j * kb + i] = -ti * s;
+            }
+        }
+
+        // A2 -= V T^T V^T A2
+        T *a2 = &entry(a, k0, k0 + kb, rs, cs);
+        w.resize(kb * nn);
+        gemm<T>(kb, nn, mm, T(1), v.data(), 1, static_cast<ptrdiff_t>(kb), a2, rs, cs,
+                T(0), w.data(), static_cast<ptrdiff_t>(nn), 1);
+        MyExec::parallelFor<T>(nn, kb, [&](size_t begin, size_t end) {
+            for (size_t i = kb; i-- > 0;) {
+                T *wi = w.data() + i * nn;
+                for (size_t c = begin; c < end; ++c) {
+                    wi[c] *= t[i * kb + i];
+                }
+                for (size_t p = 0; p < i; ++p) {
+                    T tp = t[p * kb + i];
+                    const T *wp = w.data() + p * nn;
+                    for (size_t c = begin; c < end; ++c) {
+                        wi[c] += tp * wp[c];
+                    }
+                }
+            }
+        });
+        gemm<T>(mm, nn, kb, T(-1), v.data(), static_cast<ptrdiff_t>(kb), 1, w.data(), static_cast<ptrdiff_t>(nn), 1,
+                T(1), a2, rs, cs);
+    }
+}
+
+// Call f(rs, cs) with a unit stride as a compile-time constant, so the inner loops vectorize
+template <typename T, typename F>
+decltype(auto) withStrides(const MyMatView<T> &a, F &&f)
+{
+    if (a.colStride() == 1) {
+        return f(a.rowStride(), Step<1>());
+    }
+    if (a.rowStride() == 1) {
+        return f(Step<1>(), a.colStride());
+    }
+    return f(a.rowStride(), a.colStride());
+}
+
+template <typename T>
+void zeroUpper(MyMatView<T> a)
+{
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = i + 1; j < a.cols(); ++j) {
+            a(i,j) = T(0);
+        }
+    }
+}
+
+template <typename T>
+MyMatView<T> columnView(T *data, size_t n)
+{
+    return MyMatView<T>(data, n, 1, 1, static_cast<ptrdiff_t>(n));
+}
+
+} // namespace detail
+
+template <typename T>
+bool luDecompose(MyMatView<T> a, size_t *pivots)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    assert(a.rows() == a.cols());
+    MYSTATS_SCOPE("luDecompose", a.size(), 2 * a.rows() * a.size() / 3, 2 * a.size() * sizeof(T));
+    return detail::withStrides(a, [&](auto rs, auto cs) {
+        return detail::luBlocked(a.data(), a.rows(), rs, cs, pivots);
+    });
+}
+
+template <typename T, size_t N, Layout L>
+bool luDecompose(MyMat<T,N,N,L> &a, std::array<size_t,N> &pivots)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    using Mat = MyMat<T,N,N,L>;
+    if constexpr (N <= detail::unrollOrder) {
+        MYSTATS_COUNT("luDecompose", N * N, 2 * N * N * N / 3, 2 * N * N * sizeof(T));
+        return detail::luUnblocked(a.data(), detail::Extent<N>(), detail::Extent<N>(),
+                                   detail::Step<Mat::rowStride>(), detail::Step<Mat::colStride>(), pivots.data());
+    }
+    else {
+        return luDecompose(a.view(), pivots.data());
+    }
+}
+
+template <typename T, typename A>
+bool luDecompose(MyDynMat<T,A> &a, std::vector<size_t> &pivots)
+{
+    pivots.resize(a.rows());
+    return luDecompose(a.view(), pivots.data());
+}
+
+template <typename T>
+bool choleskyDecompose(MyMatView<T> a)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    assert(a.rows() == a.cols());
+    MYSTATS_SCOPE("choleskyDecompose", a.size(), a.rows() * a.size() / 3, 2 * a.size() * sizeof(T));
+    bool ok = detail::withStrides(a, [&](auto rs, auto cs) {
+        return detail::choleskyBlocked(a.data(), a.rows(), rs, cs);
+    });
+    detail::zeroUpper(a);
+    return ok;
+}
+
+template <typename T, size_t N, Layout L>
+bool choleskyDecompose(MyMat<T,N,N,L> &a)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    using Mat = MyMat<T,N,N,L>;
+    if constexpr (N <= detail::unrollOrder) {
+        MYSTATS_COUNT("choleskyDecompose", N * N, N * N * N / 3, 2 * N * N * sizeof(T));
+        bool ok = detail::choleskyUnblocked(a.data(), detail::Extent<N>(),
+                                            detail::Step<Mat::rowStride>(), detail::Step<Mat::colStride>());
+        a.toLowerTriangular();
+        return ok;
+    }
+    else {
+        return choleskyDecompose(a.view());
+    }
+}
+
+template <typename T, typename A>
+bool choleskyDecompose(MyDynMat<T,A> &a)
+{
+    return choleskyDecompose(a.view());
+}
+
+template <typename T>
+void qrDecompose(MyMatView<T> a, T *tau)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    MYSTATS_SCOPE("qrDecompose", a.size(), 2 * a.size() * std::min(a.rows(), a.cols()), 2 * a.size() * sizeof(T));
+    detail::withStrides(a, [&](auto rs, auto cs) {
+        detail::qrBlocked(a.data(), a.rows(), a.cols(), rs, cs, tau);
+    });
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+void qrDecompose(MyMat<T,R,C,L> &a, std::array<T,(R < C ? R : C)> &tau)
+{
+    static_assert (std::is_floating_point_v<T>, "Decompositions require a floating point type");
+    using Mat = MyMat<T,R,C,L>;
+    if constexpr (R <= detail::unrollOrder && C <= detail::unrollOrder) {
+        MYSTATS_COUNT("qrDecompose", R * C, 2 * R * C * std::min(R, C), 2 * R * C * sizeof(T));
+        std::array<T,C> work;
+        detail::qrUnblocked(a.data(), detail::Extent<R>(), detail::Extent<C>(),
+                            detail::Step<Mat::rowStride>(), detail::Step<Mat::colStride>(), tau.data(), work.data());
+    }
+    else {
+        qrDecompose(a.view(), tau.data());
+    }
+}
+
+template <typename T, typename A>
+void qrDecompose(MyDynMat<T,A> &a, std::vector<T> &tau)
+{
+    tau.resize(std::min(a.rows(), a.cols()));
+    qrDecompose(a.view(), tau.data());
+}
+
+template <typename U, typename T>
+void luSolve(MyMatView<U> lu, const size_t *pivots, MyMatView<T> b)
+{
+    static_assert (std::is_same_v<std::remove_const_t<U>, T>, "Matrices must have the same value type");
+    assert(lu.rows() == lu.cols() && b.rows() == lu.rows());
+    MYSTATS_SCOPE("luSolve", b.size(), 2 * lu.size() * b.cols(), (lu.size() + 2 * b.size()) * sizeof(T));
+    detail::luSubstitute<T>(lu.data(), lu.rows(), lu.rowStride(), lu.colStride(), pivots,
+                            b.data(), b.cols(), b.rowStride(), b.colStride());
+}
+
+template <typename U, typename T>
+void choleskySolve(MyMatView<U> l, MyMatView<T> b)
+{
+    static_assert (std::is_same_v<std::remove_const_t<U>, T>, "Matrices must have the same value type");
+    assert(l.rows() == l.cols() && b.rows() == l.rows());
+    MYSTATS_SCOPE("choleskySolve", b.size(), 2 * l.size() * b.cols(), (l.size() + 2 * b.size()) * sizeof(T));
+    detail::choleskySubstitute<T>(l.data(), l.rows(), l.rowStride(), l.colStride(),
+                                  b.data(), b.cols(), b.rowStride(), b.colStride());
+}
+
+template <typename U, typename T>
+bool qrSolve(MyMatView<U> qr, const T *tau, MyMatView<T> b)
+{
+    static_assert (std::is_same_v<std::remove_const_t<U>, T>, "Matrices must have the same value type");
+    size_t m = qr.rows();
+    size_t n = qr.cols();
+    size_t k = b.cols();
+    assert(m >= n && b.rows() == m);
+
+    // b = Q^T b
+    for (size_t p = 0; p < n; ++p) {
+        if (tau[p] == T(0)) {
+            continue;
+        }
+        for (size_t c = 0; c < k; ++c) {
+            T w = b(p,c);
+            for (size_t i = p + 1; i < m; ++i) {
+                w += qr(i,p) * b(i,c);
+            }
+            w *= tau[p];
+            b(p,c) -= w;
+            for (size_t i = p + 1; i < m; ++i) {
+                b(i,c) -= w * qr(i,p);
+            }
+        }
+    }
+
+    // Rx = b
+    for (size_t i = n; i-- > 0;) {
+        if (qr(i,i) == T(0)) {
+            return false;
+        }
+        T inv = T(1) / qr(i,i);
+        for (size_t c = 0; c < k; ++c) {
+            T s = b(i,c);
+            for (size_t p = i + 1; p < n; ++p) {
+                s -= qr(i,p) * b(p,c);
+            }
+            b(i,c) = s * inv;
+        }
+    }
+    return true;
+}
+
+template <typename T, size_t N, size_t K, Layout L, Layout L2>
+bool solve(const MyMat<T,N,N,L> &a, const MyMat<T,N,K,L2> &b, MyMat<T,N,K,L2> &x)
+{
+    using Mat = MyMat<T,N,N,L>;
+    using Rhs = MyMat<T,N,K,L2>;
+    Mat lu = a;
+    std::array<size_t,N> pivots;
+    if (!luDecompose(lu, pivots)) {
+        return false;
+    }
+    x = b;
+    if constexpr (N <= detail::unrollOrder) {
+        detail::luSubstitute(lu.data(), detail::Extent<N>(), detail::Step<Mat::rowStride>(), detail::Step<Mat::colStride>(),
+                             pivots.data(), x.data(), detail::Extent<K>(), detail::Step<Rhs::rowStride>(), detail::Step<Rhs::colStride>());
+    }
+    else {
+        luSolve(lu.view(), pivots.data(), x.view());
+    }
+    return true;
+}
+
+template <typename T, size_t N, Layout L>
+bool solve(const MyMat<T,N,N,L> &a, const MyVector::MyVec<T,N> &b, MyVector::MyVec<T,N> &x)
+{
+    using Mat = MyMat<T,N,N,L>;
+    Mat lu = a;
+    std::array<size_t,N> pivots;
+    if (!luDecompose(lu, pivots)) {
+        return false;
+    }
+    x = b;
+    if constexpr (N <= detail::unrollOrder) {
+        detail::luSubstitute(lu.data(), detail::Extent<N>(), detail::Step<Mat::rowStride>(), detail::Step<Mat::colStride>(),
+                             pivots.data(), x.data(), detail::Extent<1>(), detail::Step<1>(), detail::Step<1>());
+    }
+    else {
+        luSolve(lu.view(), pivots.data(), detail::columnView(x.data(), N));
+    }
+    return true;
+}
+
+template <typename T, typename A, typename A2>
+bool solve(const MyDynMat<T,A> &a, const MyDynMat<T,A2> &b, MyDynMat<T,A2> &x)
+{
+    assert(a.square() && b.rows() == a.rows());
+    MyDynMat<T> lu = a.view();
+    std::vector<size_t> pivots;
+    if (!luDecompose(lu, pivots)) {
+        return false;
+    }
+    x = b;
+    luSolve(lu.view(), pivots.data(), x.view());
+    return true;
+}
+
+template <typename T, typename A, typename A2>
+bool solve(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &b, MyVector::MyDynVec<T,A2> &x)
+{
+    assert(a.square() && b.size() == a.rows());
+    MyDynMat<T> lu = a.view();
+    std::vector<size_t> pivots;
+    if (!luDecompose(lu, pivots)) {
+        return false;
+    }
+    x = b;
+    luSolve(lu.view(), pivots.data(), detail::columnView(x.data(), x.size()));
+    return true;
+}
+
+template <typename T, size_t N, Layout L>
+constexpr bool inverse(const MyMat<T,N,N,L> &a, MyMat<T,N,N,L> &inv)
+{
+    static_assert (std::is_floating_point_v<T>, "The inverse requires a floating point type");
+    if constexpr (N <= 4) {
+        return detail::smallInverse<N>(a.data(), inv.data());
+    }
+    else {
+        return solve(a, makeIdentity<T,N,N,L>(), inv);
+    }
+}
+
+template <typename T, typename A>
+bool inverse(const MyDynMat<T,A> &a, MyDynMat<T,A> &inv)
+{
+    assert(a.square());
+    MyDynMat<T,A> id(a.rows(), a.cols(), a.get_allocator());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        id(i,i) = 1;
+    }
+    return solve(a, id, inv);
+}
+
+template <typename T, size_t N, Layout L>
+constexpr T determinant(const MyMat<T,N,N,L> &a)
+{
+    if constexpr (N <= 4) {
+        return detail::smallDeterminant<N>(a.data());
+    }
+    else {
+        MyMat<T,N,N,L> lu = a;
+        std::array<size_t,N> pivots{};
+        if (!luDecompose(lu, pivots)) {
+            return T(0);
+        }
+        T det = 1;
+        for (size_t i = 0; i < N; ++i) {
+            det *= pivots[i] == i ? lu(i,i) : -lu(i,i);
+        }
+        return det;
+    }
+}
+
+template <typename T, typename A>
+T determinant(const MyDynMat<T,A> &a)
+{
+    assert(a.square());
+    MyDynMat<T> lu = a.view();
+    std::vector<size_t> pivots;
+    if (!luDecompose(lu, pivots)) {
+        return T(0);
+    }
+    T det = 1;
+    for (size_t i = 0; i < lu.rows(); ++i) {
+        det *= pivots[i] == i ? lu(i,i) : -lu(i,i);
+    }
+    return det;
+}
+
+} // namespace MyMatrix
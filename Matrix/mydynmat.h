@@ -0,0 +1,197 @@
+//
+//  mydynmat.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYDYNMAT_H
+#define MYDYNMAT_H
+
+#include <iostream>
+#include <vector>
+#include <initializer_list>
+#include "allocator.h"
+#include "mymat.h"
+#include "mydynvec.h"
+#include "mystats.h"
+
+/*!
+ * \brief A heap-backed matrix whose dimensions are chosen at run time
+ * \details MyDynMat is the run-time sized counterpart of MyMat. It supports the same
+ * operations, but the number of rows and columns are constructor arguments instead of
+ * template parameters, and the elements live on the heap. That makes it suitable for
+ * matrices sized from input data, or too large to live on the stack.
+ *
+ * Storage is row-major and obtained from the Alloc template parameter, by default a
+ * 64-byte aligned allocator (see allocator.h). Moving a MyDynMat transfers the buffer
+ * without copying any element.
+ *
+ * \verbatim
+ * MyDynMat<> mat(1000, 2000);        // 1000x2000 matrix, type double
+ * MyDynMat<int> mat(2, 2, {1, 2,
+ *                          3, 4});   // 2x2 matrix, type int
+ * MyDynMat<> mat(fixed);             // copy of a MyMat
+ * auto fixed = mat.toFixed<2, 2>();  // back to a MyMat, dimensions must match
+ * \endverbatim
+ *
+ * As with MyMat, transposed(), block(), row() and col() return views on the elements
+ * (see myview.h). A view, or an expression of views only, evaluates to a MyDynMat.
+ * Assigning an expression that reads the matrix through a view in another order, such
+ * as m = m.transposed(), evaluates it aside first, or transposes in place.
+ *
+ * Operations between two MyDynMat require matching dimensions, which is checked with assert.
+ * As with MyMat, element-wise arithmetic is lazy and evaluated in a single pass (see myexpr.h).
+ */
+namespace MyMatrix {
+
+template <typename T = double, typename Alloc = MyMemory::AlignedAllocator<T>>
+class MyDynMat : public MyExpr::Expression<MyDynMat<T,Alloc>> {
+public:
+    using value_type = T;
+    using result_type = MyDynMat;
+    using allocator_type = Alloc;
+
+    explicit MyDynMat(const Alloc &alloc = Alloc());
+    MyDynMat(size_t rows, size_t cols, const Alloc &alloc = Alloc());
+    MyDynMat(size_t rows, size_t cols, std::initializer_list<T>, const Alloc &alloc = Alloc());
+
+    template <size_t R, size_t C, Layout L>
+    explicit MyDynMat(const MyMat<T,R,C,L> &, const Alloc &alloc = Alloc());
+
+    // Takes the allocator of the expression, which must convert to Alloc: a view, for
+    // instance, has none of its own, so pass one for any other allocator than the default
+    template <typename E>
+    MyDynMat(const MyExpr::Expression<E> &);
+    template <typename E>
+    MyDynMat(const MyExpr::Expression<E> &, const Alloc &alloc);
+
+    ~MyDynMat() = default;
+
+    MyDynMat(const MyDynMat &) = default;
+    MyDynMat& operator=(const MyDynMat &) = default;
+
+    MyDynMat(MyDynMat &&) noexcept = default;
+    MyDynMat& operator=(MyDynMat &&) noexcept = default;
+
+    template <typename E>
+    MyDynMat& operator=(const MyExpr::Expression<E> &);
+
+    template <size_t R, size_t C>
+    MyMat<T,R,C> toFixed() const;
+
+    MyDynMat copyTransposed() const;
+
+    MyDynMat& toDiagonal();
+    MyDynMat& toUpperTriangular();
+    MyDynMat& toLowerTriangular();
+    // Transpose the elements in place, rows and columns are swapped
+    MyDynMat& transpose();
+
+    // Views of the matrix elements
+    MyMatView<T> view() noexcept { return MyMatView<T>(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1); }
+    MyMatView<const T> view() const noexcept { return MyMatView<const T>(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1); }
+    MyMatView<T> transposed() noexcept { return view().transposed(); }
+    MyMatView<const T> transposed() const noexcept { return view().transposed(); }
+    MyMatView<T> block(size_t row, size_t col, size_t rows, size_t cols) { return view().block(row, col, rows, cols); }
+    MyMatView<const T> block(size_t row, size_t col, size_t rows, size_t cols) const { return view().block(row, col, rows, cols); }
+    MyMatView<T> row(size_t i) { return view().row(i); }
+    MyMatView<const T> row(size_t i) const { return view().row(i); }
+    MyMatView<T> col(size_t j) { return view().col(j); }
+    MyMatView<const T> col(size_t j) const { return view().col(j); }
+
+    auto begin() noexcept { return data_.begin(); }
+    auto begin() const noexcept { return data_.begin(); }
+    auto cbegin() const noexcept { return data_.cbegin(); }
+
+    auto end() noexcept { return data_.end(); }
+    auto end() const noexcept { return data_.end(); }
+    auto cend() const noexcept { return data_.cend(); }
+
+    T* data() noexcept { return data_.data(); }
+    const T* data() const noexcept { return data_.data(); }
+
+    size_t size() const noexcept { return data_.size(); }
+    bool empty() const noexcept { return data_.empty(); }
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    bool square() const noexcept { return rows_ == cols_; }
+    bool isContiguous(Layout order) const noexcept { return order == Layout::RowMajor; }
+
+    allocator_type get_allocator() const { return data_.get_allocator(); }
+
+          T& operator() (size_t row, size_t col);
+    const T& operator() (size_t row, size_t col) const;
+
+    MyDynMat& operator+=(const MyDynMat &);
+    MyDynMat& operator-=(const MyDynMat &);
+    MyDynMat& operator*=(double);
+
+    template <typename E>
+    MyDynMat& operator+=(const MyExpr::Expression<E> &);
+    template <typename E>
+    MyDynMat& operator-=(const MyExpr::Expression<E> &);
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    std::vector<T, Alloc> data_;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+};
+
+template <typename T, typename A>
+struct IsMatrix<MyDynMat<T,A>> : std::true_type {};
+
+template <typename T>
+struct ViewResult {
+    using type = MyDynMat<T>;
+};
+
+// Factory methods
+template <typename T = double>
+MyDynMat<T> makeIdentity(size_t n);
+template <typename T = double>
+MyDynMat<T> makeUpperTriangular(size_t n);
+template <typename T = double>
+MyDynMat<T> makeLowerTriangular(size_t n);
+
+// Matrix multiplication, lhs.cols() must equal rhs.rows()
+template <typename T, typename A>
+MyDynMat<T,A> multiply(const MyDynMat<T,A> &, const MyDynMat<T,A> &);
+template <typename T, typename A>
+MyDynMat<T,A> multiply(const MyDynMat<T,A> &, const MyDynMat<T,A> &, const MyExec::Context &);
+template <typename T, typename A>
+MyDynMat<T,A> operator*(const MyDynMat<T,A> &, const MyDynMat<T,A> &);
+
+// Multiplication of any two matrices where at least one is a view
+template <typename L, typename R, typename = std::enable_if_t<isMatrix<L> && isMatrix<R> && (isView<L> || isView<R>)>>
+MyDynMat<typename L::value_type> multiply(const L &, const R &);
+template <typename L, typename R, typename = std::enable_if_t<isMatrix<L> && isMatrix<R> && (isView<L> || isView<R>)>>
+MyDynMat<typename L::value_type> multiply(const L &, const R &, const MyExec::Context &);
+template <typename L, typename R, typename = std::enable_if_t<isMatrix<L> && isMatrix<R> && (isView<L> || isView<R>)>>
+MyDynMat<typename L::value_type> operator*(const L &, const R &);
+
+// Matrix x vector, a.cols() must equal x.size()
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> multiply(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x);
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> operator*(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x);
+
+// Comparison
+template <typename T, typename A, typename A2>
+bool operator==(const MyDynMat<T,A> &lhs, const MyDynMat<T,A2> &rhs);
+template <typename T, typename A, typename A2>
+bool operator!=(const MyDynMat<T,A> &lhs, const MyDynMat<T,A2> &rhs);
+
+// Render the matrix contents to the output stream
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &, const MyDynMat<T,A> &);
+
+} // namespace MyMatrix
+
+#include "mydynmat.tpp"
+// gemv, which the matrix x vector product runs on
+#include "myblas.h"
+
+#endif // MYDYNMAT_H
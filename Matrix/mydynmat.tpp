@@ -0,0 +1,404 @@
+//
+//  mydynmat.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+
+namespace MyMatrix {
+
+template <typename T, typename A>
+MyDynMat<T,A>::MyDynMat(const A &alloc) :
+    data_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynMat requires an arithmetic type");
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>::MyDynMat(size_t rows, size_t cols, const A &alloc) :
+    data_(rows * cols, T(), alloc),
+    rows_(rows),
+    cols_(cols)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynMat requires an arithmetic type");
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>::MyDynMat(size_t rows, size_t cols, std::initializer_list<T> li, const A &alloc) :
+    data_(rows * cols, T(), alloc),
+    rows_(rows),
+    cols_(cols)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynMat requires an arithmetic type");
+    size_t count = std::min(data_.size(), li.size());
+    std::copy_n(li.begin(), count, data_.begin());
+}
+
+template <typename T, typename A>
+template <size_t R, size_t C, Layout L>
+MyDynMat<T,A>::MyDynMat(const MyMat<T,R,C,L> &mat, const A &alloc) :
+    data_(alloc),
+    rows_(R),
+    cols_(C)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynMat requires an arithmetic type");
+    if constexpr (L == Layout::RowMajor) {
+        data_.assign(mat.cbegin(), mat.cend());
+    }
+    else {
+        data_.resize(R * C);
+        view() = mat.view();
+    }
+}
+
+namespace detail {
+
+template <typename A, typename E>
+A allocatorOf(const E &e)
+{
+    static_assert (std::is_convertible_v<decltype(e.get_allocator()), A>,
+                   "The expression has no allocator of this type, pass one to the constructor");
+    return e.get_allocator();
+}
+
+} // namespace detail
+
+template <typename T, typename A>
+template <typename E>
+MyDynMat<T,A>::MyDynMat(const MyExpr::Expression<E> &expr) :
+    data_(detail::allocatorOf<A>(expr.self()))
+{
+    *this = expr;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynMat<T,A>::MyDynMat(const MyExpr::Expression<E> &expr, const A &alloc) :
+    data_(alloc)
+{
+    *this = expr;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynMat<T,A>& MyDynMat<T,A>::operator=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (MyExpr::isAssignable<MyDynMat, E>, "Expression doesn't evaluate to this matrix type");
+    const E &e = expr.self();
+    if (detail::readsAcross(data(), size(), static_cast<ptrdiff_t>(e.cols()), 1, e)) {
+        // e reads this matrix in another order, as in m = m.transposed()
+        if constexpr (isView<E>) {
+            if (e.data() == data() && e.rows() == cols_ && e.cols() == rows_ &&
+                e.rowStride() == 1 && e.colStride() == static_cast<ptrdiff_t>(cols_)) {
+                return transpose();
+            }
+        }
+        MyDynMat result(data_.get_allocator());
+        result = expr;
+        return *this = std::move(result);
+    }
+    // Only resize when the shape changes: the destination may be one of the operands
+    if (data_.size() != e.size()) {
+        data_.resize(e.size());
+    }
+    rows_ = e.rows();
+    cols_ = e.cols();
+    if (detail::copyAcrossLayouts(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, e)) {
+        return *this;
+    }
+    detail::evalInto(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, Layout::RowMajor, true, e,
+                     [](T &d, const T &v) { d = v; });
+    return *this;
+}
+
+template <typename T, typename A>
+template <size_t R, size_t C>
+MyMat<T,R,C> MyDynMat<T,A>::toFixed() const
+{
+    assert(rows_ == R && cols_ == C);
+    MyMat<T,R,C> fixed;
+    std::copy_n(data_.cbegin(), R * C, fixed.begin());
+    return fixed;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A> MyDynMat<T,A>::copyTransposed() const
+{
+    MYSTATS_COUNT("copyTransposed", size(), 0, 2 * size() * sizeof(T));
+    MyDynMat copy(cols_, rows_, data_.get_allocator());
+    detail::transposeCopy<T>(rows_, cols_, data(), static_cast<ptrdiff_t>(cols_), copy.data(), static_cast<ptrdiff_t>(rows_));
+    return copy;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::toDiagonal()
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) {
+            if (i != j) {
+                (*this)(i,j) = 0;
+            }
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::toUpperTriangular()
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < std::min(i, cols_); ++j) {
+            (*this)(i,j) = 0;
+        }
+    }
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::toLowerTriangular()
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = i + 1; j < cols_; ++j) {
+            (*this)(i,j) = 0;
+        }
+    }
+    return *this;
+}
+
+// Unlike MyMat, the dimensions aren't part of the type, so a rectangular matrix can be
+// transposed in place too. That follows the cycles of the permutation, which saves the
+// copy but is slower than copyTransposed.
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::transpose()
+{
+    MYSTATS_COUNT("transpose", size(), 0, 2 * size() * sizeof(T));
+    detail::transposeCycles<T>(rows_, cols_, data());
+    std::swap(rows_, cols_);
+    return *this;
+}
+
+template <typename T, typename A>
+T& MyDynMat<T,A>::operator()(size_t row, size_t col)
+{
+    return data_[row * cols_ + col];
+}
+
+template <typename T, typename A>
+const T& MyDynMat<T,A>::operator()(size_t row, size_t col) const
+{
+    return data_[row * cols_ + col];
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::operator+=(const MyDynMat &rhs)
+{
+    assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    detail::evalInto(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, Layout::RowMajor, true, rhs,
+                     [](T &d, const T &v) { d += v; });
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::operator-=(const MyDynMat &rhs)
+{
+    assert(rows_ == rhs.rows_ && cols_ == rhs.cols_);
+    detail::evalInto(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, Layout::RowMajor, true, rhs,
+                     [](T &d, const T &v) { d -= v; });
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A>& MyDynMat<T,A>::operator*=(double rhs)
+{
+    MYSTATS_COUNT("scale", size(), size(), 2 * size() * sizeof(T));
+    T *d = data();
+    MyExec::parallelFor<T>(size(), 1, [d, rhs](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            d[k] *= rhs;
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynMat<T,A>& MyDynMat<T,A>::operator+=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (MyExpr::isAssignable<MyDynMat, E>, "Expression doesn't evaluate to this matrix type");
+    detail::checkShape<T>(expr, rows_, cols_);
+    detail::evalInto(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, Layout::RowMajor, true, expr.self(),
+                     [](T &d, const T &v) { d += v; });
+    return *this;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynMat<T,A>& MyDynMat<T,A>::operator-=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (MyExpr::isAssignable<MyDynMat, E>, "Expression doesn't evaluate to this matrix type");
+    detail::checkShape<T>(expr, rows_, cols_);
+    detail::evalInto(data(), rows_, cols_, static_cast<ptrdiff_t>(cols_), 1, Layout::RowMajor, true, expr.self(),
+                     [](T &d, const T &v) { d -= v; });
+    return *this;
+}
+
+template <typename T, typename A>
+std::ostream& MyDynMat<T,A>::renderToStream(std::ostream &os) const
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) {
+            os << (*this)(i,j) << " ";
+        }
+        os << "\n";
+    }
+
+    return os;
+}
+
+// Related non-members
+template <typename T>
+MyDynMat<T> makeIdentity(size_t n)
+{
+    assert(n > 0);
+    MyDynMat<T> id(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        id(i,i) = 1;
+    }
+    return id;
+}
+
+template <typename T>
+MyDynMat<T> makeUpperTriangular(size_t n)
+{
+    assert(n > 0);
+    MyDynMat<T> ut(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            ut(j,i) = 1;
+        }
+    }
+    return ut;
+}
+
+template <typename T>
+MyDynMat<T> makeLowerTriangular(size_t n)
+{
+    assert(n > 0);
+    MyDynMat<T> lt(n, n);
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = 0; j <= i; ++j) {
+            lt(i,j) = 1;
+        }
+    }
+    return lt;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A> multiply(const MyDynMat<T,A> &lhs, const MyDynMat<T,A> &rhs)
+{
+    assert(lhs.cols() == rhs.rows());
+    MYSTATS_COUNT("multiply", lhs.rows() * rhs.cols(), 2 * lhs.rows() * rhs.cols() * lhs.cols(),
+                  (lhs.size() + rhs.size() + lhs.rows() * rhs.cols()) * sizeof(T));
+    MyDynMat<T,A> result(lhs.rows(), rhs.cols(), lhs.get_allocator());
+    detail::gemm<T>(lhs.rows(), rhs.cols(), lhs.cols(), T(1),
+                    lhs.data(), static_cast<ptrdiff_t>(lhs.cols()), 1,
+                    rhs.data(), static_cast<ptrdiff_t>(rhs.cols()), 1,
+                    T(0), result.data(), static_cast<ptrdiff_t>(result.cols()), 1);
+    return result;
+}
+
+template <typename T, typename A>
+MyDynMat<T,A> multiply(const MyDynMat<T,A> &lhs, const MyDynMat<T,A> &rhs, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    return multiply(lhs, rhs);
+}
+
+template <typename T, typename A>
+MyDynMat<T,A> operator*(const MyDynMat<T,A> &lhs, const MyDynMat<T,A> &rhs)
+{
+    return multiply(lhs, rhs);
+}
+
+template <typename L, typename R, typename>
+MyDynMat<typename L::value_type> multiply(const L &lhs, const R &rhs)
+{
+    using T = typename L::value_type;
+    static_assert (std::is_same_v<T, typename R::value_type>, "Matrices must have the same value type");
+    assert(lhs.cols() == rhs.rows());
+    auto a = lhs.view();
+    auto b = rhs.view();
+    MYSTATS_COUNT("multiply", a.rows() * b.cols(), 2 * a.rows() * b.cols() * a.cols(),
+                  (a.size() + b.size() + a.rows() * b.cols()) * sizeof(T));
+    MyDynMat<T> result(a.rows(), b.cols());
+    detail::gemm<T>(a.rows(), b.cols(), a.cols(), T(1),
+                    a.data(), a.rowStride(), a.colStride(),
+                    b.data(), b.rowStride(), b.colStride(),
+                    T(0), result.data(), static_cast<ptrdiff_t>(result.cols()), 1);
+    return result;
+}
+
+template <typename L, typename R, typename>
+MyDynMat<typename L::value_type> multiply(const L &lhs, const R &rhs, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    return multiply(lhs, rhs);
+}
+
+template <typename L, typename R, typename>
+MyDynMat<typename L::value_type> operator*(const L &lhs, const R &rhs)
+{
+    return multiply(lhs, rhs);
+}
+
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> multiply(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x)
+{
+    MyVector::MyDynVec<T,A2> y(a.rows());
+    gemv(T(1), a, x, T(0), y);
+    return y;
+}
+
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> operator*(const MyDynMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x)
+{
+    return multiply(a, x);
+}
+
+template <typename T, typename A, typename A2>
+bool operator==(const MyDynMat<T,A> &lhs, const MyDynMat<T,A2> &rhs)
+{
+    if (lhs.rows() != rhs.rows() ||
+        lhs.cols() != rhs.cols()) {
+        return false;
+    }
+    MYSTATS_COUNT("compare", lhs.size(), lhs.size(), 2 * lhs.size() * sizeof(T));
+
+    if constexpr (std::is_integral_v<T>) {
+        return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+    }
+    else {
+        return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), [](const T &l, const T &r) {
+            return almost_equal(l, r, 2);
+        });
+    }
+}
+
+template <typename T, typename A, typename A2>
+bool operator!=(const MyDynMat<T,A> &lhs, const MyDynMat<T,A2> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &os, const MyDynMat<T,A> &m)
+{
+    return m.renderToStream(os);
+}
+
+} // namespace MyMatrix
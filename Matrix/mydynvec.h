@@ -0,0 +1,137 @@
+//
+//  mydynvec.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYDYNVEC_H
+#define MYDYNVEC_H
+
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include <initializer_list>
+#include "allocator.h"
+#include "myexec.h"
+#include "myvec.h"
+#include "mystats.h"
+
+/*!
+ * \brief A heap-backed vector whose number of components is chosen at run time
+ * \details MyDynVec is the run-time sized counterpart of MyVec, and supports the same
+ * operations. Storage comes from the Alloc template parameter, by default a 64-byte
+ * aligned allocator (see allocator.h). Moving a MyDynVec transfers the buffer without
+ * copying any element.
+ *
+ * \verbatim
+ * MyDynVec<> vec(1000);            // 1000-component vector, type double
+ * MyDynVec<int> vec{1, 2, 3};      // 3-component vector, type int
+ * MyDynVec<> vec(fixed);           // copy of a MyVec
+ * auto fixed = vec.toFixed<3>();   // back to a MyVec, sizes must match
+ * \endverbatim
+ *
+ * Operations between two MyDynVec require the same number of components, which is checked with assert.
+ * As with MyVec, element-wise arithmetic is lazy and evaluated in a single pass (see myexpr.h).
+ */
+namespace MyVector {
+
+template <typename T = double, typename Alloc = MyMemory::AlignedAllocator<T>>
+class MyDynVec : public MyExpr::Expression<MyDynVec<T,Alloc>> {
+public:
+    using value_type = T;
+    using result_type = MyDynVec;
+    using allocator_type = Alloc;
+
+    explicit MyDynVec(const Alloc &alloc = Alloc());
+    explicit MyDynVec(size_t n, const Alloc &alloc = Alloc());
+    MyDynVec(std::initializer_list<T>, const Alloc &alloc = Alloc());
+
+    template <typename Iter>
+    MyDynVec(Iter first, Iter last, const Alloc &alloc = Alloc());
+
+    template <size_t N>
+    explicit MyDynVec(const MyVec<T,N> &, const Alloc &alloc = Alloc());
+
+    template <typename E>
+    MyDynVec(const MyExpr::Expression<E> &);
+
+    ~MyDynVec() = default;
+
+    MyDynVec(const MyDynVec &) = default;
+    MyDynVec& operator=(const MyDynVec &) = default;
+
+    MyDynVec(MyDynVec &&) noexcept = default;
+    MyDynVec& operator=(MyDynVec &&) noexcept = default;
+
+    template <typename E>
+    MyDynVec& operator=(const MyExpr::Expression<E> &);
+
+    template <size_t N>
+    MyVec<T,N> toFixed() const;
+
+    MyDynVec& normalize();
+
+    auto begin() noexcept { return data_.begin(); }
+    auto begin() const noexcept { return data_.begin(); }
+    auto cbegin() const noexcept { return data_.cbegin(); }
+
+    auto end() noexcept { return data_.end(); }
+    auto end() const noexcept { return data_.end(); }
+    auto cend() const noexcept { return data_.cend(); }
+
+    T* data() noexcept { return data_.data(); }
+    const T* data() const noexcept { return data_.data(); }
+
+    size_t size() const noexcept { return data_.size(); }
+    bool empty() const noexcept { return data_.empty(); }
+
+    allocator_type get_allocator() const { return data_.get_allocator(); }
+
+          T& operator[](size_t i);
+    const T& operator[](size_t i) const;
+
+    MyDynVec& operator+=(const MyDynVec &);
+    MyDynVec& operator-=(const MyDynVec &);
+    MyDynVec& operator*=(double);
+
+    template <typename E>
+    MyDynVec& operator+=(const MyExpr::Expression<E> &);
+    template <typename E>
+    MyDynVec& operator-=(const MyExpr::Expression<E> &);
+
+private:
+    std::vector<T, Alloc> data_;
+};
+
+// Vector magnitude
+template <typename T, typename A>
+double magnitude(const MyDynVec<T,A> &);
+template <typename T, typename A>
+T magnitude2(const MyDynVec<T,A> &);
+
+template <typename T, typename A, typename T2, typename A2>
+double angle(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs);
+
+template <typename T, typename A, typename T2, typename A2>
+double dotProduct(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs);
+
+// Both vectors must have 2 or 3 components
+template <typename T, typename A, typename T2, typename A2>
+MyDynVec<T,A> crossProduct(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs);
+
+// Comparison operators
+template <typename T, typename A, typename T2, typename A2>
+bool operator==(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs);
+template <typename T, typename A, typename T2, typename A2>
+bool operator!=(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs);
+
+// Render the vector contents to the output stream
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &, const MyDynVec<T,A> &);
+
+} // namespace MyVector
+
+#include "mydynvec.tpp"
+
+#endif // MYDYNVEC_H
@@ -0,0 +1,287 @@
+//
+//  mydynvec.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+#include <cassert>
+#include <type_traits>
+
+namespace MyVector {
+
+template <typename T, typename A>
+MyDynVec<T,A>::MyDynVec(const A &alloc) :
+    data_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynVec requires an arithmetic type");
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>::MyDynVec(size_t n, const A &alloc) :
+    data_(n, T(), alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynVec requires an arithmetic type");
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>::MyDynVec(std::initializer_list<T> li, const A &alloc) :
+    data_(li, alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyDynVec requires an arithmetic type");
+}
+
+template <typename T, typename A>
+template <typename Iter>
+MyDynVec<T,A>::MyDynVec(Iter first, Iter last, const A &alloc) :
+    data_(first, last, alloc)
+{
+    static_assert (std::is_arithmetic_v<typename std::iterator_traits<Iter>::value_type>, "MyDynVec requires an arithmetic type");
+}
+
+template <typename T, typename A>
+template <size_t N>
+MyDynVec<T,A>::MyDynVec(const MyVec<T,N> &vec, const A &alloc) :
+    data_(vec.cbegin(), vec.cend(), alloc)
+{
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynVec<T,A>::MyDynVec(const MyExpr::Expression<E> &expr) :
+    data_(expr.self().get_allocator())
+{
+    *this = expr;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynVec<T,A>& MyDynVec<T,A>::operator=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyDynVec>, "Expression doesn't evaluate to this vector type");
+    const E &e = expr.self();
+    // Only resize when the size changes: the destination may be one of the operands
+    if (data_.size() != e.size()) {
+        data_.resize(e.size());
+    }
+    MYSTATS_COUNT("evaluate", e.size(), e.size() * MyExpr::Cost<E>::flops, e.size() * sizeof(T) * (MyExpr::Cost<E>::reads + 1));
+    T *dst = data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] = MyExpr::at(e, i);
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+template <size_t N>
+MyVec<T,N> MyDynVec<T,A>::toFixed() const
+{
+    assert(data_.size() == N);
+    return MyVec<T,N>(data_.cbegin(), data_.cend());
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>& MyDynVec<T,A>::normalize()
+{
+    double mag = magnitude(*this);
+    if (almost_equal(mag, 0.0, 2)) {
+        return *this;
+    }
+
+    double invMagnitude = 1 / mag;
+    *this *= invMagnitude;
+    return *this;
+}
+
+template <typename T, typename A>
+T& MyDynVec<T,A>::operator[](size_t i)
+{
+    return data_[i];
+}
+
+template <typename T, typename A>
+const T& MyDynVec<T,A>::operator[](size_t i) const
+{
+    return data_[i];
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>& MyDynVec<T,A>::operator+=(const MyDynVec &rhs)
+{
+    assert(data_.size() == rhs.data_.size());
+    MYSTATS_COUNT("add", size(), size(), 3 * size() * sizeof(T));
+    T *dst = data_.data();
+    const T *src = rhs.data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [dst, src](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] += src[i];
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>& MyDynVec<T,A>::operator-=(const MyDynVec &rhs)
+{
+    assert(data_.size() == rhs.data_.size());
+    MYSTATS_COUNT("subtract", size(), size(), 3 * size() * sizeof(T));
+    T *dst = data_.data();
+    const T *src = rhs.data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [dst, src](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] -= src[i];
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+MyDynVec<T,A>& MyDynVec<T,A>::operator*=(double rhs)
+{
+    MYSTATS_COUNT("scale", size(), size(), 2 * size() * sizeof(T));
+    T *dst = data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [dst, rhs](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] *= rhs;
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynVec<T,A>& MyDynVec<T,A>::operator+=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyDynVec>, "Expression doesn't evaluate to this vector type");
+    const E &e = expr.self();
+    assert(data_.size() == e.size());
+    MYSTATS_COUNT("add", size(), size() * (MyExpr::Cost<E>::flops + 1), size() * sizeof(T) * (MyExpr::Cost<E>::reads + 2));
+    T *dst = data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] += MyExpr::at(e, i);
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+template <typename E>
+MyDynVec<T,A>& MyDynVec<T,A>::operator-=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyDynVec>, "Expression doesn't evaluate to this vector type");
+    const E &e = expr.self();
+    assert(data_.size() == e.size());
+    MYSTATS_COUNT("subtract", size(), size() * (MyExpr::Cost<E>::flops + 1), size() * sizeof(T) * (MyExpr::Cost<E>::reads + 2));
+    T *dst = data_.data();
+    MyExec::parallelFor<T>(data_.size(), 1, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            dst[i] -= MyExpr::at(e, i);
+        }
+    });
+    return *this;
+}
+
+// Related non-members
+
+template <typename T, typename A>
+double magnitude(const MyDynVec<T,A> &vec)
+{
+    return std::sqrt(magnitude2(vec));
+}
+
+template <typename T, typename A>
+T magnitude2(const MyDynVec<T,A> &vec)
+{
+    MYSTATS_COUNT("magnitude", vec.size(), 2 * vec.size(), vec.size() * sizeof(T));
+    return std::accumulate(vec.cbegin(), vec.cend(), T(0), [](const T &sum, const T &el) {
+        return sum + el * el;
+    });
+}
+
+template <typename T, typename A, typename T2, typename A2>
+double angle(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs)
+{
+    double magLhs = magnitude(lhs);
+    double magRhs = magnitude(rhs);
+    if (almost_equal(magLhs, 0., 2) ||
+        almost_equal(magRhs, 0., 2)) {
+        return M_PI_2;
+    }
+
+    return std::acos( dotProduct(lhs, rhs) / (magLhs * magRhs));
+}
+
+template <typename T, typename A, typename T2, typename A2>
+double dotProduct(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs)
+{
+    assert(lhs.size() == rhs.size());
+    MYSTATS_COUNT("dotProduct", lhs.size(), 2 * lhs.size(), lhs.size() * (sizeof(T) + sizeof(T2)));
+    using Acc = detail::DotAccumulator<T,T2>;
+    Acc product = 0;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        product += static_cast<Acc>(lhs[i]) * static_cast<Acc>(rhs[i]);
+    }
+    return static_cast<double>(product);
+}
+
+template <typename T, typename A, typename T2, typename A2>
+MyDynVec<T,A> crossProduct(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs)
+{
+    assert(lhs.size() == 2 || lhs.size() == 3);
+    assert(rhs.size() == 2 || rhs.size() == 3);
+    T lz = lhs.size() == 3 ? lhs[2] : 0;
+    T rz = rhs.size() == 3 ? rhs[2] : 0;
+    MyDynVec<T,A> ret(3, lhs.get_allocator());
+    ret[0] = lhs[1] * rz - lz * rhs[1];
+    ret[1] = lz * rhs[0] - lhs[0] * rz;
+    ret[2] = lhs[0] * rhs[1] - lhs[1] * rhs[0];
+    return ret;
+}
+
+template <typename T, typename A, typename T2, typename A2>
+bool operator==(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs)
+{
+    if (lhs.size() != rhs.size()) {
+        return false;
+    }
+    MYSTATS_COUNT("compare", lhs.size(), lhs.size(), lhs.size() * (sizeof(T) + sizeof(T2)));
+    if constexpr (std::is_integral_v<T> || std::is_integral_v<T2>) {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+    else {
+        for (size_t i = 0; i < lhs.size(); ++i) {
+            if (!almost_equal(lhs[i], rhs[i], 2)) {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+template <typename T, typename A, typename T2, typename A2>
+bool operator!=(const MyDynVec<T,A> &lhs, const MyDynVec<T2,A2> &rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &os, const MyDynVec<T,A> &v)
+{
+    for (const auto & val : v) {
+        os << val << " ";
+    }
+    return os;
+}
+
+} // namespace MyVector
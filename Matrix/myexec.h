@@ -0,0 +1,154 @@
+//
+//  myexec.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYEXEC_H
+#define MYEXEC_H
+
+#include <cstddef>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*!
+ * \brief Multi-threaded execution of the large matrix and vector operations
+ * \details Element-wise arithmetic, scaling, transposition, matrix products and the
+ * decompositions split their work into cache-sized tiles, and run the tiles on a
+ * work-stealing ThreadPool when the operation is large enough. The calling thread
+ * always takes part, and waiting callers run queued tiles, so operations can be
+ * nested and called from the pool's own threads.
+ *
+ * How an operation runs is decided by the Context of the calling thread: its policy
+ * (serial or parallel), the pool (by default a shared pool with one thread per core,
+ * created on first use), the sizes below which an operation stays serial, and the
+ * tile size. The context is set for a scope, or passed to multiply directly:
+ *
+ * \verbatim
+ * MyExec::ScopedContext serial(MyExec::seq);  // everything on this thread, until the end of the scope
+ *
+ * MyExec::Context ctx;
+ * ctx.pool = &myPool;
+ * ctx.serialElements = 1 << 20;
+ * auto c = multiply(a, b, ctx);
+ * \endverbatim
+ *
+ * Fixed-size matrices and vectors smaller than minParallelElements never look at the
+ * context, so small MyMat and MyVec code pays nothing for it.
+ */
+namespace MyExec {
+
+// Operations on fewer elements are always serial, whatever the context says
+constexpr size_t minParallelElements = 4096;
+
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    // One thread per core, less the calling thread that takes part in every operation
+    static size_t defaultThreads();
+
+    explicit ThreadPool(size_t threads = defaultThreads());
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool& operator=(const ThreadPool &) = delete;
+
+    // Number of worker threads
+    size_t size() const noexcept { return workers_.size(); }
+
+    void submit(Task task);
+
+    // Run one queued task on the calling thread, false if there was none
+    bool runPending();
+
+    // The shared pool used by default, created on first use
+    static ThreadPool& instance();
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(size_t index);
+    bool take(size_t index, Task &task);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable wake_;
+    std::atomic<long> pending_{0};
+    std::atomic<size_t> next_{0};
+    bool stop_ = false;
+
+    // The pool and queue of the current thread, when it is a worker
+    static inline thread_local ThreadPool *self_ = nullptr;
+    static inline thread_local size_t index_ = 0;
+};
+
+enum class Policy {
+    Serial,     // run on the calling thread
+    Parallel    // spread large operations over a thread pool
+};
+
+struct Context {
+    Policy policy = Policy::Parallel;
+    ThreadPool *pool = nullptr;             // nullptr for the shared pool
+    size_t serialElements = 1 << 16;        // element-wise operations on fewer elements are serial
+    size_t serialMultiplyAdds = 1 << 21;    // products with fewer multiply-adds are serial
+    size_t tileBytes = 64 * 1024;           // data touched by one tile of an element-wise operation
+
+    // The pool to run an operation of the given size on, nullptr to run it serially
+    ThreadPool* poolFor(size_t work, size_t threshold) const;
+
+};
+
+inline constexpr Context seq{Policy::Serial};
+inline constexpr Context par{Policy::Parallel};
+
+// The context of the calling thread, par unless changed by a ScopedContext
+const Context& current();
+
+class ScopedContext {
+public:
+    explicit ScopedContext(const Context &);
+    ~ScopedContext();
+
+    ScopedContext(const ScopedContext &) = delete;
+    ScopedContext& operator=(const ScopedContext &) = delete;
+
+private:
+    Context previous_;
+};
+
+// Run f(t) for every t in [0, tiles), on the calling thread and on the workers of pool.
+// Tiles are handed out one at a time, so uneven tiles balance out. pool may be nullptr.
+// If f throws without a pool, the exception propagates right away. With a pool, the other
+// tiles still run, and the first exception is rethrown on the calling thread once they are
+// all done.
+template <typename F>
+void forEachTile(ThreadPool *pool, size_t tiles, F &&f);
+
+// Run f(begin, end) over [0, n), where each index stands for width elements of type T
+// (a row of a matrix, say). The ranges hold about tileBytes of elements, and run in
+// parallel when n * width reaches the serialElements threshold of the context.
+template <typename T, typename F>
+void parallelFor(size_t n, size_t width, F &&f);
+template <typename T, typename F>
+void parallelFor(size_t n, size_t width, F &&f, const Context &ctx);
+
+} // namespace MyExec
+
+#include "myexec.tpp"
+
+#endif // MYEXEC_H
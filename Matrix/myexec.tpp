@@ -0,0 +1,234 @@
+//
+//  myexec.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+namespace MyExec {
+
+inline size_t ThreadPool::defaultThreads()
+{
+    size_t cores = std::thread::hardware_concurrency();
+    return cores > 1 ? cores - 1 : 0;
+}
+
+inline ThreadPool::ThreadPool(size_t threads)
+{
+    queues_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    workers_.reserve(threads);
+    for (size_t i = 0; i < threads; ++i) {
+        workers_.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+inline void ThreadPool::submit(Task task)
+{
+    if (queues_.empty()) {
+        task();
+        return;
+    }
+
+    // Workers push to their own queue, where they will find the task first
+    size_t index = self_ == this ? index_ : next_++ % queues_.size();
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        ++pending_;
+    }
+    {
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+    }
+    wake_.notify_one();
+}
+
+inline bool ThreadPool::runPending()
+{
+    if (queues_.empty()) {
+        return false;
+    }
+    Task task;
+    if (!take(self_ == this ? index_ : 0, task)) {
+        return false;
+    }
+    task();
+    return true;
+}
+
+inline ThreadPool& ThreadPool::instance()
+{
+    static ThreadPool pool;
+    return pool;
+}
+
+// Newest task of the own queue first, then the oldest task of the others
+inline bool ThreadPool::take(size_t index, Task &task)
+{
+    size_t count = queues_.size();
+    for (size_t k = 0; k < count; ++k) {
+        Queue &q = *queues_[(index + k) % count];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (q.tasks.empty()) {
+            continue;
+        }
+        if (k == 0) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+        }
+        else {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+        }
+        --pending_;
+        return true;
+    }
+    return false;
+}
+
+inline void ThreadPool::workerLoop(size_t index)
+{
+    self_ = this;
+    index_ = index;
+    Task task;
+    for (;;) {
+        if (take(index, task)) {
+            task();
+            task = nullptr;
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        wake_.wait(lock, [this] { return stop_ || pending_ > 0; });
+        if (stop_ && pending_ <= 0) {
+            return;
+        }
+    }
+}
+
+inline ThreadPool* Context::poolFor(size_t work, size_t threshold) const
+{
+    if (policy == Policy::Serial || work < threshold) {
+        return nullptr;
+    }
+    ThreadPool *p = pool ? pool : &ThreadPool::instance();
+    return p->size() > 0 ? p : nullptr;
+}
+
+namespace detail {
+
+inline Context& currentContext()
+{
+    thread_local Context context;
+    return context;
+}
+
+} // namespace detail
+
+inline const Context& current()
+{
+    return detail::currentContext();
+}
+
+inline ScopedContext::ScopedContext(const Context &ctx) :
+    previous_(detail::currentContext())
+{
+    detail::currentContext() = ctx;
+}
+
+inline ScopedContext::~ScopedContext()
+{
+    detail::currentContext() = previous_;
+}
+
+template <typename F>
+void forEachTile(ThreadPool *pool, size_t tiles, F &&f)
+{
+    if (!pool || tiles < 2) {
+        for (size_t t = 0; t < tiles; ++t) {
+            f(t);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::atomic<size_t> finished{0};
+    // The first exception thrown by a tile, rethrown on the calling thread once every
+    // tile is done, as the helpers must neither throw on the workers nor outlive this frame
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto work = [&] {
+        for (size_t t = next++; t < tiles; t = next++) {
+            try {
+                f(t);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+    };
+
+    size_t helpers = std::min(pool->size(), tiles - 1);
+    for (size_t h = 0; h < helpers; ++h) {
+        pool->submit([&work, &finished] {
+            work();
+            finished.fetch_add(1, std::memory_order_release);
+        });
+    }
+    work();
+
+    // The helpers reference this frame, wait for all of them, running queued tasks meanwhile
+    while (finished.load(std::memory_order_acquire) < helpers) {
+        if (!pool->runPending()) {
+            std::this_thread::yield();
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+template <typename T, typename F>
+void parallelFor(size_t n, size_t width, F &&f)
+{
+    // Small operations don't pay for looking up the context
+    if (n * width < minParallelElements) {
+        f(size_t(0), n);
+        return;
+    }
+    parallelFor<T>(n, width, std::forward<F>(f), current());
+}
+
+template <typename T, typename F>
+void parallelFor(size_t n, size_t width, F &&f, const Context &ctx)
+{
+    size_t elements = n * width;
+    ThreadPool *pool = elements >= minParallelElements ? ctx.poolFor(elements, ctx.serialElements) : nullptr;
+    if (!pool) {
+        f(size_t(0), n);
+        return;
+    }
+    size_t grain = std::max<size_t>(1, ctx.tileBytes / (sizeof(T) * std::max<size_t>(width, 1)));
+    size_t tiles = (n + grain - 1) / grain;
+    forEachTile(pool, tiles, [&](size_t t) {
+        f(t * grain, std::min(n, (t + 1) * grain));
+    });
+}
+
+} // namespace MyExec
@@ -0,0 +1,270 @@
+//
+//  myexpr.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYEXPR_H
+#define MYEXPR_H
+
+#include <iostream>
+#include <cassert>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+/*!
+ * \brief Lazy element-wise arithmetic for the matrix and vector containers
+ * \details Adding, subtracting or scaling containers (MyMat, MyVec, MyDynMat, MyDynVec)
+ * doesn't compute anything by itself. Instead it builds a small expression object that
+ * records the operation and its operands. The work is done when the expression is
+ * assigned to a container, in a single loop over the elements, so that
+ *
+ * \verbatim
+ * MyMat<> r = a + b - 2 * c;
+ * \endverbatim
+ *
+ * reads a, b and c once and writes r once, without any temporary matrix. Use eval()
+ * to force an expression into a container, e.g. to pass it to a function that takes
+ * a container, or to compare it with operator==.
+ *
+ * Operands that are named containers are held by reference, so an expression must not
+ * outlive them. Temporary containers are moved into the expression. All operands of an
+ * expression must have the same container type, and the same dimensions. Matrix views
+ * (see myview.h) combine with any matrix of the same value type; an expression made of
+ * views only evaluates to a MyDynMat.
+ *
+ * Every container and expression node derives from Expression<Derived>, which is also
+ * what makes the operators below visible to argument-dependent lookup.
+ *
+ * The nodes and operators are constexpr, so expressions of fixed size containers can
+ * be evaluated at compile time.
+ */
+namespace MyExpr {
+
+template <typename E>
+struct Expression {
+    constexpr const E& self() const { return static_cast<const E&>(*this); }
+};
+
+// Base of the expression nodes, as opposed to the containers which are the leaves
+struct Node {};
+
+template <typename E>
+constexpr bool isExpression = std::is_base_of_v<Expression<std::decay_t<E>>, std::decay_t<E>>;
+
+template <typename E>
+constexpr bool isNode = std::is_base_of_v<Node, std::decay_t<E>>;
+
+// Named containers are referenced, temporaries and nodes are stored by value
+template <typename E>
+using Operand = std::conditional_t<std::is_lvalue_reference_v<E> && !isNode<E>,
+                                   const std::decay_t<E>&, std::decay_t<E>>;
+
+template <typename E>
+using ResultOf = typename std::decay_t<E>::result_type;
+
+// True for views, and expressions of views only, whose result type is just a default
+template <typename E, typename = void>
+struct HasViewResult : std::false_type {};
+template <typename E>
+struct HasViewResult<E, std::void_t<decltype(E::viewResult)>> : std::bool_constant<E::viewResult> {};
+template <typename E>
+constexpr bool isViewResult = HasViewResult<std::decay_t<E>>::value;
+
+// The type an expression of L and R evaluates to: a view defers to the other operand
+template <typename L, typename R>
+using CommonResult = std::conditional_t<isViewResult<L>, ResultOf<R>, ResultOf<L>>;
+
+template <typename L, typename R>
+constexpr bool isCompatible = (isViewResult<L> || isViewResult<R>)
+    ? std::is_same_v<typename ResultOf<L>::value_type, typename ResultOf<R>::value_type>
+    : std::is_same_v<ResultOf<L>, ResultOf<R>>;
+
+// Whether an expression may be assigned to a container of type Dest
+template <typename Dest, typename E>
+constexpr bool isAssignable = std::is_same_v<ResultOf<E>, Dest> ||
+    (isViewResult<E> && std::is_same_v<typename ResultOf<E>::value_type, typename Dest::value_type>);
+
+// Element i of a node or a container, in storage order
+template <typename E>
+constexpr decltype(auto) at(const E &e, size_t i)
+{
+    if constexpr (isNode<E>) {
+        return e[i];
+    }
+    else {
+        return e.data()[i];
+    }
+}
+
+// Element (i,j) of a matrix node or container
+template <typename E>
+constexpr decltype(auto) at(const E &e, size_t i, size_t j)
+{
+    return e(i, j);
+}
+
+template <typename Op, typename L, typename R>
+class BinaryExpr : public Expression<BinaryExpr<Op,L,R>>, public Node {
+public:
+    using result_type = CommonResult<L,R>;
+    using value_type = typename result_type::value_type;
+    static constexpr bool viewResult = isViewResult<L> && isViewResult<R>;
+
+    template <typename LArg, typename RArg>
+    constexpr BinaryExpr(LArg &&lhs, RArg &&rhs) :
+        lhs_(std::forward<LArg>(lhs)),
+        rhs_(std::forward<RArg>(rhs))
+    {
+        assert(lhs_.size() == rhs_.size());
+    }
+
+    constexpr value_type operator[](size_t i) const { return Op()(at(lhs_, i), at(rhs_, i)); }
+    constexpr value_type operator()(size_t i, size_t j) const { return Op()(at(lhs_, i, j), at(rhs_, i, j)); }
+
+    constexpr size_t size() const { return lhs_.size(); }
+    constexpr size_t rows() const { return lhs_.rows(); }
+    constexpr size_t cols() const { return lhs_.cols(); }
+
+    // Whether element i of every operand is at index i of its storage, in the given order
+    template <typename Layout>
+    constexpr bool isContiguous(Layout order) const { return lhs_.isContiguous(order) && rhs_.isContiguous(order); }
+
+    auto get_allocator() const
+    {
+        if constexpr (isViewResult<L>) {
+            return rhs_.get_allocator();
+        }
+        else {
+            return lhs_.get_allocator();
+        }
+    }
+
+    result_type eval() const { return result_type(*this); }
+
+    constexpr const auto& lhs() const { return lhs_; }
+    constexpr const auto& rhs() const { return rhs_; }
+
+private:
+    L lhs_;
+    R rhs_;
+};
+
+template <typename Op, typename E>
+class ScalarExpr : public Expression<ScalarExpr<Op,E>>, public Node {
+public:
+    using result_type = ResultOf<E>;
+    using value_type = typename result_type::value_type;
+    static constexpr bool viewResult = isViewResult<E>;
+
+    template <typename Arg>
+    constexpr ScalarExpr(Arg &&expr, double scalar) :
+        expr_(std::forward<Arg>(expr)),
+        scalar_(scalar)
+    {
+    }
+
+    constexpr value_type operator[](size_t i) const { return static_cast<value_type>(Op()(at(expr_, i), scalar_)); }
+    constexpr value_type operator()(size_t i, size_t j) const { return static_cast<value_type>(Op()(at(expr_, i, j), scalar_)); }
+
+    constexpr size_t size() const { return expr_.size(); }
+    constexpr size_t rows() const { return expr_.rows(); }
+    constexpr size_t cols() const { return expr_.cols(); }
+
+    template <typename Layout>
+    constexpr bool isContiguous(Layout order) const { return expr_.isContiguous(order); }
+
+    auto get_allocator() const { return expr_.get_allocator(); }
+
+    result_type eval() const { return result_type(*this); }
+
+    constexpr const auto& operand() const { return expr_; }
+
+private:
+    E expr_;
+    double scalar_;
+};
+
+struct Scale {
+    template <typename T>
+    constexpr auto operator()(const T &v, double s) const { return s * v; }
+};
+
+struct Divide {
+    template <typename T>
+    constexpr auto operator()(const T &v, double s) const { return v / s; }
+};
+
+// Arithmetic operations per element of an expression, and the containers it reads
+template <typename E>
+struct Cost {
+    static constexpr size_t flops = 0;
+    static constexpr size_t reads = 1;
+};
+template <typename Op, typename L, typename R>
+struct Cost<BinaryExpr<Op,L,R>> {
+    static constexpr size_t flops = 1 + Cost<std::decay_t<L>>::flops + Cost<std::decay_t<R>>::flops;
+    static constexpr size_t reads = Cost<std::decay_t<L>>::reads + Cost<std::decay_t<R>>::reads;
+};
+template <typename Op, typename E>
+struct Cost<ScalarExpr<Op,E>> {
+    static constexpr size_t flops = 1 + Cost<std::decay_t<E>>::flops;
+    static constexpr size_t reads = Cost<std::decay_t<E>>::reads;
+};
+
+template <typename L, typename R>
+using EnableBinary = std::enable_if_t<isExpression<L> && isExpression<R>>;
+
+template <typename E>
+using EnableUnary = std::enable_if_t<isExpression<E>>;
+
+template <typename L, typename R, typename = EnableBinary<L,R>>
+constexpr auto operator+(L &&lhs, R &&rhs)
+{
+    static_assert (isCompatible<L,R>, "Operands must have the same type");
+    return BinaryExpr<std::plus<>, Operand<L>, Operand<R>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename L, typename R, typename = EnableBinary<L,R>>
+constexpr auto operator-(L &&lhs, R &&rhs)
+{
+    static_assert (isCompatible<L,R>, "Operands must have the same type");
+    return BinaryExpr<std::minus<>, Operand<L>, Operand<R>>(std::forward<L>(lhs), std::forward<R>(rhs));
+}
+
+template <typename E, typename = EnableUnary<E>>
+constexpr auto operator*(double scalar, E &&expr)
+{
+    return ScalarExpr<Scale, Operand<E>>(std::forward<E>(expr), scalar);
+}
+
+template <typename E, typename = EnableUnary<E>>
+constexpr auto operator*(E &&expr, double scalar)
+{
+    return ScalarExpr<Scale, Operand<E>>(std::forward<E>(expr), scalar);
+}
+
+template <typename E, typename = EnableUnary<E>>
+constexpr auto operator/(E &&expr, double scalar)
+{
+    return ScalarExpr<Divide, Operand<E>>(std::forward<E>(expr), scalar);
+}
+
+// Materialize an expression into its container type
+template <typename E>
+ResultOf<E> eval(const Expression<E> &expr)
+{
+    return ResultOf<E>(expr);
+}
+
+template <typename E, typename = std::enable_if_t<isNode<E>>>
+std::ostream& operator<<(std::ostream &os, const E &expr)
+{
+    return os << expr.eval();
+}
+
+} // namespace MyExpr
+
+#endif // MYEXPR_H
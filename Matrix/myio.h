@@ -0,0 +1,191 @@
+//
+//  myio.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYIO_H
+#define MYIO_H
+
+#include <iostream>
+#include <cstdint>
+#include <string>
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myview.h"
+#include "myvecbatch.h"
+#include "mystats.h"
+
+/*!
+ * \brief Binary files of matrices and vector batches, and read-only memory mapping
+ * \details writeBinary saves a matrix, a view or a MyVecBatch to a stream or a file,
+ * readBinary loads it back into a container, and MyMappedMat maps a file into memory
+ * and uses its elements in place:
+ *
+ * \verbatim
+ * writeBinary("weights.bin", a);
+ * MyDynMat<> b;
+ * readBinary("weights.bin", b);
+ * MyMappedMat<double> c("weights.bin");
+ * if (c) {
+ *     MyDynMat<> d = c.view() * x;   // reads the file pages as needed
+ * }
+ * \endverbatim
+ *
+ * A file is a 64 byte BinaryHeader, that records the dimensions, the element type and
+ * the layout, followed by the elements in that layout with no padding. The elements
+ * start 64 bytes into the file, so that a mapped file is aligned for the vector
+ * instructions. They are in the byte order of the machine that wrote them; a file
+ * from a machine with the other byte order is rejected.
+ *
+ * A matrix is written in its storage order, or for a view the order of its smallest
+ * stride. Densely stored elements are written straight from memory, other views are
+ * gathered through a buffer of binaryChunkBytes, so memory use doesn't grow with the
+ * matrix. A reader transposes a file of the other layout on the fly. A MyVecBatch of
+ * count vectors of N components is stored as a count x N column-major matrix, one
+ * column per component, and can also be read or mapped as a matrix.
+ *
+ * The functions return false when the stream fails, or when the file holds another
+ * element type, or other dimensions than those of a MyMat. Dimensions too large to
+ * allocate, or larger than what is left of a seekable stream, are rejected before any
+ * memory is allocated. A MyMappedMat that can't map its file is empty, and tests false.
+ */
+namespace MyMatrix {
+
+// Size of the buffer used to gather or scatter elements that aren't densely stored
+constexpr size_t binaryChunkBytes = 1 << 20;
+
+// Element types of the binary format
+enum class ElementType : uint8_t {
+    Int8 = 1,
+    UInt8,
+    Int16,
+    UInt16,
+    Int32,
+    UInt32,
+    Int64,
+    UInt64,
+    Float,
+    Double
+};
+
+template <typename T>
+constexpr ElementType elementTypeOf();
+
+// The first 64 bytes of a file
+struct BinaryHeader {
+    static constexpr char signature[8] = {'M', 'Y', 'M', 'A', 'T', 'R', 'I', 'X'};
+    static constexpr uint32_t nativeByteOrder = 0x01020304;
+    static constexpr uint16_t currentVersion = 1;
+
+    char magic[8];
+    uint32_t byteOrder;
+    uint16_t version;
+    ElementType type;
+    uint8_t elementSize;
+    uint8_t layout;         // a Layout
+    uint8_t reserved0[7];
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t dataOffset;    // of the first element, from the start of the file
+    uint8_t reserved1[16];
+};
+
+static_assert (sizeof(BinaryHeader) == 64, "The binary header must be 64 bytes");
+
+// Write a matrix or a view
+template <typename M, typename = std::enable_if_t<isMatrix<M>>>
+bool writeBinary(std::ostream &, const M &);
+template <typename M, typename = std::enable_if_t<isMatrix<M>>>
+bool writeBinary(const std::string &path, const M &);
+
+template <typename T, size_t N, typename A>
+bool writeBinary(std::ostream &, const MyVector::MyVecBatch<T,N,A> &);
+template <typename T, size_t N, typename A>
+bool writeBinary(const std::string &path, const MyVector::MyVecBatch<T,N,A> &);
+
+// Read into a container, a MyMat must have the dimensions of the file
+template <typename T, size_t R, size_t C, Layout L>
+bool readBinary(std::istream &, MyMat<T,R,C,L> &);
+template <typename T, size_t R, size_t C, Layout L>
+bool readBinary(const std::string &path, MyMat<T,R,C,L> &);
+
+template <typename T, typename A>
+bool readBinary(std::istream &, MyDynMat<T,A> &);
+template <typename T, typename A>
+bool readBinary(const std::string &path, MyDynMat<T,A> &);
+
+// The file must have N columns, one per component
+template <typename T, size_t N, typename A>
+bool readBinary(std::istream &, MyVector::MyVecBatch<T,N,A> &);
+template <typename T, size_t N, typename A>
+bool readBinary(const std::string &path, MyVector::MyVecBatch<T,N,A> &);
+
+// A whole file mapped read-only into memory
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::string &path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile& operator=(const MappedFile &) = delete;
+
+    MappedFile(MappedFile &&) noexcept;
+    MappedFile& operator=(MappedFile &&) noexcept;
+
+    bool isOpen() const noexcept { return data_ != nullptr; }
+    const unsigned char* data() const noexcept { return data_; }
+    size_t size() const noexcept { return size_; }
+
+    void close() noexcept;
+
+private:
+    const unsigned char *data_ = nullptr;
+    size_t size_ = 0;
+};
+
+/*!
+ * \brief A read-only matrix over the elements of a mapped binary file
+ * \details Nothing is read when the file is opened beyond the header: the elements are
+ * paged in by the operating system as they are used. view() gives a MyMatView that
+ * combines with the other matrices in expressions and products.
+ */
+template <typename T = double>
+class MyMappedMat {
+public:
+    using value_type = T;
+
+    MyMappedMat() = default;
+    // Empty when the file can't be mapped, or isn't a binary file of T
+    explicit MyMappedMat(const std::string &path);
+
+    bool isOpen() const noexcept { return data_ != nullptr; }
+    explicit operator bool() const noexcept { return isOpen(); }
+
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    size_t size() const noexcept { return rows_ * cols_; }
+    Layout layout() const noexcept { return layout_; }
+
+    const T* data() const noexcept { return data_; }
+    const T& operator()(size_t row, size_t col) const;
+
+    MyMatView<const T> view() const noexcept;
+    MyMatView<const T> transposed() const noexcept { return view().transposed(); }
+
+private:
+    MappedFile file_;
+    const T *data_ = nullptr;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    Layout layout_ = Layout::RowMajor;
+};
+
+} // namespace MyMatrix
+
+#include "myio.tpp"
+
+#endif // MYIO_H
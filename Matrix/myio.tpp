@@ -0,0 +1,498 @@
+//
+//  myio.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace MyMatrix {
+
+template <typename T>
+constexpr ElementType elementTypeOf()
+{
+    static_assert (std::is_arithmetic_v<T> && !std::is_same_v<T, bool> && !std::is_same_v<T, long double>,
+                   "The binary format stores integers, float and double");
+    if constexpr (std::is_floating_point_v<T>) {
+        return sizeof(T) == 4 ? ElementType::Float : ElementType::Double;
+    }
+    else if constexpr (sizeof(T) == 1) {
+        return std::is_signed_v<T> ? ElementType::Int8 : ElementType::UInt8;
+    }
+    else if constexpr (sizeof(T) == 2) {
+        return std::is_signed_v<T> ? ElementType::Int16 : ElementType::UInt16;
+    }
+    else if constexpr (sizeof(T) == 4) {
+        return std::is_signed_v<T> ? ElementType::Int32 : ElementType::UInt32;
+    }
+    else {
+        return std::is_signed_v<T> ? ElementType::Int64 : ElementType::UInt64;
+    }
+}
+
+namespace detail {
+
+template <typename T>
+BinaryHeader makeHeader(size_t rows, size_t cols, Layout layout)
+{
+    BinaryHeader header = {};
+    std::memcpy(header.magic, BinaryHeader::signature, sizeof(header.magic));
+    header.byteOrder = BinaryHeader::nativeByteOrder;
+    header.version = BinaryHeader::currentVersion;
+    header.type = elementTypeOf<T>();
+    header.elementSize = sizeof(T);
+    header.layout = static_cast<uint8_t>(layout);
+    header.rows = rows;
+    header.cols = cols;
+    header.dataOffset = sizeof(BinaryHeader);
+    return header;
+}
+
+// Whether a header describes a file of T that this version can read
+template <typename T>
+bool checkHeader(const BinaryHeader &header)
+{
+    return std::memcmp(header.magic, BinaryHeader::signature, sizeof(header.magic)) == 0 &&
+           header.byteOrder == BinaryHeader::nativeByteOrder &&
+           header.version == BinaryHeader::currentVersion &&
+           header.type == elementTypeOf<T>() &&
+           header.elementSize == sizeof(T) &&
+           header.layout <= static_cast<uint8_t>(Layout::ColMajor) &&
+           header.dataOffset >= sizeof(BinaryHeader) &&
+           header.dataOffset <= static_cast<uint64_t>(std::numeric_limits<std::streamsize>::max()) &&
+           header.dataOffset % alignof(T) == 0;
+}
+
+// Traversal of a view in a given order: outer lines of inner elements
+template <typename T>
+struct Lines {
+    size_t outer;
+    size_t inner;
+    ptrdiff_t outerStride;
+    ptrdiff_t innerStride;
+
+    Lines(MyMatView<T> v, Layout order) :
+        outer(order == Layout::RowMajor ? v.rows() : v.cols()),
+        inner(order == Layout::RowMajor ? v.cols() : v.rows()),
+        outerStride(order == Layout::RowMajor ? v.rowStride() : v.colStride()),
+        innerStride(order == Layout::RowMajor ? v.colStride() : v.rowStride())
+    {
+    }
+};
+
+template <typename T>
+bool writeChunked(std::ostream &os, const T *data, size_t count)
+{
+    constexpr size_t chunk = std::max<size_t>(1, binaryChunkBytes / sizeof(T));
+    for (size_t k = 0; k < count && os; k += chunk) {
+        size_t n = std::min(chunk, count - k);
+        os.write(reinterpret_cast<const char*>(data + k), static_cast<std::streamsize>(n * sizeof(T)));
+    }
+    return static_cast<bool>(os);
+}
+
+template <typename T>
+bool readChunked(std::istream &is, T *data, size_t count)
+{
+    constexpr size_t chunk = std::max<size_t>(1, binaryChunkBytes / sizeof(T));
+    for (size_t k = 0; k < count && is; k += chunk) {
+        size_t n = std::min(chunk, count - k);
+        is.read(reinterpret_cast<char*>(data + k), static_cast<std::streamsize>(n * sizeof(T)));
+    }
+    return static_cast<bool>(is);
+}
+
+// Write a header and the elements of v, in the order of its smallest stride
+template <typename T>
+bool writeView(std::ostream &os, MyMatView<const T> v)
+{
+    MYSTATS_SCOPE("writeBinary", v.size(), 0, v.size() * sizeof(T));
+    const Layout order = naturalOrder(v.rowStride(), v.colStride());
+    const BinaryHeader header = makeHeader<T>(v.rows(), v.cols(), order);
+    os.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    if (!os || v.rows() == 0 || v.cols() == 0) {
+        return static_cast<bool>(os);
+    }
+    const Lines<const T> lines(v, order);
+    if (v.isContiguous(order)) {
+        return writeChunked(os, v.data(), lines.outer * lines.inner);
+    }
+    if (lines.innerStride == 1) {
+        for (size_t l = 0; l < lines.outer && os; ++l) {
+            writeChunked(os, v.data() + static_cast<ptrdiff_t>(l) * lines.outerStride, lines.inner);
+        }
+        return static_cast<bool>(os);
+    }
+    std::vector<T> chunk(std::min(std::max<size_t>(1, binaryChunkBytes / sizeof(T)), lines.outer * lines.inner));
+    size_t n = 0;
+    for (size_t l = 0; l < lines.outer && os; ++l) {
+        const T *line = v.data() + static_cast<ptrdiff_t>(l) * lines.outerStride;
+        for (size_t k = 0; k < lines.inner; ++k) {
+            chunk[n++] = line[static_cast<ptrdiff_t>(k) * lines.innerStride];
+            if (n == chunk.size()) {
+                writeChunked(os, chunk.data(), n);
+                n = 0;
+            }
+        }
+    }
+    return writeChunked(os, chunk.data(), n);
+}
+
+// Bytes left to read in is, or -1 when the stream can't seek to tell. On failure the
+// stream is left failed.
+inline std::streamoff bytesLeft(std::istream &is)
+{
+    const std::istream::pos_type here = is.tellg();
+    if (here == std::istream::pos_type(-1)) {
+        return -1;
+    }
+    is.seekg(0, std::ios::end);
+    const std::istream::pos_type end = is.tellg();
+    is.seekg(here);
+    if (end == std::istream::pos_type(-1) || end < here) {
+        is.setstate(std::ios::failbit);
+        return 0;
+    }
+    return end - here;
+}
+
+// Read and check a header, and move to the first element, which must be in the stream
+template <typename T>
+bool readHeader(std::istream &is, BinaryHeader &header)
+{
+    if (!is.read(reinterpret_cast<char*>(&header), sizeof(header)) || !checkHeader<T>(header)) {
+        return false;
+    }
+    const auto skip = static_cast<std::streamsize>(header.dataOffset - sizeof(header));
+    const std::streamoff left = bytesLeft(is);
+    if (left < 0) {
+        // Not seekable, skip by reading
+        is.ignore(skip);
+        return is && is.gcount() == skip;
+    }
+    if (!is || left < skip) {
+        return false;
+    }
+    is.seekg(skip, std::ios::cur);
+    return static_cast<bool>(is);
+}
+
+// Whether the rows x cols elements described by header can be allocated, and, when the
+// stream can tell its size, are all left to read. A corrupt or hostile header must not
+// lead to an overflowing size or an allocation of more memory than the file holds.
+template <typename T>
+bool checkExtent(std::istream &is, const BinaryHeader &header)
+{
+    constexpr uint64_t maxElements = std::numeric_limits<ptrdiff_t>::max() / sizeof(T);
+    if (header.rows > maxElements || (header.cols != 0 && header.rows > maxElements / header.cols)) {
+        return false;
+    }
+    const uint64_t bytes = header.rows * header.cols * sizeof(T);
+    const std::streamoff left = bytesLeft(is);
+    if (left < 0) {
+        // Not seekable, the size is unknown
+        return static_cast<bool>(is);
+    }
+    return static_cast<bool>(is) && static_cast<uint64_t>(left) >= bytes;
+}
+
+// Read the elements described by header into v, which has the same dimensions
+template <typename T>
+bool readView(std::istream &is, const BinaryHeader &header, MyMatView<T> v)
+{
+    MYSTATS_SCOPE("readBinary", v.size(), 0, v.size() * sizeof(T));
+    if (v.rows() == 0 || v.cols() == 0) {
+        return true;
+    }
+    const Layout order = static_cast<Layout>(header.layout);
+    const Lines<T> lines(v, order);
+    if (v.isContiguous(order)) {
+        return readChunked(is, v.data(), lines.outer * lines.inner);
+    }
+    if (lines.innerStride == 1) {
+        for (size_t l = 0; l < lines.outer && is; ++l) {
+            readChunked(is, v.data() + static_cast<ptrdiff_t>(l) * lines.outerStride, lines.inner);
+        }
+        return static_cast<bool>(is);
+    }
+    const size_t total = lines.outer * lines.inner;
+    std::vector<T> chunk(std::min(std::max<size_t>(1, binaryChunkBytes / sizeof(T)), total));
+    size_t n = chunk.size();
+    size_t read = 0;
+    for (size_t l = 0; l < lines.outer; ++l) {
+        T *line = v.data() + static_cast<ptrdiff_t>(l) * lines.outerStride;
+        for (size_t k = 0; k < lines.inner; ++k) {
+            if (n == chunk.size()) {
+                const size_t count = std::min(chunk.size(), total - read);
+                if (!readChunked(is, chunk.data(), count)) {
+                    return false;
+                }
+                read += count;
+                n = 0;
+            }
+            line[static_cast<ptrdiff_t>(k) * lines.innerStride] = chunk[n++];
+        }
+    }
+    return true;
+}
+
+// The storage of a batch as a count x N matrix, one column per component
+template <typename T, size_t N, typename A>
+MyMatView<T> batchView(MyVector::MyVecBatch<T,N,A> &batch)
+{
+    ptrdiff_t laneStride = N > 1 ? batch.lane(1) - batch.lane(0) : static_cast<ptrdiff_t>(batch.size());
+    return MyMatView<T>(batch.lane(0), batch.size(), N, 1, laneStride);
+}
+
+template <typename T, size_t N, typename A>
+MyMatView<const T> batchView(const MyVector::MyVecBatch<T,N,A> &batch)
+{
+    ptrdiff_t laneStride = N > 1 ? batch.lane(1) - batch.lane(0) : static_cast<ptrdiff_t>(batch.size());
+    return MyMatView<const T>(batch.lane(0), batch.size(), N, 1, laneStride);
+}
+
+} // namespace detail
+
+template <typename M, typename>
+bool writeBinary(std::ostream &os, const M &m)
+{
+    using T = std::remove_const_t<typename M::value_type>;
+    return detail::writeView<T>(os, m.view());
+}
+
+template <typename M, typename>
+bool writeBinary(const std::string &path, const M &m)
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    return writeBinary(os, m) && os.flush();
+}
+
+template <typename T, size_t N, typename A>
+bool writeBinary(std::ostream &os, const MyVector::MyVecBatch<T,N,A> &batch)
+{
+    return detail::writeView<T>(os, detail::batchView(batch));
+}
+
+template <typename T, size_t N, typename A>
+bool writeBinary(const std::string &path, const MyVector::MyVecBatch<T,N,A> &batch)
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    return writeBinary(os, batch) && os.flush();
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+bool readBinary(std::istream &is, MyMat<T,R,C,L> &m)
+{
+    BinaryHeader header;
+    if (!detail::readHeader<T>(is, header) || header.rows != R || header.cols != C) {
+        return false;
+    }
+    return detail::readView(is, header, m.view());
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+bool readBinary(const std::string &path, MyMat<T,R,C,L> &m)
+{
+    std::ifstream is(path, std::ios::binary);
+    return readBinary(is, m);
+}
+
+template <typename T, typename A>
+bool readBinary(std::istream &is, MyDynMat<T,A> &m)
+{
+    BinaryHeader header;
+    if (!detail::readHeader<T>(is, header) || !detail::checkExtent<T>(is, header)) {
+        return false;
+    }
+    MyDynMat<T,A> read(header.rows, header.cols, m.get_allocator());
+    if (!detail::readView(is, header, read.view())) {
+        return false;
+    }
+    m = std::move(read);
+    return true;
+}
+
+template <typename T, typename A>
+bool readBinary(const std::string &path, MyDynMat<T,A> &m)
+{
+    std::ifstream is(path, std::ios::binary);
+    return readBinary(is, m);
+}
+
+template <typename T, size_t N, typename A>
+bool readBinary(std::istream &is, MyVector::MyVecBatch<T,N,A> &batch)
+{
+    BinaryHeader header;
+    if (!detail::readHeader<T>(is, header) || header.cols != N || !detail::checkExtent<T>(is, header)) {
+        return false;
+    }
+    MyVector::MyVecBatch<T,N,A> read(header.rows, batch.get_allocator());
+    if (!detail::readView(is, header, detail::batchView(read))) {
+        return false;
+    }
+    batch = std::move(read);
+    return true;
+}
+
+template <typename T, size_t N, typename A>
+bool readBinary(const std::string &path, MyVector::MyVecBatch<T,N,A> &batch)
+{
+    std::ifstream is(path, std::ios::binary);
+    return readBinary(is, batch);
+}
+
+// MappedFile
+
+#if defined(_WIN32)
+
+inline MappedFile::MappedFile(const std::string &path)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0) {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping != nullptr) {
+            // The view keeps the mapping alive
+            void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            if (view != nullptr) {
+                data_ = static_cast<const unsigned char*>(view);
+                size_ = static_cast<size_t>(size.QuadPart);
+            }
+            CloseHandle(mapping);
+        }
+    }
+    CloseHandle(file);
+}
+
+inline void MappedFile::close() noexcept
+{
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+inline MappedFile::MappedFile(const std::string &path)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat st;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+        // The mapping stays valid once the descriptor is closed
+        void *p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+        if (p != MAP_FAILED) {
+            data_ = static_cast<const unsigned char*>(p);
+            size_ = static_cast<size_t>(st.st_size);
+        }
+    }
+    ::close(fd);
+}
+
+inline void MappedFile::close() noexcept
+{
+    if (data_ != nullptr) {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+inline MappedFile::~MappedFile()
+{
+    close();
+}
+
+inline MappedFile::MappedFile(MappedFile &&other) noexcept :
+    data_(std::exchange(other.data_, nullptr)),
+    size_(std::exchange(other.size_, 0))
+{
+}
+
+inline MappedFile& MappedFile::operator=(MappedFile &&other) noexcept
+{
+    if (this != &other) {
+        close();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+    }
+    return *this;
+}
+
+// MyMappedMat
+
+template <typename T>
+MyMappedMat<T>::MyMappedMat(const std::string &path) :
+    file_(path)
+{
+    BinaryHeader header;
+    if (file_.size() < sizeof(header)) {
+        file_.close();
+        return;
+    }
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (!detail::checkHeader<T>(header) || header.dataOffset > file_.size()) {
+        file_.close();
+        return;
+    }
+    const size_t available = (file_.size() - header.dataOffset) / sizeof(T);
+    if (header.cols != 0 && header.rows > available / header.cols) {
+        file_.close();
+        return;
+    }
+    data_ = reinterpret_cast<const T*>(file_.data() + header.dataOffset);
+    rows_ = header.rows;
+    cols_ = header.cols;
+    layout_ = static_cast<Layout>(header.layout);
+}
+
+template <typename T>
+const T& MyMappedMat<T>::operator()(size_t row, size_t col) const
+{
+    assert(row < rows_ && col < cols_);
+    return layout_ == Layout::RowMajor ? data_[row * cols_ + col] : data_[col * rows_ + row];
+}
+
+template <typename T>
+MyMatView<const T> MyMappedMat<T>::view() const noexcept
+{
+    if (layout_ == Layout::RowMajor) {
+        return MyMatView<const T>(data_, rows_, cols_, static_cast<ptrdiff_t>(cols_), 1);
+    }
+    return MyMatView<const T>(data_, rows_, cols_, 1, static_cast<ptrdiff_t>(rows_));
+}
+
+} // namespace MyMatrix
@@ -11,6 +11,15 @@
 #include <iostream>
 #include <array>
 #include <initializer_list>
+#include "utils.h"
+#include "simd.h"
+#include "gemm.h"
+#include "myexpr.h"
+#include "myview.h"
+#include "smallmat.h"
+#include "transpose.h"
+#include "myvec.h"
+#include "mystats.h"
 
 /*!
  * \brief A container abstraction that represents a matrix in linear algebra
@@ -24,22 +33,53 @@
  * MyMat<int> mat;  // 3x3 matrix, type int
  * MyMat<int, 2> mat;   // 2x2 matrix, type int
  * MyMat<double, 2, 3> mat; // 2x3 matrix, type double
+ * MyMat<double, 4, 4, Layout::ColMajor> mat; // 4x4 matrix, type double, stored column by column
  * \endverbatim
  *
+ * The storage order is part of the type, and is row-major unless specified otherwise.
+ * transposed(), block(), row() and col() return views (see myview.h) that read and
+ * write the matrix elements in place, without copying them. Assigning an expression
+ * that reads the matrix itself through such a view, as in m = m.transposed(), is safe.
+ *
  * A limited set of matrix operations is supported. These include basic arithmetic such as
- * addition, subtraction, scalar multiply/divide. Also available are modifers to make
- * the matrix diagonal, or upper/lower triangular.
+ * addition, subtraction, scalar multiply/divide, and matrix-matrix multiplication.
+ * Also available are modifers to make the matrix diagonal, or upper/lower triangular.
  *
  * A set of static factory functions can create an identity matrix, or upper/lower triangular
  * matrices with 1/0 values.
+ *
+ * Addition, subtraction and scalar multiply/divide are lazy (see myexpr.h): a chain such as
+ * a + b - 2 * c is evaluated in a single pass when it is assigned to a matrix. Large
+ * matrices are processed by several threads, see myexec.h.
+ *
+ * Matrices are literal types: construction, element access, arithmetic, transposes,
+ * products and the factories are constexpr, so a matrix made of constants can be
+ * computed at compile time:
+ *
+ * \verbatim
+ * constexpr MyMat<double,4> m = translation * rotation;
+ * \endverbatim
+ *
+ * Products, transposes and matrix x vector of 2x2, 3x3 and 4x4 matrices use the
+ * unrolled kernels of smallmat.h, as do determinant and inverse (see mydecomp.h).
  */
 namespace MyMatrix {
 
-template <typename T = double, size_t R = 3, size_t C = R>
-class MyMat {
+template <typename T = double, size_t R = 3, size_t C = R, Layout L = Layout::RowMajor>
+class MyMat : public MyExpr::Expression<MyMat<T,R,C,L>> {
 public:
-    MyMat();
-    MyMat(std::initializer_list<T>);
+    using value_type = T;
+    using result_type = MyMat;
+
+    static constexpr Layout layout = L;
+    static constexpr ptrdiff_t rowStride = L == Layout::RowMajor ? C : 1;
+    static constexpr ptrdiff_t colStride = L == Layout::RowMajor ? 1 : R;
+
+    constexpr MyMat();
+    constexpr MyMat(std::initializer_list<T>);
+
+    template <typename E>
+    constexpr MyMat(const MyExpr::Expression<E> &);
 
     ~MyMat() = default;
 
@@ -48,13 +88,30 @@ public:
 
     MyMat(MyMat &&) noexcept = default;
     MyMat& operator=(MyMat &&) noexcept = default;
+
+    template <typename E>
+    constexpr MyMat& operator=(const MyExpr::Expression<E> &);
     
-    MyMat<T,C,R> copyTransposed() const;
+    constexpr MyMat<T,C,R,L> copyTransposed() const;
     
-    MyMat& toDiagonal();
-    MyMat& toUpperTriangular();
-    MyMat& toLowerTriangular();
-    MyMat& transpose();
+    constexpr MyMat& toDiagonal();
+    constexpr MyMat& toUpperTriangular();
+    constexpr MyMat& toLowerTriangular();
+
+    // Transpose the elements in place, the matrix must be square
+    constexpr MyMat& transpose();
+
+    // Views of the matrix elements
+    MyMatView<T> view() noexcept { return MyMatView<T>(data(), R, C, rowStride, colStride); }
+    MyMatView<const T> view() const noexcept { return MyMatView<const T>(data(), R, C, rowStride, colStride); }
+    MyMatView<T> transposed() noexcept { return view().transposed(); }
+    MyMatView<const T> transposed() const noexcept { return view().transposed(); }
+    MyMatView<T> block(size_t row, size_t col, size_t rows, size_t cols) { return view().block(row, col, rows, cols); }
+    MyMatView<const T> block(size_t row, size_t col, size_t rows, size_t cols) const { return view().block(row, col, rows, cols); }
+    MyMatView<T> row(size_t i) { return view().row(i); }
+    MyMatView<const T> row(size_t i) const { return view().row(i); }
+    MyMatView<T> col(size_t j) { return view().col(j); }
+    MyMatView<const T> col(size_t j) const { return view().col(j); }
 
     constexpr auto begin() noexcept { return data_.begin(); }
     constexpr auto begin() const noexcept { return data_.begin(); }
@@ -64,66 +121,84 @@ public:
     constexpr auto end() const noexcept { return data_.end(); }
     constexpr auto cend() const noexcept { return data_.cend(); }
 
+    constexpr T* data() noexcept { return data_.data(); }
+    constexpr const T* data() const noexcept { return data_.data(); }
+
     constexpr size_t size() const noexcept { return data_.size(); }
     constexpr bool  empty() const noexcept { return data_.empty(); }
-    size_t rows() const noexcept;
-    size_t cols() const noexcept;
+    constexpr size_t rows() const noexcept { return R; }
+    constexpr size_t cols() const noexcept { return C; }
     constexpr bool square() const { return R == C; }
+    constexpr bool isContiguous(Layout order) const noexcept { return order == L; }
 
-          T& operator() (size_t row, size_t col);
-    const T& operator() (size_t row, size_t col) const;
+    constexpr       T& operator() (size_t row, size_t col);
+    constexpr const T& operator() (size_t row, size_t col) const;
 
-    MyMat& operator+=(const MyMat &);
-    MyMat& operator-=(const MyMat &);
-    MyMat& operator*=(double);
+    constexpr MyMat& operator+=(const MyMat &);
+    constexpr MyMat& operator-=(const MyMat &);
+    constexpr MyMat& operator*=(double);
 
-    friend MyMat operator+(MyMat lhs, const MyMat &rhs)
-    {
-        lhs += rhs;
-        return lhs;
-    }
-    friend MyMat operator-(MyMat lhs, const MyMat &rhs)
-    {
-        lhs -= rhs;
-        return lhs;
-    }
+    template <typename E>
+    constexpr MyMat& operator+=(const MyExpr::Expression<E> &);
+    template <typename E>
+    constexpr MyMat& operator-=(const MyExpr::Expression<E> &);
 
     std::ostream& renderToStream(std::ostream &) const;
 
 private:
+    static constexpr size_t index(size_t row, size_t col) noexcept { return row * rowStride + col * colStride; }
+
     std::array<T,R*C> data_;
-    bool transposed_ = false;
 };
 
+template <typename T, size_t R, size_t C, Layout L>
+struct IsMatrix<MyMat<T,R,C,L>> : std::true_type {};
+
 // Factory methods
-template <typename T = double, size_t R = 3, size_t C = R>
-MyMat<T,R,C> makeIdentity();
-template <typename T = double, size_t R = 3, size_t C = R>
-MyMat<T,R,C> makeUpperTriangular();
-template <typename T = double, size_t R = 3, size_t C = R>
-MyMat<T,R,C> makeLowerTriangular();
-
-// Scalar multiplication and division
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator*(double, const MyMat<T,R,C> &);
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator*(const MyMat<T,R,C> &, double);
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator/(const MyMat<T,R,C> &, double);
+template <typename T = double, size_t R = 3, size_t C = R, Layout L = Layout::RowMajor>
+constexpr MyMat<T,R,C,L> makeIdentity();
+template <typename T = double, size_t R = 3, size_t C = R, Layout L = Layout::RowMajor>
+constexpr MyMat<T,R,C,L> makeUpperTriangular();
+template <typename T = double, size_t R = 3, size_t C = R, Layout L = Layout::RowMajor>
+constexpr MyMat<T,R,C,L> makeLowerTriangular();
+
+// Matrix multiplication, the result has the layout of lhs
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+constexpr MyMat<T,R,C,L> multiply(const MyMat<T,R,K,L> &, const MyMat<T,K,C,L2> &);
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+MyMat<T,R,C,L> multiply(const MyMat<T,R,K,L> &, const MyMat<T,K,C,L2> &, const MyExec::Context &);
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+constexpr MyMat<T,R,C,L> operator*(const MyMat<T,R,K,L> &, const MyMat<T,K,C,L2> &);
+
+// Matrix x vector
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyVector::MyVec<T,R> multiply(const MyMat<T,R,C,L> &, const MyVector::MyVec<T,C> &);
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyVector::MyVec<T,R> operator*(const MyMat<T,R,C,L> &, const MyVector::MyVec<T,C> &);
+
+// Apply a 4x4 affine transform to a 3D point (w = 1) or direction (w = 0). The bottom row
+// of m is ignored, there is no perspective divide.
+template <typename T, Layout L>
+constexpr MyVector::MyVec<T,3> transformPoint(const MyMat<T,4,4,L> &m, const MyVector::MyVec<T,3> &p);
+template <typename T, Layout L>
+constexpr MyVector::MyVec<T,3> transformVector(const MyMat<T,4,4,L> &m, const MyVector::MyVec<T,3> &v);
 
 // Comparison
-// Note that the matrices may be of different template dimension, but if transposed they can still be logically equal
-template <typename T, size_t R, size_t C, size_t R2, size_t C2>
-bool operator==(const MyMat<T,R,C> &lhs, const MyMat<T,R2,C2> &rhs);
-template <typename T, size_t R, size_t C, size_t R2, size_t C2>
-bool operator!=(const MyMat<T, R, C> &, const MyMat<T, R2, C2> &);
+// Note that the matrices may be of different template dimension or layout, equal matrices have the same shape and elements
+template <typename T, size_t R, size_t C, Layout L, size_t R2, size_t C2, Layout L2>
+bool operator==(const MyMat<T,R,C,L> &lhs, const MyMat<T,R2,C2,L2> &rhs);
+template <typename T, size_t R, size_t C, Layout L, size_t R2, size_t C2, Layout L2>
+bool operator!=(const MyMat<T,R,C,L> &, const MyMat<T,R2,C2,L2> &);
 
 // Render the vector contents to the output stream
-template <typename T, size_t R, size_t C>
-std::ostream& operator<<(std::ostream &, const MyMat<T,R,C> &);
+template <typename T, size_t R, size_t C, Layout L>
+std::ostream& operator<<(std::ostream &, const MyMat<T,R,C,L> &);
 
 } // namespace MyMatrix
 
 #include "mymat.tpp"
 
+// Views evaluate to a MyDynMat
+#include "mydynmat.h"
+
 #endif // MYMAT_H
@@ -6,39 +6,86 @@
 //
 
 #include <algorithm>
+#include <cassert>
 
 namespace MyMatrix {
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>::MyMat() :
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>::MyMat() :
     data_(std::array<T, R*C>())
 {
     static_assert (std::is_arithmetic_v<T>, "MyMat requires an arithmetic type");
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>::MyMat(std::initializer_list<T> li) :
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>::MyMat(std::initializer_list<T> li) :
     data_(std::array<T, R*C>())
 {
     static_assert (std::is_arithmetic_v<T>, "MyMat requires an arithmetic type");
     size_t count = std::min(R*C, li.size());
-    std::copy_n(li.begin(), count, data_.begin());
+    for (size_t k = 0; k < count; ++k) {
+        data_[k] = li.begin()[k];
+    }
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,C,R> MyMat<T,R,C>::copyTransposed() const
+template <typename T, size_t R, size_t C, Layout L>
+template <typename E>
+constexpr MyMat<T,R,C,L>::MyMat(const MyExpr::Expression<E> &expr) :
+    data_(std::array<T, R*C>())
 {
-    MyMat<T,C,R> copy;
-    for (size_t i = 0; i < R; ++i) {
-        for (size_t j = 0; j < C; ++j) {
-            copy(j,i) = (*this)(i,j);
+    *this = expr;
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+template <typename E>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (MyExpr::isAssignable<MyMat, E>, "Expression doesn't evaluate to this matrix type");
+    detail::checkShape<T>(expr, R, C);
+    constexpr ptrdiff_t rs = L == Layout::RowMajor ? C : 1;
+    constexpr ptrdiff_t cs = L == Layout::RowMajor ? 1 : R;
+    if (detail::readsAcross(data(), R * C, rs, cs, expr.self())) {
+        // The expression reads this matrix in another order, as in m = m.transposed()
+        if constexpr (R == C && isView<E>) {
+            const E &e = expr.self();
+            if (e.data() == data() && e.rowStride() == cs && e.colStride() == rs) {
+                return transpose();
+            }
         }
+        MyMat result;
+        detail::evalFixed<R,C,L>(result.data(), expr.self(), [](T &d, const T &v) { d = v; });
+        return *this = result;
+    }
+    detail::evalFixed<R,C,L>(data(), expr.self(), [](T &d, const T &v) { d = v; });
+    return *this;
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,C,R,L> MyMat<T,R,C,L>::copyTransposed() const
+{
+    MYSTATS_COUNT("copyTransposed", R * C, 0, 2 * R * C * sizeof(T));
+    MyMat<T,C,R,L> copy;
+    if constexpr (R == C && R <= 4) {
+        detail::smallTranspose<R>(data(), copy.data());
+    }
+    else if (MySimd::isConstantEvaluated()) {
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                copy(j,i) = (*this)(i,j);
+            }
+        }
+    }
+    else {
+        // The storage of a column-major matrix is the row-major storage of its transpose
+        constexpr size_t rows = L == Layout::RowMajor ? R : C;
+        constexpr size_t cols = L == Layout::RowMajor ? C : R;
+        detail::transposeCopy<T>(rows, cols, data(), cols, copy.data(), rows);
     }
     return copy;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::toDiagonal()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::toDiagonal()
 {
     for (size_t i = 0; i < R; ++i) {
         for (size_t j = 0; j < C; ++j) {
@@ -50,8 +97,8 @@ MyMat<T,R,C>& MyMat<T,R,C>::toDiagonal()
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::toUpperTriangular()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::toUpperTriangular()
 {
     for (size_t i = 0; i < R; ++i) {
         for (size_t j = 0; j < i; ++j) {
@@ -61,15 +108,31 @@ MyMat<T,R,C>& MyMat<T,R,C>::toUpperTriangular()
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::transpose()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::transpose()
 {
-    transposed_ = !transposed_;
+    static_assert (R == C, "Only a square matrix can be transposed in place, use transposed() or copyTransposed()");
+    MYSTATS_COUNT("transpose", R * C, 0, 2 * R * C * sizeof(T));
+    if constexpr (R <= 4) {
+        detail::smallTranspose<R>(data(), data());
+    }
+    else if (!MySimd::isConstantEvaluated()) {
+        detail::transposeSquare<T>(R, data(), R);
+    }
+    else {
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = i + 1; j < C; ++j) {
+                T t = data_[index(i,j)];
+                data_[index(i,j)] = data_[index(j,i)];
+                data_[index(j,i)] = t;
+            }
+        }
+    }
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::toLowerTriangular()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::toLowerTriangular()
 {
     for (size_t i = 0; i < R; ++i) {
         for (size_t j = 0; j < i; ++j) {
@@ -79,68 +142,77 @@ MyMat<T,R,C>& MyMat<T,R,C>::toLowerTriangular()
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-size_t MyMat<T,R,C>::rows() const noexcept
+template <typename T, size_t R, size_t C, Layout L>
+constexpr T& MyMat<T,R,C,L>::operator()(size_t row, size_t col)
 {
-    return transposed_ ? C : R;
+    return data_[index(row, col)];
 }
 
-template <typename T, size_t R, size_t C>
-size_t MyMat<T,R,C>::cols() const noexcept
+template <typename T, size_t R, size_t C, Layout L>
+constexpr const T& MyMat<T,R,C,L>::operator()(size_t row, size_t col) const
 {
-    return transposed_ ? R : C;
+    return data_[index(row, col)];
 }
 
-template <typename T, size_t R, size_t C>
-T& MyMat<T,R,C>::operator()(size_t row, size_t col)
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator+=(const MyMat &rhs)
 {
-    if (transposed_) {
-        return data_[col * C + row];
-    }
-    else {
-        return data_[row * C + col];
-    }
+    detail::evalFixed<R,C,L>(data(), rhs, [](T &d, const T &v) { d += v; });
+    return *this;
 }
 
-template <typename T, size_t R, size_t C>
-const T& MyMat<T,R,C>::operator()(size_t row, size_t col) const
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator-=(const MyMat &rhs)
 {
-    if (transposed_) {
-        return data_[col * C + row];
-    }
-    else {
-        return data_[row * C + col];
-    }
+    detail::evalFixed<R,C,L>(data(), rhs, [](T &d, const T &v) { d -= v; });
+    return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::operator+=(const MyMat &rhs)
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator*=(double rhs)
 {
-    std::transform(rhs.cbegin(), rhs.cend(), cbegin(), begin(), std::plus<>());
+    MYSTATS_COUNT("scale", R * C, R * C, 2 * R * C * sizeof(T));
+    T *d = data();
+    if constexpr (R * C < MyExec::minParallelElements) {
+        for (size_t k = 0; k < R * C; ++k) {
+            d[k] *= rhs;
+        }
+    }
+    else {
+        MyExec::parallelFor<T>(R * C, 1, [d, rhs](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                d[k] *= rhs;
+            }
+        });
+    }
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::operator-=(const MyMat &rhs)
+template <typename T, size_t R, size_t C, Layout L>
+template <typename E>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator+=(const MyExpr::Expression<E> &expr)
 {
-    std::transform(rhs.cbegin(), rhs.cend(), cbegin(), begin(), std::minus<>());
+    static_assert (MyExpr::isAssignable<MyMat, E>, "Expression doesn't evaluate to this matrix type");
+    detail::checkShape<T>(expr, R, C);
+    detail::evalFixed<R,C,L>(data(), expr.self(), [](T &d, const T &v) { d += v; });
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C>& MyMat<T,R,C>::operator*=(double rhs)
+template <typename T, size_t R, size_t C, Layout L>
+template <typename E>
+constexpr MyMat<T,R,C,L>& MyMat<T,R,C,L>::operator-=(const MyExpr::Expression<E> &expr)
 {
-    std::for_each(begin(), end(), [rhs](double &v) { v *= rhs; });
+    static_assert (MyExpr::isAssignable<MyMat, E>, "Expression doesn't evaluate to this matrix type");
+    detail::checkShape<T>(expr, R, C);
+    detail::evalFixed<R,C,L>(data(), expr.self(), [](T &d, const T &v) { d -= v; });
     return *this;
 }
 
-template <typename T, size_t R, size_t C>
-std::ostream& MyMat<T,R,C>::renderToStream(std::ostream &os) const
+template <typename T, size_t R, size_t C, Layout L>
+std::ostream& MyMat<T,R,C,L>::renderToStream(std::ostream &os) const
 {
-    auto numRows = rows();
-    auto numCols = cols();
-    for (size_t i = 0; i < numRows; ++i) {
-        for (size_t j = 0; j < numCols; ++j) {
+    for (size_t i = 0; i < R; ++i) {
+        for (size_t j = 0; j < C; ++j) {
             os << (*this)(i,j) << " ";
         }
         os << "\n";
@@ -150,24 +222,24 @@ std::ostream& MyMat<T,R,C>::renderToStream(std::ostream &os) const
 }
 
 // Related non-members
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> makeIdentity()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L> makeIdentity()
 {
     static_assert (R == C, "Identity matrix must be square");
     static_assert (R > 0, "Identity matrix can't be empty");
-    MyMat<T,R,C> id;
+    MyMat<T,R,C,L> id;
     for (size_t i = 0; i < R; ++i) {
         id(i,i) = 1;
     }
     return id;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> makeUpperTriangular()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L> makeUpperTriangular()
 {
     static_assert (R == C, "Triangular matrix must be square");
     static_assert (R > 0, "Triangular matrix can't be empty");
-    MyMat<T,R,C> ut;
+    MyMat<T,R,C,L> ut;
     for (size_t i = 0; i < R; ++i) {
         for (size_t j = 0; j <= i; ++j) {
             ut(j,i) = 1;
@@ -176,12 +248,12 @@ MyMat<T,R,C> makeUpperTriangular()
     return ut;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> makeLowerTriangular()
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyMat<T,R,C,L> makeLowerTriangular()
 {
     static_assert (R == C, "Triangular matrix must be square");
     static_assert (R > 0, "Triangular matrix can't be empty");
-    MyMat<T,R,C> lt;
+    MyMat<T,R,C,L> lt;
     for (size_t i = 0; i < R; ++i) {
         for (size_t j = 0; j <= i; ++j) {
             lt(i,j) = 1;
@@ -190,71 +262,127 @@ MyMat<T,R,C> makeLowerTriangular()
     return lt;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator*(double scalar, const MyMat<T,R,C> &vec)
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+constexpr MyMat<T,R,C,L> multiply(const MyMat<T,R,K,L> &lhs, const MyMat<T,K,C,L2> &rhs)
 {
-    MyMat<T,R,C> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return scalar * v;} );
+    using Result = MyMat<T,R,C,L>;
+    MYSTATS_COUNT("multiply", R * C, 2 * R * C * K, (R * K + K * C + R * C) * sizeof(T));
+    Result result;
+    if constexpr (R == K && K == C && R <= 4 && L == L2) {
+        // Column-major storage holds the transposes, and (AB)^T = B^T A^T
+        if constexpr (L == Layout::RowMajor) {
+            detail::smallMultiply<R>(lhs.data(), rhs.data(), result.data());
+        }
+        else {
+            detail::smallMultiply<R>(rhs.data(), lhs.data(), result.data());
+        }
+    }
+    else if (MySimd::isConstantEvaluated()) {
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                T sum = 0;
+                for (size_t k = 0; k < K; ++k) {
+                    sum += lhs(i,k) * rhs(k,j);
+                }
+                result(i,j) = sum;
+            }
+        }
+    }
+    else {
+        detail::gemm<T>(R, C, K, T(1), lhs.data(), lhs.rowStride, lhs.colStride, rhs.data(), rhs.rowStride, rhs.colStride,
+                        T(0), result.data(), Result::rowStride, Result::colStride);
+    }
     return result;
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator*(const MyMat<T,R,C> &vec, double scalar)
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+MyMat<T,R,C,L> multiply(const MyMat<T,R,K,L> &lhs, const MyMat<T,K,C,L2> &rhs, const MyExec::Context &ctx)
 {
-    MyMat<T,R,C> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return scalar * v;} );
-    return result;
+    MyExec::ScopedContext scope(ctx);
+    return multiply(lhs, rhs);
 }
 
-template <typename T, size_t R, size_t C>
-MyMat<T,R,C> operator/(const MyMat<T,R,C> &vec, double scalar)
+template <typename T, size_t R, size_t K, size_t C, Layout L, Layout L2>
+constexpr MyMat<T,R,C,L> operator*(const MyMat<T,R,K,L> &lhs, const MyMat<T,K,C,L2> &rhs)
 {
-    MyMat<T,R,C> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return v / scalar;} );
-    return result;
+    return multiply(lhs, rhs);
 }
 
-template <typename T, size_t R, size_t C, size_t R2, size_t C2>
-bool operator==(const MyMat<T,R,C> &lhs, const MyMat<T,R2,C2> &rhs)
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyVector::MyVec<T,R> multiply(const MyMat<T,R,C,L> &a, const MyVector::MyVec<T,C> &x)
 {
-    // Do the rows and columns match? (Taking into account whether the matrix is transposed internally)
-    auto numRows = lhs.rows();
-    auto numCols = lhs.cols();
+    MYSTATS_COUNT("multiply", R, 2 * R * C, (R * C + C + R) * sizeof(T));
+    MyVector::MyVec<T,R> y;
+    if constexpr (R == C && R <= 4) {
+        if constexpr (L == Layout::RowMajor) {
+            detail::smallTransform<R>(a.data(), x.data(), y.data());
+        }
+        else {
+            detail::smallTransformTransposed<R>(a.data(), x.data(), y.data());
+        }
+    }
+    else {
+        for (size_t i = 0; i < R; ++i) {
+            T sum = 0;
+            for (size_t j = 0; j < C; ++j) {
+                sum += a(i,j) * x[j];
+            }
+            y[i] = sum;
+        }
+    }
+    return y;
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+constexpr MyVector::MyVec<T,R> operator*(const MyMat<T,R,C,L> &a, const MyVector::MyVec<T,C> &x)
+{
+    return multiply(a, x);
+}
+
+template <typename T, Layout L>
+constexpr MyVector::MyVec<T,3> transformPoint(const MyMat<T,4,4,L> &m, const MyVector::MyVec<T,3> &p)
+{
+    MyVector::MyVec<T,4> y = multiply(m, MyVector::MyVec<T,4>{p[0], p[1], p[2], T(1)});
+    return MyVector::MyVec<T,3>{y[0], y[1], y[2]};
+}
+
+template <typename T, Layout L>
+constexpr MyVector::MyVec<T,3> transformVector(const MyMat<T,4,4,L> &m, const MyVector::MyVec<T,3> &v)
+{
+    MyVector::MyVec<T,4> y = multiply(m, MyVector::MyVec<T,4>{v[0], v[1], v[2], T(0)});
+    return MyVector::MyVec<T,3>{y[0], y[1], y[2]};
+}
 
-    if (numRows != rhs.rows() ||
-        numCols != rhs.cols()) {
+template <typename T, size_t R, size_t C, Layout L, size_t R2, size_t C2, Layout L2>
+bool operator==(const MyMat<T,R,C,L> &lhs, const MyMat<T,R2,C2,L2> &rhs)
+{
+    if constexpr (R != R2 || C != C2) {
         return false;
     }
-
-    if constexpr (std::is_integral_v<T>) {
-        for (size_t i = 0; i < numRows; ++i) {
-            for (size_t j = 0; j < numCols; ++j) {
-                if (lhs(i,j) != rhs(i,j)) {
-                    return false;
-                }
-            }
+    else if constexpr (L == L2) {
+        MYSTATS_COUNT("compare", R * C, R * C, 2 * R * C * sizeof(T));
+        if constexpr (std::is_integral_v<T>) {
+            return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin());
+        }
+        else {
+            return std::equal(lhs.cbegin(), lhs.cend(), rhs.cbegin(), [](const T &l, const T &r) {
+                return almost_equal(l, r, 2);
+            });
         }
     }
     else {
-        for (size_t i = 0; i < numRows; ++i) {
-            for (size_t j = 0; j < numCols; ++j) {
-                if (!almost_equal(lhs(i,j), rhs(i,j), 2)) {
-                    return false;
-                }
-            }
-        }
+        return lhs.view() == rhs.view();
     }
-    return true;
 }
 
-template <typename T, size_t R, size_t C, size_t R2, size_t C2>
-bool operator!=(const MyMat<T,R,C> &lhs, const MyMat<T,R2,C2> &rhs)
+template <typename T, size_t R, size_t C, Layout L, size_t R2, size_t C2, Layout L2>
+bool operator!=(const MyMat<T,R,C,L> &lhs, const MyMat<T,R2,C2,L2> &rhs)
 {
     return !(lhs == rhs);
 }
 
-template <typename T, size_t R, size_t C>
-std::ostream& operator<<(std::ostream &os, const MyMat<T,R,C> &m)
+template <typename T, size_t R, size_t C, Layout L>
+std::ostream& operator<<(std::ostream &os, const MyMat<T,R,C,L> &m)
 {
     return m.renderToStream(os);
 }
@@ -0,0 +1,128 @@
+//
+//  mypipeline.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYPIPELINE_H
+#define MYPIPELINE_H
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <limits>
+#include <vector>
+#include "myexec.h"
+#include "mymat.h"
+#include "myvec.h"
+#include "myvecbatch.h"
+#include "mystats.h"
+
+/*!
+ * \brief Chunked processing of point streams too large to hold in memory
+ * \details MyPointPipeline applies a list of stages to a stream of 3D points: affine
+ * transforms by MyMat<T,4,4>, normalization, and filters on the dot product with a
+ * direction. Consecutive transforms are multiplied together once, when they are added,
+ * so a chain of transforms costs one matrix per point.
+ *
+ * \verbatim
+ * MyPointPipeline<double> pipeline;
+ * pipeline.transform(objectToWorld).transform(worldToCamera)  // one matrix
+ *         .normalize()
+ *         .keepDot(forward, 0.5);                               // in a 60 degree cone
+ *
+ * pipeline.run([&](MyVec<double,3> *buffer, size_t capacity) { return file.read(buffer, capacity); },
+ *              [&](const MyVec<double,3> *points, size_t count) { out.write(points, count); });
+ * \endverbatim
+ *
+ * run reads chunkSize() points at a time from the reader, into one of two buffers. While
+ * the calling thread reads a chunk and hands the previous one to the sink, the chunk in
+ * between is processed on the thread pool of the context, so reading, computing and
+ * writing overlap. Each chunk is converted to a MyVecBatch and processed with the batch
+ * kernels of myvecbatch.h, in tiles spread over the pool. The reader and the sink are
+ * only called from the calling thread, in order, and the points reach the sink in the
+ * order they were read. At most two chunks are in memory at any time.
+ *
+ * With a serial context, or a pool without threads, the chunks are processed one after
+ * the other on the calling thread.
+ */
+namespace MyMatrix {
+
+template <typename T = double>
+class MyPointPipeline {
+public:
+    using Point = MyVector::MyVec<T,3>;
+
+    static constexpr size_t defaultChunkSize = 1 << 16;
+
+    explicit MyPointPipeline(size_t chunkSize = defaultChunkSize);
+
+    // Transform the points by m, after the stages already added
+    template <Layout L>
+    MyPointPipeline& transform(const MyMat<T,4,4,L> &m);
+    // Scale the points to unit length, zero stays zero
+    MyPointPipeline& normalize();
+    // Keep the points p with lo <= dotProduct(p, direction) <= hi
+    MyPointPipeline& keepDot(const Point &direction, T lo, T hi = std::numeric_limits<T>::infinity());
+
+    size_t chunkSize() const noexcept { return chunkSize_; }
+    size_t stages() const noexcept { return stages_.size(); }
+
+    // Process every point of the reader, and pass the points that are kept to the sink.
+    // read(Point *buffer, size_t capacity) stores up to capacity points and returns how
+    // many, 0 at the end of the stream. sink(const Point *points, size_t count) is called
+    // for every chunk that keeps points. Returns the number of points passed to the sink.
+    // Exceptions thrown by the reader, the sink or the processing of a chunk propagate to
+    // the caller, once no chunk is processed any more; the points of the chunks in flight
+    // are dropped.
+    template <typename Reader, typename Sink>
+    size_t run(Reader &&read, Sink &&sink) const;
+    template <typename Reader, typename Sink>
+    size_t run(Reader &&read, Sink &&sink, const MyExec::Context &) const;
+
+private:
+    enum class Kind {
+        Transform,
+        Normalize,
+        KeepDot
+    };
+
+    struct Stage {
+        Kind kind;
+        MyMat<T,4,4> matrix;
+        Point direction;
+        T lo;
+        T hi;
+    };
+
+    // Buffers of one chunk in flight
+    struct Slot {
+        std::vector<Point> points;
+        MyVector::MyVecBatch<T,3> batch;
+        std::vector<T> dots;
+        std::vector<size_t> tileKept;   // points kept by each tile
+        size_t count = 0;               // points read
+        size_t kept = 0;                // points kept, at the front of points
+        std::atomic<bool> done{true};
+        std::exception_ptr error;       // thrown while processing on the pool
+    };
+
+    size_t tilePoints(const MyExec::Context &) const;
+    size_t processTile(Slot &, size_t begin, size_t end) const;
+    size_t processSlot(Slot &, MyExec::ThreadPool *, size_t tile) const;
+    static void settle(Slot &, MyExec::ThreadPool *) noexcept;
+
+    size_t chunkSize_;
+    std::vector<Stage> stages_;
+};
+
+// A reader over the range [first, last) of Point, for MyPointPipeline::run
+template <typename Iter>
+auto rangeReader(Iter first, Iter last);
+
+} // namespace MyMatrix
+
+#include "mypipeline.tpp"
+
+#endif // MYPIPELINE_H
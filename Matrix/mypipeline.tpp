@@ -0,0 +1,260 @@
+//
+//  mypipeline.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <thread>
+#include <utility>
+
+namespace MyMatrix {
+
+template <typename T>
+MyPointPipeline<T>::MyPointPipeline(size_t chunkSize) :
+    chunkSize_(chunkSize)
+{
+    static_assert (std::is_floating_point_v<T>, "MyPointPipeline requires a floating point type");
+    assert(chunkSize > 0);
+}
+
+template <typename T>
+template <Layout L>
+MyPointPipeline<T>& MyPointPipeline<T>::transform(const MyMat<T,4,4,L> &m)
+{
+    MyMat<T,4,4> matrix;
+    for (size_t i = 0; i < 4; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            matrix(i, j) = m(i, j);
+        }
+    }
+    if (!stages_.empty() && stages_.back().kind == Kind::Transform) {
+        // Applied after the previous transform: compose the two into one
+        stages_.back().matrix = matrix * stages_.back().matrix;
+    }
+    else {
+        stages_.push_back(Stage{Kind::Transform, matrix, Point(), T(0), T(0)});
+    }
+    return *this;
+}
+
+template <typename T>
+MyPointPipeline<T>& MyPointPipeline<T>::normalize()
+{
+    stages_.push_back(Stage{Kind::Normalize, MyMat<T,4,4>(), Point(), T(0), T(0)});
+    return *this;
+}
+
+template <typename T>
+MyPointPipeline<T>& MyPointPipeline<T>::keepDot(const Point &direction, T lo, T hi)
+{
+    stages_.push_back(Stage{Kind::KeepDot, MyMat<T,4,4>(), direction, lo, hi});
+    return *this;
+}
+
+// Points per tile: enough for the three lanes of a tile to fill tileBytes, and a whole
+// number of cache lines so that every tile starts its lanes on a cache line
+template <typename T>
+size_t MyPointPipeline<T>::tilePoints(const MyExec::Context &ctx) const
+{
+    constexpr size_t perLine = std::max<size_t>(1, MyMemory::cacheLine / sizeof(T));
+    size_t points = ctx.tileBytes / (3 * sizeof(T)) / perLine * perLine;
+    return std::max(points, perLine);
+}
+
+// Run the stages on the points [begin, end) of the slot. The kept points are written
+// back from begin on.
+template <typename T>
+size_t MyPointPipeline<T>::processTile(Slot &slot, size_t begin, size_t end) const
+{
+    T *lanes[3];
+    const T *in[3];
+    for (size_t c = 0; c < 3; ++c) {
+        lanes[c] = slot.batch.lane(c) + begin;
+        in[c] = lanes[c];
+    }
+    const Point *points = slot.points.data() + begin;
+    size_t n = end - begin;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            lanes[c][i] = points[i][c];
+        }
+    }
+
+    T *dots = slot.dots.data() + begin;
+    for (const Stage &stage : stages_) {
+        switch (stage.kind) {
+        case Kind::Transform:
+            MyVector::detail::batchTransform<T,1>(n, lanes, MyVector::detail::affineOf(stage.matrix));
+            break;
+        case Kind::Normalize:
+            MyVector::detail::batchNormalize<T,3,false>(n, lanes);
+            break;
+        case Kind::KeepDot: {
+            MyVector::detail::batchDot<T,3>(n, in, stage.direction, dots);
+            size_t kept = 0;
+            for (size_t i = 0; i < n; ++i) {
+                if (dots[i] >= stage.lo && dots[i] <= stage.hi) {
+                    for (size_t c = 0; c < 3; ++c) {
+                        lanes[c][kept] = lanes[c][i];
+                    }
+                    ++kept;
+                }
+            }
+            n = kept;
+            break;
+        }
+        }
+    }
+
+    Point *out = slot.points.data() + begin;
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            out[i][c] = lanes[c][i];
+        }
+    }
+    return n;
+}
+
+// Process the slot in tiles on pool, then move the points kept by every tile together.
+// Returns the number of points kept.
+template <typename T>
+size_t MyPointPipeline<T>::processSlot(Slot &slot, MyExec::ThreadPool *pool, size_t tile) const
+{
+    MYSTATS_SCOPE("pointPipeline", slot.count, 0, 2 * slot.count * sizeof(Point));
+    const size_t count = slot.count;
+    const size_t tiles = (count + tile - 1) / tile;
+    slot.batch.resize(count);
+    slot.dots.resize(count);
+    slot.tileKept.resize(tiles);
+    MyExec::forEachTile(pool, tiles, [&](size_t t) {
+        slot.tileKept[t] = processTile(slot, t * tile, std::min(count, (t + 1) * tile));
+    });
+
+    Point *points = slot.points.data();
+    size_t kept = tiles > 0 ? slot.tileKept[0] : 0;
+    for (size_t t = 1; t < tiles; ++t) {
+        // The destination is never after the source, a forward copy is safe
+        std::copy_n(points + t * tile, slot.tileKept[t], points + kept);
+        kept += slot.tileKept[t];
+    }
+    return kept;
+}
+
+// Wait for a slot, running queued tasks meanwhile
+template <typename T>
+void MyPointPipeline<T>::settle(Slot &slot, MyExec::ThreadPool *pool) noexcept
+{
+    while (!slot.done.load(std::memory_order_acquire)) {
+        if (!pool->runPending()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+template <typename T>
+template <typename Reader, typename Sink>
+size_t MyPointPipeline<T>::run(Reader &&read, Sink &&sink) const
+{
+    return run(std::forward<Reader>(read), std::forward<Sink>(sink), MyExec::current());
+}
+
+template <typename T>
+template <typename Reader, typename Sink>
+size_t MyPointPipeline<T>::run(Reader &&read, Sink &&sink, const MyExec::Context &ctx) const
+{
+    MyExec::ThreadPool *pool = ctx.poolFor(3 * chunkSize_, ctx.serialElements);
+    const size_t tile = tilePoints(ctx);
+
+    Slot slots[2];
+    for (Slot &slot : slots) {
+        slot.points.resize(chunkSize_);
+    }
+    // If the reader, the sink or a chunk throws, wait for the chunk still processed
+    // on the pool before its slot goes out of scope
+    struct Drain {
+        Slot *slots;
+        MyExec::ThreadPool *pool;
+        ~Drain() {
+            if (pool) {
+                settle(slots[0], pool);
+                settle(slots[1], pool);
+            }
+        }
+    } drain{slots, pool};
+
+    // Process a slot on a worker, or right away without a pool
+    auto launch = [&](Slot &slot) {
+        if (!pool) {
+            slot.kept = processSlot(slot, nullptr, tile);
+            return;
+        }
+        slot.done.store(false, std::memory_order_relaxed);
+        pool->submit([this, &slot, pool, tile] {
+            try {
+                slot.kept = processSlot(slot, pool, tile);
+            }
+            catch (...) {
+                slot.error = std::current_exception();
+            }
+            slot.done.store(true, std::memory_order_release);
+        });
+    };
+    // Wait for a slot, and rethrow what its processing threw
+    auto wait = [&](Slot &slot) {
+        settle(slot, pool);
+        if (slot.error) {
+            std::rethrow_exception(std::exchange(slot.error, nullptr));
+        }
+    };
+    auto fill = [&](Slot &slot) {
+        slot.count = static_cast<size_t>(read(slot.points.data(), chunkSize_));
+        assert(slot.count <= chunkSize_);
+        return slot.count > 0;
+    };
+
+    Slot *current = &slots[0];
+    Slot *next = &slots[1];
+    if (!fill(*current)) {
+        return 0;
+    }
+    launch(*current);
+
+    size_t total = 0;
+    for (;;) {
+        // Read the next chunk while the current one is processed,
+        // then process the next chunk while the current one goes to the sink
+        bool more = fill(*next);
+        wait(*current);
+        if (more) {
+            launch(*next);
+        }
+        if (current->kept > 0) {
+            sink(static_cast<const Point*>(current->points.data()), current->kept);
+            total += current->kept;
+        }
+        if (!more) {
+            return total;
+        }
+        std::swap(current, next);
+    }
+}
+
+// Related non-members
+
+template <typename Iter>
+auto rangeReader(Iter first, Iter last)
+{
+    return [first, last](auto *buffer, size_t capacity) mutable {
+        size_t n = 0;
+        for (; n < capacity && first != last; ++n, ++first) {
+            buffer[n] = *first;
+        }
+        return n;
+    };
+}
+
+} // namespace MyMatrix
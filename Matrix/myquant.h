@@ -0,0 +1,217 @@
+//
+//  myquant.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYQUANT_H
+#define MYQUANT_H
+
+#include <iostream>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include "allocator.h"
+#include "myexec.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "mystats.h"
+
+/*!
+ * \brief Quantized matrices and vectors of 8 or 16 bit integers
+ * \details A quantized matrix stores every element as a small integer q, that stands for
+ * the real value scale * (q - zeroPoint). Storing int8 instead of float puts four times
+ * as many elements in a cache line, and the products multiply the integers and
+ * accumulate them exactly in int32 (pieces of up to 133k int8 products) and int64,
+ * which vector units do several times faster than floating point:
+ *
+ * \verbatim
+ * MyQuantMat<int8_t> w = quantize<int8_t>(weights, QuantScheme::PerRow);
+ * MyQuantVec<int8_t> x = quantize<int8_t>(features);
+ * MyDynVec<float> scores = w * x;
+ * \endverbatim
+ *
+ * The scale and zero point are either one pair for the whole matrix (PerTensor), or one
+ * per row (PerRow), which keeps more precision when the rows have different ranges,
+ * such as the weights of different outputs. quantize picks them from the range of the
+ * values, so that the range maps onto the integers and 0 is exact, and dequantize
+ * converts back to float.
+ *
+ * multiplyTransposed(a, b) computes a b^T, so both operands are read along their rows:
+ * each row of b holds a column of the right operand, as the weights of one output
+ * usually do. The result is either dequantized to float, or left as the integer sums
+ * of (a - za)(b - zb). Matrix x vector computes Ax the same way. The zero points are
+ * taken out in int64, and the float results are converted from those exact sums. The
+ * integer results are QuantAccumulator<Q>, int32 for int8, which holds the exact sums
+ * of up to quantExactDepth<Q> columns (33025 for int8); longer rows are asserted against.
+ *
+ * The int8 kernels use AVX-512 VNNI (vpdpbusd), or AVX2 (vpmaddubsw), or NEON, and
+ * portable code otherwise. They multiply |a| by b with the sign of a, which is exact
+ * for int8 values in [-127, 127]: quantize never produces -128, and the integers must
+ * stay in that range when they are set directly. int16 elements accumulate in int64,
+ * as products of two int16 overflow an int32 after a couple of terms; they use portable
+ * code that the compiler vectorizes.
+ *
+ * Rows are padded with zeros to a multiple of 64 bytes, so that the kernels only do
+ * whole vector loads. Large products run on the MyExec thread pool, see myexec.h.
+ */
+namespace MyMatrix {
+
+enum class QuantScheme {
+    PerTensor,  // one scale and zero point for the whole matrix
+    PerRow      // one scale and zero point per row
+};
+
+// A real value is scale * (q - zeroPoint)
+struct QuantParams {
+    float scale = 1;
+    int32_t zeroPoint = 0;
+};
+
+// Integer type of the sums of products of Q
+template <typename Q>
+using QuantAccumulator = std::conditional_t<sizeof(Q) == 1, int32_t, int64_t>;
+
+// Largest number of columns for which the sums of (a - za)(b - zb) are sure to fit in
+// QuantAccumulator<Q>: each term reaches (2^bits - 1)^2 in magnitude, 255 x 255 for int8
+template <typename Q>
+constexpr size_t quantExactDepth = sizeof(Q) == 1 ? size_t(INT32_MAX) / (255 * 255)
+                                                  : size_t(INT64_MAX / (int64_t(65535) * 65535));
+
+template <typename Q>
+constexpr bool isQuantType = std::is_same_v<Q, int8_t> || std::is_same_v<Q, int16_t>;
+
+template <typename Q = int8_t>
+class MyQuantMat {
+public:
+    using value_type = Q;
+    using accumulator_type = QuantAccumulator<Q>;
+
+    MyQuantMat() = default;
+    // A rows x cols matrix of zeros, with a scale of 1 and a zero point of 0
+    MyQuantMat(size_t rows, size_t cols, QuantScheme scheme = QuantScheme::PerTensor);
+
+    ~MyQuantMat() = default;
+
+    MyQuantMat(const MyQuantMat &) = default;
+    MyQuantMat& operator=(const MyQuantMat &) = default;
+
+    MyQuantMat(MyQuantMat &&) noexcept = default;
+    MyQuantMat& operator=(MyQuantMat &&) noexcept = default;
+
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    QuantScheme scheme() const noexcept { return scheme_; }
+
+    // Distance between rows, cols() rounded up to a multiple of 64 bytes
+    size_t stride() const noexcept { return stride_; }
+          Q* row(size_t i) noexcept { return data_.data() + i * stride_; }
+    const Q* row(size_t i) const noexcept { return data_.data() + i * stride_; }
+
+          Q& operator() (size_t row, size_t col);
+    const Q& operator() (size_t row, size_t col) const;
+
+    // Parameters of a row, the same for every row with PerTensor
+    const QuantParams& params(size_t row = 0) const;
+    void setParams(size_t row, const QuantParams &);
+
+    // Real value of element (row, col)
+    float value(size_t row, size_t col) const;
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    std::vector<Q, MyMemory::AlignedAllocator<Q>> data_;
+    std::vector<QuantParams> params_;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+    size_t stride_ = 0;
+    QuantScheme scheme_ = QuantScheme::PerTensor;
+};
+
+template <typename Q = int8_t>
+class MyQuantVec {
+public:
+    using value_type = Q;
+    using accumulator_type = QuantAccumulator<Q>;
+
+    MyQuantVec() = default;
+    explicit MyQuantVec(size_t n, const QuantParams &params = QuantParams());
+
+    ~MyQuantVec() = default;
+
+    MyQuantVec(const MyQuantVec &) = default;
+    MyQuantVec& operator=(const MyQuantVec &) = default;
+
+    MyQuantVec(MyQuantVec &&) noexcept = default;
+    MyQuantVec& operator=(MyQuantVec &&) noexcept = default;
+
+    size_t size() const noexcept { return size_; }
+          Q* data() noexcept { return data_.data(); }
+    const Q* data() const noexcept { return data_.data(); }
+
+          Q& operator[](size_t i);
+    const Q& operator[](size_t i) const;
+
+    const QuantParams& params() const noexcept { return params_; }
+    void setParams(const QuantParams &params) { params_ = params; }
+
+    float value(size_t i) const;
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    // Padded with zeros like the rows of MyQuantMat
+    std::vector<Q, MyMemory::AlignedAllocator<Q>> data_;
+    QuantParams params_;
+    size_t size_ = 0;
+};
+
+// Parameters that map [min, max], widened to include 0, onto the range of Q
+template <typename Q>
+QuantParams chooseQuantParams(float min, float max);
+
+// Quantize a matrix, view or vector of floating point values
+template <typename Q = int8_t, typename M, typename = std::enable_if_t<isMatrix<M>>>
+MyQuantMat<Q> quantize(const M &, QuantScheme scheme = QuantScheme::PerTensor);
+template <typename Q = int8_t, typename T, typename A>
+MyQuantVec<Q> quantize(const MyVector::MyDynVec<T,A> &);
+template <typename Q = int8_t, typename T, size_t N>
+MyQuantVec<Q> quantize(const MyVector::MyVec<T,N> &);
+
+template <typename Q>
+MyDynMat<float> dequantize(const MyQuantMat<Q> &);
+template <typename Q>
+MyVector::MyDynVec<float> dequantize(const MyQuantVec<Q> &);
+
+// c = ab^T as integers: c(i,j) is the sum over k of (a(i,k) - za) * (b(j,k) - zb).
+// a and b must have the same number of columns, at most quantExactDepth<Q>, and c must
+// be a.rows() x b.rows().
+template <typename Q>
+void multiplyTransposed(const MyQuantMat<Q> &a, const MyQuantMat<Q> &b, MyMatView<QuantAccumulator<Q>> c);
+// c = ab^T in real values
+template <typename Q>
+MyDynMat<float> multiplyTransposed(const MyQuantMat<Q> &a, const MyQuantMat<Q> &b);
+
+// y = Ax as integers, y must have a.rows() elements and a at most quantExactDepth<Q> columns
+template <typename Q, typename A>
+void multiply(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x, MyVector::MyDynVec<QuantAccumulator<Q>,A> &y);
+// y = Ax in real values
+template <typename Q>
+MyVector::MyDynVec<float> multiply(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x);
+template <typename Q>
+MyVector::MyDynVec<float> operator*(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x);
+
+// Render the integers, and the parameters
+template <typename Q>
+std::ostream& operator<<(std::ostream &, const MyQuantMat<Q> &);
+template <typename Q>
+std::ostream& operator<<(std::ostream &, const MyQuantVec<Q> &);
+
+} // namespace MyMatrix
+
+#include "myquant.tpp"
+
+#endif // MYQUANT_H
@@ -0,0 +1,512 @@
+//
+//  myquant.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include "simd.h"
+
+namespace MyMatrix {
+
+namespace detail {
+
+// Row length padded to a multiple of a cache line
+template <typename Q>
+size_t quantStride(size_t cols)
+{
+    constexpr size_t perLine = MyMemory::cacheLine / sizeof(Q);
+    return (cols + perLine - 1) / perLine * perLine;
+}
+
+// Quantized values are symmetric around 0, see dotInt8x4
+template <typename Q>
+constexpr int32_t quantMax = std::numeric_limits<Q>::max();
+template <typename Q>
+constexpr int32_t quantMin = -quantMax<Q>;
+
+template <typename Q>
+Q quantizeValue(double x, const QuantParams &p)
+{
+    long q = std::lrint(x / p.scale) + p.zeroPoint;
+    return static_cast<Q>(std::clamp<long>(q, quantMin<Q>, quantMax<Q>));
+}
+
+// The sums of products of a with b[0..3], over n elements padded to a multiple of 64 bytes.
+// The vector versions multiply |a| (unsigned) by b with the sign of a, which is exact as
+// long as a or b isn't -128.
+inline void dotInt8x4(const int8_t *a, const int8_t *const *b, size_t n, int32_t *out)
+{
+#if defined(__AVX512VNNI__) && defined(__AVX512BW__)
+    __m512i acc[4] = {_mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512(), _mm512_setzero_si512()};
+    for (size_t k = 0; k < n; k += 64) {
+        __m512i va = _mm512_loadu_si512(a + k);
+        __m512i absA = _mm512_abs_epi8(va);
+        __mmask64 negative = _mm512_movepi8_mask(va);
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < 4; ++j) {
+            __m512i vb = _mm512_loadu_si512(b[j] + k);
+            vb = _mm512_mask_sub_epi8(vb, negative, _mm512_setzero_si512(), vb);
+            acc[j] = _mm512_dpbusd_epi32(acc[j], absA, vb);
+        }
+    }
+    for (size_t j = 0; j < 4; ++j) {
+        alignas(64) int32_t lanes[16];
+        _mm512_store_si512(lanes, acc[j]);
+        out[j] = std::accumulate(lanes, lanes + 16, 0);
+    }
+#elif defined(__AVX2__)
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc[4] = {_mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256(), _mm256_setzero_si256()};
+    for (size_t k = 0; k < n; k += 32) {
+        __m256i va = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + k));
+        __m256i absA = _mm256_abs_epi8(va);
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < 4; ++j) {
+            __m256i vb = _mm256_sign_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(b[j] + k)), va);
+#if defined(__AVXVNNI__)
+            acc[j] = _mm256_dpbusd_avx_epi32(acc[j], absA, vb);
+#else
+            // Pairs of products fit int16 for values in [-127, 127]
+            acc[j] = _mm256_add_epi32(acc[j], _mm256_madd_epi16(_mm256_maddubs_epi16(absA, vb), ones));
+#endif
+        }
+    }
+    for (size_t j = 0; j < 4; ++j) {
+        __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc[j]), _mm256_extracti128_si256(acc[j], 1));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+        s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+        out[j] = _mm_cvtsi128_si32(s);
+    }
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+    int32x4_t acc[4] = {vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0), vdupq_n_s32(0)};
+    for (size_t k = 0; k < n; k += 16) {
+        int8x16_t va = vld1q_s8(a + k);
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < 4; ++j) {
+            int8x16_t vb = vld1q_s8(b[j] + k);
+#if defined(__ARM_FEATURE_DOTPROD)
+            acc[j] = vdotq_s32(acc[j], va, vb);
+#else
+            int16x8_t p = vmull_s8(vget_low_s8(va), vget_low_s8(vb));
+            p = vmlal_s8(p, vget_high_s8(va), vget_high_s8(vb));
+            acc[j] = vpadalq_s16(acc[j], p);
+#endif
+        }
+    }
+    for (size_t j = 0; j < 4; ++j) {
+        out[j] = vaddvq_s32(acc[j]);
+    }
+#else
+    for (size_t j = 0; j < 4; ++j) {
+        int32_t sum = 0;
+        for (size_t k = 0; k < n; ++k) {
+            sum += int32_t(a[k]) * int32_t(b[j][k]);
+        }
+        out[j] = sum;
+    }
+#endif
+}
+
+template <typename Q>
+void dotRows4(const Q *a, const Q *const *b, size_t n, QuantAccumulator<Q> *out)
+{
+    if constexpr (std::is_same_v<Q, int8_t>) {
+        dotInt8x4(a, b, n, out);
+    }
+    else {
+        using Acc = QuantAccumulator<Q>;
+        Acc sum[4] = {};
+        for (size_t k = 0; k < n; ++k) {
+            MYSIMD_UNROLL
+            for (size_t j = 0; j < 4; ++j) {
+                sum[j] += Acc(int32_t(a[k]) * int32_t(b[j][k]));
+            }
+        }
+        std::copy_n(sum, 4, out);
+    }
+}
+
+// dotRows4 in 64 bits. int8 products are summed in int32 by the kernels, which is exact
+// for int32Depth elements, so longer rows are done in pieces of that length.
+template <typename Q>
+void dotRows4Wide(const Q *a, const Q *const *b, size_t n, int64_t *out)
+{
+    if constexpr (std::is_same_v<Q, int8_t>) {
+        // |a * b| <= 127 * 127, in whole blocks of 64 bytes
+        constexpr size_t int32Depth = size_t(INT32_MAX) / (127 * 127) / 64 * 64;
+        std::fill_n(out, 4, int64_t(0));
+        for (size_t k = 0; k < n; k += int32Depth) {
+            const Q *rows[4] = {b[0] + k, b[1] + k, b[2] + k, b[3] + k};
+            int32_t sums[4];
+            dotRows4(a + k, rows, std::min(int32Depth, n - k), sums);
+            for (size_t j = 0; j < 4; ++j) {
+                out[j] += sums[j];
+            }
+        }
+    }
+    else {
+        dotRows4(a, b, n, out);
+    }
+}
+
+template <typename Q>
+int64_t rowSum(const Q *row, size_t n)
+{
+    int64_t sum = 0;
+    for (size_t k = 0; k < n; ++k) {
+        sum += row[k];
+    }
+    return sum;
+}
+
+// Sum over k of (x(k) - zx) * (y(k) - zy), from the sum of the products and the sums of x and y.
+// The terms reach 255 x 255 for int8, so the sum is only guaranteed to fit in 64 bits.
+inline int64_t removeZeroPoints(int64_t products, int64_t sumX, int64_t sumY, int32_t zx, int32_t zy, size_t n)
+{
+    return products - int64_t(zy) * sumX - int64_t(zx) * sumY + int64_t(n) * int64_t(zx) * int64_t(zy);
+}
+
+// Call emit(i, j, sum) with the int64_t sums of ab^T, split across the rows of a
+template <typename Q, typename Emit>
+void quantGemm(const MyQuantMat<Q> &a, const MyQuantMat<Q> &b, Emit emit)
+{
+    assert(a.cols() == b.cols());
+    const size_t m = a.rows();
+    const size_t n = b.rows();
+    const size_t k = a.cols();
+    if (m == 0 || n == 0) {
+        return;
+    }
+    MYSTATS_SCOPE("quantGemm", m * n, 2 * m * n * k, (m * a.stride() + n * b.stride()) * sizeof(Q) + m * n * sizeof(QuantAccumulator<Q>));
+    std::vector<int64_t> sumA(m);
+    std::vector<int64_t> sumB(n);
+    for (size_t i = 0; i < m; ++i) {
+        sumA[i] = rowSum(a.row(i), a.stride());
+    }
+    for (size_t j = 0; j < n; ++j) {
+        sumB[j] = rowSum(b.row(j), b.stride());
+    }
+    // Panels of b that stay in L2 while every row of a tile goes over them
+    const size_t panelRows = std::max<size_t>(4, (256 * 1024 / std::max<size_t>(1, b.stride() * sizeof(Q))) / 4 * 4);
+    MyExec::ThreadPool *pool = MyExec::current().poolFor(m * n * k, MyExec::current().serialMultiplyAdds);
+    const size_t tiles = pool ? std::min(m, 4 * (pool->size() + 1)) : 1;
+    const size_t rowsPerTile = (m + tiles - 1) / tiles;
+    MyExec::forEachTile(pool, (m + rowsPerTile - 1) / rowsPerTile, [&](size_t t) {
+        const size_t iEnd = std::min(m, (t + 1) * rowsPerTile);
+        for (size_t jc = 0; jc < n; jc += panelRows) {
+            const size_t jEnd = std::min(n, jc + panelRows);
+            for (size_t i = t * rowsPerTile; i < iEnd; ++i) {
+                const int32_t za = a.params(i).zeroPoint;
+                for (size_t j = jc; j < jEnd; j += 4) {
+                    const Q *rows[4];
+                    for (size_t q = 0; q < 4; ++q) {
+                        rows[q] = b.row(std::min(j + q, n - 1));
+                    }
+                    int64_t sums[4];
+                    dotRows4Wide(a.row(i), rows, a.stride(), sums);
+                    for (size_t q = 0; q < 4 && j + q < jEnd; ++q) {
+                        emit(i, j + q, removeZeroPoints(sums[q], sumA[i], sumB[j + q], za, b.params(j + q).zeroPoint, k));
+                    }
+                }
+            }
+        }
+    });
+}
+
+// Call emit(i, sum) with the int64_t sums of Ax
+template <typename Q, typename Emit>
+void quantGemv(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x, Emit emit)
+{
+    assert(a.cols() == x.size());
+    const size_t m = a.rows();
+    const size_t k = a.cols();
+    if (m == 0) {
+        return;
+    }
+    MYSTATS_COUNT("quantGemv", m, 2 * m * k, (m + 1) * a.stride() * sizeof(Q) + m * sizeof(QuantAccumulator<Q>));
+    const int64_t sumX = rowSum(x.data(), a.stride());
+    const int32_t zx = x.params().zeroPoint;
+    MyExec::parallelFor<Q>((m + 3) / 4, 4 * a.stride(), [&](size_t begin, size_t end) {
+        for (size_t i = 4 * begin; i < std::min(m, 4 * end); i += 4) {
+            const Q *rows[4];
+            for (size_t q = 0; q < 4; ++q) {
+                rows[q] = a.row(std::min(i + q, m - 1));
+            }
+            int64_t sums[4];
+            dotRows4Wide(x.data(), rows, a.stride(), sums);
+            for (size_t q = 0; q < 4 && i + q < m; ++q) {
+                emit(i + q, removeZeroPoints(sums[q], rowSum(rows[q], a.stride()), sumX, a.params(i + q).zeroPoint, zx, k));
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+// MyQuantMat
+
+template <typename Q>
+MyQuantMat<Q>::MyQuantMat(size_t rows, size_t cols, QuantScheme scheme) :
+    data_(rows * detail::quantStride<Q>(cols), Q(0)),
+    params_(scheme == QuantScheme::PerRow ? rows : 1),
+    rows_(rows),
+    cols_(cols),
+    stride_(detail::quantStride<Q>(cols)),
+    scheme_(scheme)
+{
+    static_assert (isQuantType<Q>, "Quantized matrices hold int8_t or int16_t");
+}
+
+template <typename Q>
+Q& MyQuantMat<Q>::operator()(size_t row, size_t col)
+{
+    assert(row < rows_ && col < cols_);
+    return data_[row * stride_ + col];
+}
+
+template <typename Q>
+const Q& MyQuantMat<Q>::operator()(size_t row, size_t col) const
+{
+    assert(row < rows_ && col < cols_);
+    return data_[row * stride_ + col];
+}
+
+template <typename Q>
+const QuantParams& MyQuantMat<Q>::params(size_t row) const
+{
+    return params_[scheme_ == QuantScheme::PerRow ? row : 0];
+}
+
+template <typename Q>
+void MyQuantMat<Q>::setParams(size_t row, const QuantParams &params)
+{
+    params_[scheme_ == QuantScheme::PerRow ? row : 0] = params;
+}
+
+template <typename Q>
+float MyQuantMat<Q>::value(size_t row, size_t col) const
+{
+    const QuantParams &p = params(row);
+    return p.scale * float(int32_t((*this)(row, col)) - p.zeroPoint);
+}
+
+template <typename Q>
+std::ostream& MyQuantMat<Q>::renderToStream(std::ostream &os) const
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) {
+            os << int32_t((*this)(i,j)) << " ";
+        }
+        if (scheme_ == QuantScheme::PerRow || i + 1 == rows_) {
+            os << "(scale " << params(i).scale << ", zero point " << params(i).zeroPoint << ")";
+        }
+        os << "\n";
+    }
+    return os;
+}
+
+// MyQuantVec
+
+template <typename Q>
+MyQuantVec<Q>::MyQuantVec(size_t n, const QuantParams &params) :
+    data_(detail::quantStride<Q>(n), Q(0)),
+    params_(params),
+    size_(n)
+{
+    static_assert (isQuantType<Q>, "Quantized vectors hold int8_t or int16_t");
+}
+
+template <typename Q>
+Q& MyQuantVec<Q>::operator[](size_t i)
+{
+    assert(i < size_);
+    return data_[i];
+}
+
+template <typename Q>
+const Q& MyQuantVec<Q>::operator[](size_t i) const
+{
+    assert(i < size_);
+    return data_[i];
+}
+
+template <typename Q>
+float MyQuantVec<Q>::value(size_t i) const
+{
+    return params_.scale * float(int32_t((*this)[i]) - params_.zeroPoint);
+}
+
+template <typename Q>
+std::ostream& MyQuantVec<Q>::renderToStream(std::ostream &os) const
+{
+    for (size_t i = 0; i < size_; ++i) {
+        os << int32_t(data_[i]) << " ";
+    }
+    return os << "(scale " << params_.scale << ", zero point " << params_.zeroPoint << ")";
+}
+
+// Related non-members
+
+template <typename Q>
+QuantParams chooseQuantParams(float min, float max)
+{
+    static_assert (isQuantType<Q>, "Quantized values are int8_t or int16_t");
+    const float lo = std::min(min, 0.0f);
+    const float hi = std::max(max, 0.0f);
+    if (!(hi > lo)) {
+        return QuantParams();
+    }
+    QuantParams p;
+    p.scale = (hi - lo) / float(detail::quantMax<Q> - detail::quantMin<Q>);
+    long zero = std::lrint(float(detail::quantMin<Q>) - lo / p.scale);
+    p.zeroPoint = static_cast<int32_t>(std::clamp<long>(zero, detail::quantMin<Q>, detail::quantMax<Q>));
+    return p;
+}
+
+template <typename Q, typename M, typename>
+MyQuantMat<Q> quantize(const M &m, QuantScheme scheme)
+{
+    using T = std::remove_const_t<typename M::value_type>;
+    static_assert (std::is_floating_point_v<T>, "Quantize floating point values");
+    auto v = m.view();
+    MYSTATS_SCOPE("quantize", v.size(), 2 * v.size(), v.size() * (sizeof(T) + sizeof(Q)));
+    MyQuantMat<Q> q(v.rows(), v.cols(), scheme);
+    auto range = [&v](size_t i, T &lo, T &hi) {
+        for (size_t j = 0; j < v.cols(); ++j) {
+            lo = std::min(lo, v(i,j));
+            hi = std::max(hi, v(i,j));
+        }
+    };
+    if (scheme == QuantScheme::PerTensor) {
+        T lo = 0;
+        T hi = 0;
+        for (size_t i = 0; i < v.rows(); ++i) {
+            range(i, lo, hi);
+        }
+        q.setParams(0, chooseQuantParams<Q>(float(lo), float(hi)));
+    }
+    MyExec::parallelFor<T>(v.rows(), v.cols(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            if (scheme == QuantScheme::PerRow) {
+                T lo = 0;
+                T hi = 0;
+                range(i, lo, hi);
+                q.setParams(i, chooseQuantParams<Q>(float(lo), float(hi)));
+            }
+            const QuantParams p = q.params(i);
+            Q *row = q.row(i);
+            for (size_t j = 0; j < v.cols(); ++j) {
+                row[j] = detail::quantizeValue<Q>(v(i,j), p);
+            }
+        }
+    });
+    return q;
+}
+
+template <typename Q, typename T, typename A>
+MyQuantVec<Q> quantize(const MyVector::MyDynVec<T,A> &x)
+{
+    static_assert (std::is_floating_point_v<T>, "Quantize floating point values");
+    T lo = 0;
+    T hi = 0;
+    for (size_t i = 0; i < x.size(); ++i) {
+        lo = std::min(lo, x[i]);
+        hi = std::max(hi, x[i]);
+    }
+    MyQuantVec<Q> q(x.size(), chooseQuantParams<Q>(float(lo), float(hi)));
+    for (size_t i = 0; i < x.size(); ++i) {
+        q[i] = detail::quantizeValue<Q>(x[i], q.params());
+    }
+    return q;
+}
+
+template <typename Q, typename T, size_t N>
+MyQuantVec<Q> quantize(const MyVector::MyVec<T,N> &x)
+{
+    return quantize<Q>(MyVector::MyDynVec<T>(x));
+}
+
+template <typename Q>
+MyDynMat<float> dequantize(const MyQuantMat<Q> &q)
+{
+    MyDynMat<float> m(q.rows(), q.cols());
+    MyExec::parallelFor<float>(q.rows(), q.cols(), [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < q.cols(); ++j) {
+                m(i,j) = q.value(i, j);
+            }
+        }
+    });
+    return m;
+}
+
+template <typename Q>
+MyVector::MyDynVec<float> dequantize(const MyQuantVec<Q> &q)
+{
+    MyVector::MyDynVec<float> x(q.size());
+    for (size_t i = 0; i < q.size(); ++i) {
+        x[i] = q.value(i);
+    }
+    return x;
+}
+
+template <typename Q>
+void multiplyTransposed(const MyQuantMat<Q> &a, const MyQuantMat<Q> &b, MyMatView<QuantAccumulator<Q>> c)
+{
+    assert(c.rows() == a.rows() && c.cols() == b.rows());
+    assert(a.cols() <= quantExactDepth<Q>);
+    detail::quantGemm(a, b, [&c](size_t i, size_t j, int64_t sum) { c(i,j) = QuantAccumulator<Q>(sum); });
+}
+
+template <typename Q>
+MyDynMat<float> multiplyTransposed(const MyQuantMat<Q> &a, const MyQuantMat<Q> &b)
+{
+    MyDynMat<float> c(a.rows(), b.rows());
+    detail::quantGemm(a, b, [&](size_t i, size_t j, int64_t sum) {
+        c(i,j) = a.params(i).scale * b.params(j).scale * float(sum);
+    });
+    return c;
+}
+
+template <typename Q, typename A>
+void multiply(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x, MyVector::MyDynVec<QuantAccumulator<Q>,A> &y)
+{
+    assert(y.size() == a.rows());
+    assert(a.cols() <= quantExactDepth<Q>);
+    detail::quantGemv(a, x, [&y](size_t i, int64_t sum) { y[i] = QuantAccumulator<Q>(sum); });
+}
+
+template <typename Q>
+MyVector::MyDynVec<float> multiply(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x)
+{
+    MyVector::MyDynVec<float> y(a.rows());
+    const float sx = x.params().scale;
+    detail::quantGemv(a, x, [&](size_t i, int64_t sum) { y[i] = a.params(i).scale * sx * float(sum); });
+    return y;
+}
+
+template <typename Q>
+MyVector::MyDynVec<float> operator*(const MyQuantMat<Q> &a, const MyQuantVec<Q> &x)
+{
+    return multiply(a, x);
+}
+
+template <typename Q>
+std::ostream& operator<<(std::ostream &os, const MyQuantMat<Q> &m)
+{
+    return m.renderToStream(os);
+}
+
+template <typename Q>
+std::ostream& operator<<(std::ostream &os, const MyQuantVec<Q> &x)
+{
+    return x.renderToStream(os);
+}
+
+} // namespace MyMatrix
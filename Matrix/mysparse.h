@@ -0,0 +1,177 @@
+//
+//  mysparse.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYSPARSE_H
+#define MYSPARSE_H
+
+#include <iostream>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "allocator.h"
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "mystats.h"
+
+/*!
+ * \brief Sparse matrices, for matrices that are mostly zeros
+ * \details A sparse matrix is assembled as a MyCooMat, a list of (row, column, value)
+ * entries in any order, and then compressed into a MyCsrMat for computation:
+ *
+ * \verbatim
+ * MyCooMat<> coo(n, n);
+ * coo.add(0, 0, 4.0);
+ * coo.add(0, 1, -1.0);
+ * ...
+ * MyCsrMat<> a(coo);            // entries at the same position are summed
+ * MyDynVec<> y = a * x;         // sparse matrix x vector
+ * MyDynMat<> c = a * b;         // sparse matrix x dense matrix
+ * \endverbatim
+ *
+ * MyCsrMat stores the nonzero elements row by row (compressed sparse row): their values,
+ * their column indices in increasing order within each row, and the offset of every row
+ * in those two arrays. A matrix takes about 12 bytes per nonzero element for double,
+ * instead of 8 bytes per element for a dense one. The sparsity pattern is fixed once
+ * built, but the values can be changed in place.
+ *
+ * The products with a dense vector or matrix are split across the rows of the sparse
+ * matrix, and run in parallel when large enough (see myexec.h). The allocation-free
+ * versions, that write to an existing vector or matrix, suit iterative solvers.
+ *
+ * A MyCsrMat can be built from any dense matrix or view, keeping its nonzero elements,
+ * and converted back with toDense() or toFixed().
+ */
+namespace MyMatrix {
+
+template <typename T = double>
+class MyCooMat {
+public:
+    using value_type = T;
+
+    MyCooMat() = default;
+    MyCooMat(size_t rows, size_t cols);
+
+    void reserve(size_t nonZeros);
+    void clear() noexcept;
+
+    // Add value at (row, col), to anything already added at the same position
+    void add(size_t row, size_t col, T value);
+
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    size_t nonZeros() const noexcept { return values_.size(); }
+
+    // The entries in the order they were added
+    const size_t* rowIndices() const noexcept { return rowIdx_.data(); }
+    const size_t* columnIndices() const noexcept { return colIdx_.data(); }
+    const T* values() const noexcept { return values_.data(); }
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    std::vector<size_t> rowIdx_;
+    std::vector<size_t> colIdx_;
+    std::vector<T> values_;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+};
+
+template <typename T = double, typename Alloc = MyMemory::AlignedAllocator<T>>
+class MyCsrMat {
+public:
+    using value_type = T;
+    using index_type = uint32_t;
+    using allocator_type = Alloc;
+
+    explicit MyCsrMat(const Alloc &alloc = Alloc());
+    // A rows x cols matrix of zeros
+    MyCsrMat(size_t rows, size_t cols, const Alloc &alloc = Alloc());
+    explicit MyCsrMat(const MyCooMat<T> &, const Alloc &alloc = Alloc());
+
+    // The nonzero elements of a dense matrix or view
+    template <typename M, typename = std::enable_if_t<isMatrix<M>>>
+    explicit MyCsrMat(const M &, const Alloc &alloc = Alloc());
+
+    ~MyCsrMat() = default;
+
+    MyCsrMat(const MyCsrMat &) = default;
+    MyCsrMat& operator=(const MyCsrMat &) = default;
+
+    MyCsrMat(MyCsrMat &&) noexcept = default;
+    MyCsrMat& operator=(MyCsrMat &&) noexcept = default;
+
+    MyDynMat<T,Alloc> toDense() const;
+    template <size_t R, size_t C, Layout L = Layout::RowMajor>
+    MyMat<T,R,C,L> toFixed() const;
+
+    MyCsrMat copyTransposed() const;
+
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    size_t nonZeros() const noexcept { return values_.size(); }
+
+    // Element (row, col), zero when it isn't stored
+    T operator()(size_t row, size_t col) const;
+
+    // The nonzero elements of row i are at [rowOffsets()[i], rowOffsets()[i + 1])
+    const size_t* rowOffsets() const noexcept { return offsets_.data(); }
+    const index_type* columnIndices() const noexcept { return columns_.data(); }
+    T* values() noexcept { return values_.data(); }
+    const T* values() const noexcept { return values_.data(); }
+
+    allocator_type get_allocator() const { return values_.get_allocator(); }
+
+    MyCsrMat& operator*=(double);
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    template <typename U>
+    using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+    std::vector<size_t, Rebind<size_t>> offsets_;
+    std::vector<index_type, Rebind<index_type>> columns_;
+    std::vector<T, Alloc> values_;
+    size_t rows_ = 0;
+    size_t cols_ = 0;
+};
+
+// Sparse matrix x vector, x must have a.cols() elements
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> multiply(const MyCsrMat<T,A> &, const MyVector::MyDynVec<T,A2> &);
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> operator*(const MyCsrMat<T,A> &, const MyVector::MyDynVec<T,A2> &);
+
+// y = ax without allocating, y must have a.rows() elements and can't be x
+template <typename T, typename A, typename A2, typename A3>
+void multiply(const MyCsrMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x, MyVector::MyDynVec<T,A3> &y);
+template <typename T, typename A, size_t C, size_t R>
+void multiply(const MyCsrMat<T,A> &a, const MyVector::MyVec<T,C> &x, MyVector::MyVec<T,R> &y);
+
+// Sparse matrix x dense matrix or view, b must have a.cols() rows
+template <typename T, typename A, typename M, typename = std::enable_if_t<isMatrix<M>>>
+MyDynMat<T> multiply(const MyCsrMat<T,A> &, const M &);
+template <typename T, typename A, typename M, typename = std::enable_if_t<isMatrix<M>>>
+MyDynMat<T> operator*(const MyCsrMat<T,A> &, const M &);
+
+// c = ab without allocating, c must be a.rows() x b.cols() and can't overlap b
+template <typename T, typename A, typename U>
+void multiply(const MyCsrMat<T,A> &a, MyMatView<U> b, MyMatView<T> c);
+
+// Render the nonzero elements as "(row, col) value" lines
+template <typename T>
+std::ostream& operator<<(std::ostream &, const MyCooMat<T> &);
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &, const MyCsrMat<T,A> &);
+
+} // namespace MyMatrix
+
+#include "mysparse.tpp"
+
+#endif // MYSPARSE_H
@@ -0,0 +1,382 @@
+//
+//  mysparse.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace MyMatrix {
+
+namespace detail {
+
+// Average number of elements a row of the sparse matrix touches, to size parallel tiles
+template <typename T, typename A>
+size_t sparseRowWidth(const MyCsrMat<T,A> &a)
+{
+    return a.rows() ? a.nonZeros() / a.rows() + 1 : 1;
+}
+
+template <typename T, typename A>
+void spmv(const MyCsrMat<T,A> &a, const T *x, T *y)
+{
+    const size_t *offsets = a.rowOffsets();
+    const auto *columns = a.columnIndices();
+    const T *values = a.values();
+    MYSTATS_COUNT("spmv", a.rows(), 2 * a.nonZeros(), a.nonZeros() * (2 * sizeof(T) + sizeof(*columns)) + a.rows() * sizeof(T));
+    MyExec::parallelFor<T>(a.rows(), sparseRowWidth(a), [=](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            T sum = 0;
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                sum += values[k] * x[columns[k]];
+            }
+            y[i] = sum;
+        }
+    });
+}
+
+// Each row of c accumulates rows of b, scaled by the nonzero elements of the same row of a
+template <typename T, typename A, typename U>
+void spmm(const MyCsrMat<T,A> &a, const MyMatView<U> &b, const MyMatView<T> &c)
+{
+    const size_t *offsets = a.rowOffsets();
+    const auto *columns = a.columnIndices();
+    const T *values = a.values();
+    size_t n = b.cols();
+    if (n == 0) {
+        return;
+    }
+    MYSTATS_SCOPE("spmm", c.size(), 2 * a.nonZeros() * n, (a.nonZeros() * (n + 1) + c.size()) * sizeof(T));
+    bool unitStride = (b.colStride() == 1 || n == 1) && (c.colStride() == 1 || n == 1);
+    MyExec::parallelFor<T>(a.rows(), sparseRowWidth(a) * n, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            T *crow = &c(i, 0);
+            if (unitStride) {
+                std::fill_n(crow, n, T(0));
+            }
+            else {
+                for (size_t j = 0; j < n; ++j) {
+                    crow[static_cast<ptrdiff_t>(j) * c.colStride()] = T(0);
+                }
+            }
+            for (size_t k = offsets[i]; k < offsets[i + 1]; ++k) {
+                T v = values[k];
+                const T *brow = &b(columns[k], 0);
+                if (unitStride) {
+                    for (size_t j = 0; j < n; ++j) {
+                        crow[j] += v * brow[j];
+                    }
+                }
+                else {
+                    for (size_t j = 0; j < n; ++j) {
+                        crow[static_cast<ptrdiff_t>(j) * c.colStride()] += v * brow[static_cast<ptrdiff_t>(j) * b.colStride()];
+                    }
+                }
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+// MyCooMat
+
+template <typename T>
+MyCooMat<T>::MyCooMat(size_t rows, size_t cols) :
+    rows_(rows),
+    cols_(cols)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyCooMat requires an arithmetic type");
+}
+
+template <typename T>
+void MyCooMat<T>::reserve(size_t nonZeros)
+{
+    rowIdx_.reserve(nonZeros);
+    colIdx_.reserve(nonZeros);
+    values_.reserve(nonZeros);
+}
+
+template <typename T>
+void MyCooMat<T>::clear() noexcept
+{
+    rowIdx_.clear();
+    colIdx_.clear();
+    values_.clear();
+}
+
+template <typename T>
+void MyCooMat<T>::add(size_t row, size_t col, T value)
+{
+    assert(row < rows_ && col < cols_);
+    rowIdx_.push_back(row);
+    colIdx_.push_back(col);
+    values_.push_back(value);
+}
+
+template <typename T>
+std::ostream& MyCooMat<T>::renderToStream(std::ostream &os) const
+{
+    for (size_t k = 0; k < values_.size(); ++k) {
+        os << "(" << rowIdx_[k] << ", " << colIdx_[k] << ") " << values_[k] << "\n";
+    }
+
+    return os;
+}
+
+// MyCsrMat
+
+template <typename T, typename A>
+MyCsrMat<T,A>::MyCsrMat(const A &alloc) :
+    offsets_(1, 0, Rebind<size_t>(alloc)),
+    columns_(Rebind<index_type>(alloc)),
+    values_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyCsrMat requires an arithmetic type");
+}
+
+template <typename T, typename A>
+MyCsrMat<T,A>::MyCsrMat(size_t rows, size_t cols, const A &alloc) :
+    offsets_(rows + 1, 0, Rebind<size_t>(alloc)),
+    columns_(Rebind<index_type>(alloc)),
+    values_(alloc),
+    rows_(rows),
+    cols_(cols)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyCsrMat requires an arithmetic type");
+    assert(cols <= std::numeric_limits<index_type>::max());
+}
+
+// Two stable counting sorts, by column and then by row, leave every row sorted by
+// column. Duplicates are then adjacent, and summed.
+template <typename T, typename A>
+MyCsrMat<T,A>::MyCsrMat(const MyCooMat<T> &coo, const A &alloc) :
+    MyCsrMat(coo.rows(), coo.cols(), alloc)
+{
+    size_t nnz = coo.nonZeros();
+    const size_t *rowIdx = coo.rowIndices();
+    const size_t *colIdx = coo.columnIndices();
+
+    std::vector<size_t> colStart(cols_ + 1, 0);
+    for (size_t k = 0; k < nnz; ++k) {
+        ++colStart[colIdx[k] + 1];
+    }
+    for (size_t j = 0; j < cols_; ++j) {
+        colStart[j + 1] += colStart[j];
+    }
+    std::vector<size_t> byColumn(nnz);
+    for (size_t k = 0; k < nnz; ++k) {
+        byColumn[colStart[colIdx[k]]++] = k;
+    }
+
+    for (size_t k = 0; k < nnz; ++k) {
+        ++offsets_[rowIdx[k] + 1];
+    }
+    for (size_t i = 0; i < rows_; ++i) {
+        offsets_[i + 1] += offsets_[i];
+    }
+    columns_.resize(nnz);
+    values_.resize(nnz);
+    std::vector<size_t> next(offsets_.begin(), offsets_.end() - 1);
+    for (size_t k : byColumn) {
+        size_t dst = next[rowIdx[k]]++;
+        columns_[dst] = static_cast<index_type>(colIdx[k]);
+        values_[dst] = coo.values()[k];
+    }
+
+    size_t out = 0;
+    for (size_t i = 0; i < rows_; ++i) {
+        size_t begin = offsets_[i];
+        size_t end = offsets_[i + 1];
+        offsets_[i] = out;
+        for (size_t k = begin; k < end; ++k) {
+            if (out > offsets_[i] && columns_[out - 1] == columns_[k]) {
+                values_[out - 1] += values_[k];
+            }
+            else {
+                columns_[out] = columns_[k];
+                values_[out] = values_[k];
+                ++out;
+            }
+        }
+    }
+    offsets_[rows_] = out;
+    columns_.resize(out);
+    values_.resize(out);
+}
+
+template <typename T, typename A>
+template <typename M, typename>
+MyCsrMat<T,A>::MyCsrMat(const M &dense, const A &alloc) :
+    MyCsrMat(dense.rows(), dense.cols(), alloc)
+{
+    static_assert (std::is_same_v<typename M::value_type, T>, "Matrix has a different value type");
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) {
+            T v = dense(i,j);
+            if (v != T(0)) {
+                columns_.push_back(static_cast<index_type>(j));
+                values_.push_back(v);
+            }
+        }
+        offsets_[i + 1] = values_.size();
+    }
+}
+
+template <typename T, typename A>
+MyDynMat<T,A> MyCsrMat<T,A>::toDense() const
+{
+    MyDynMat<T,A> dense(rows_, cols_, values_.get_allocator());
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+            dense(i, columns_[k]) = values_[k];
+        }
+    }
+    return dense;
+}
+
+template <typename T, typename A>
+template <size_t R, size_t C, Layout L>
+MyMat<T,R,C,L> MyCsrMat<T,A>::toFixed() const
+{
+    assert(rows_ == R && cols_ == C);
+    MyMat<T,R,C,L> dense;
+    for (size_t i = 0; i < R; ++i) {
+        for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+            dense(i, columns_[k]) = values_[k];
+        }
+    }
+    return dense;
+}
+
+// A counting sort by column. Rows are visited in order, so each row of the result is sorted.
+template <typename T, typename A>
+MyCsrMat<T,A> MyCsrMat<T,A>::copyTransposed() const
+{
+    MyCsrMat copy(cols_, rows_, values_.get_allocator());
+    size_t nnz = values_.size();
+    copy.columns_.resize(nnz);
+    copy.values_.resize(nnz);
+    for (size_t k = 0; k < nnz; ++k) {
+        ++copy.offsets_[columns_[k] + 1];
+    }
+    for (size_t j = 0; j < cols_; ++j) {
+        copy.offsets_[j + 1] += copy.offsets_[j];
+    }
+    std::vector<size_t> next(copy.offsets_.begin(), copy.offsets_.end() - 1);
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+            size_t dst = next[columns_[k]]++;
+            copy.columns_[dst] = static_cast<index_type>(i);
+            copy.values_[dst] = values_[k];
+        }
+    }
+    return copy;
+}
+
+template <typename T, typename A>
+T MyCsrMat<T,A>::operator()(size_t row, size_t col) const
+{
+    assert(row < rows_ && col < cols_);
+    auto first = columns_.begin() + static_cast<ptrdiff_t>(offsets_[row]);
+    auto last = columns_.begin() + static_cast<ptrdiff_t>(offsets_[row + 1]);
+    auto it = std::lower_bound(first, last, static_cast<index_type>(col));
+    if (it == last || *it != col) {
+        return T(0);
+    }
+    return values_[static_cast<size_t>(it - columns_.begin())];
+}
+
+template <typename T, typename A>
+MyCsrMat<T,A>& MyCsrMat<T,A>::operator*=(double rhs)
+{
+    T *d = values_.data();
+    MyExec::parallelFor<T>(values_.size(), 1, [d, rhs](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            d[k] *= rhs;
+        }
+    });
+    return *this;
+}
+
+template <typename T, typename A>
+std::ostream& MyCsrMat<T,A>::renderToStream(std::ostream &os) const
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t k = offsets_[i]; k < offsets_[i + 1]; ++k) {
+            os << "(" << i << ", " << columns_[k] << ") " << values_[k] << "\n";
+        }
+    }
+
+    return os;
+}
+
+// Related non-members
+
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> multiply(const MyCsrMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x)
+{
+    MyVector::MyDynVec<T,A2> y(a.rows(), x.get_allocator());
+    multiply(a, x, y);
+    return y;
+}
+
+template <typename T, typename A, typename A2>
+MyVector::MyDynVec<T,A2> operator*(const MyCsrMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x)
+{
+    return multiply(a, x);
+}
+
+template <typename T, typename A, typename A2, typename A3>
+void multiply(const MyCsrMat<T,A> &a, const MyVector::MyDynVec<T,A2> &x, MyVector::MyDynVec<T,A3> &y)
+{
+    assert(x.size() == a.cols() && y.size() == a.rows());
+    detail::spmv(a, x.data(), y.data());
+}
+
+template <typename T, typename A, size_t C, size_t R>
+void multiply(const MyCsrMat<T,A> &a, const MyVector::MyVec<T,C> &x, MyVector::MyVec<T,R> &y)
+{
+    assert(a.rows() == R && a.cols() == C);
+    detail::spmv(a, x.data(), y.data());
+}
+
+template <typename T, typename A, typename M, typename>
+MyDynMat<T> multiply(const MyCsrMat<T,A> &a, const M &b)
+{
+    static_assert (std::is_same_v<typename M::value_type, T>, "Matrices must have the same value type");
+    MyDynMat<T> c(a.rows(), b.cols());
+    multiply(a, b.view(), c.view());
+    return c;
+}
+
+template <typename T, typename A, typename M, typename>
+MyDynMat<T> operator*(const MyCsrMat<T,A> &a, const M &b)
+{
+    return multiply(a, b);
+}
+
+template <typename T, typename A, typename U>
+void multiply(const MyCsrMat<T,A> &a, MyMatView<U> b, MyMatView<T> c)
+{
+    static_assert (std::is_same_v<std::remove_const_t<U>, T>, "Matrices must have the same value type");
+    assert(b.rows() == a.cols() && c.rows() == a.rows() && c.cols() == b.cols());
+    detail::spmm(a, b, c);
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream &os, const MyCooMat<T> &m)
+{
+    return m.renderToStream(os);
+}
+
+template <typename T, typename A>
+std::ostream& operator<<(std::ostream &os, const MyCsrMat<T,A> &m)
+{
+    return m.renderToStream(os);
+}
+
+} // namespace MyMatrix
@@ -0,0 +1,169 @@
+//
+//  mystats.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYSTATS_H
+#define MYSTATS_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "simd.h"
+
+/*!
+ * \brief Optional counters of the calls, elements, FLOPs and bytes of the operations
+ * \details When MATRIX_INSTRUMENT is defined (the CMake option of the same name), the
+ * matrix and vector operations count their calls, the elements they produce, an
+ * estimate of their floating point operations and of the bytes they read and write.
+ * There is one counter per call site of every template instantiation, named after the
+ * operation and the signature of the function, so the counts tell MyMat<float,4,4>
+ * from MyDynMat<double>. Heap allocations of the containers are counted as "allocate",
+ * which shows the temporaries. The large kernels (gemm, decompositions, I/O) are also
+ * timed.
+ *
+ * \verbatim
+ * MyStats::reset();
+ * runWorkload();
+ * MyStats::dump(std::cout);                  // one line per operation and instantiation
+ * for (const MyStats::Stat &s : MyStats::snapshot()) { ... }
+ * MyStats::setHook([](const MyStats::Event &e) { trace(e.operation, e.nanoseconds); });
+ * \endverbatim
+ *
+ * The hook is called on the thread of the operation for every counted call, and must be
+ * thread safe. Without MATRIX_INSTRUMENT, the MYSTATS macros expand to nothing and the
+ * operations are exactly the uninstrumented code, the functions here just report that
+ * nothing was counted.
+ *
+ * Counting works in constexpr functions, and is skipped when they run at compile time.
+ * Compilers without std::is_constant_evaluated don't count the constexpr operations.
+ */
+namespace MyStats {
+
+// One counted call, as passed to the hook
+struct Event {
+    const char *operation;
+    const char *function;       // signature of the instantiation
+    uint64_t elements;
+    uint64_t flops;
+    uint64_t bytes;
+    uint64_t nanoseconds;       // 0 for operations that aren't timed
+};
+
+using Hook = void (*)(const Event &);
+
+// Totals of the calls of an operation in one instantiation
+struct Stat {
+    std::string operation;
+    std::string function;
+    uint64_t calls = 0;
+    uint64_t elements = 0;
+    uint64_t flops = 0;
+    uint64_t bytes = 0;
+    uint64_t nanoseconds = 0;
+};
+
+class Counter {
+public:
+    Counter(const char *operation, const char *function) noexcept;
+
+    Counter(const Counter &) = delete;
+    Counter& operator=(const Counter &) = delete;
+
+    void add(uint64_t elements, uint64_t flops, uint64_t bytes, uint64_t nanoseconds = 0) noexcept;
+    Stat stat() const;
+    void reset() noexcept;
+
+private:
+    const char *operation_;
+    const char *function_;
+    std::atomic<uint64_t> calls_{0};
+    std::atomic<uint64_t> elements_{0};
+    std::atomic<uint64_t> flops_{0};
+    std::atomic<uint64_t> bytes_{0};
+    std::atomic<uint64_t> nanoseconds_{0};
+};
+
+// The counter of a call site, created on first use. Site is a type unique to the call site,
+// the MYSTATS macros pass the type of an empty lambda.
+template <typename Site>
+Counter& counter(Site, const char *operation, const char *function);
+
+// Time from construction to destruction, added to a counter
+class Scope {
+public:
+    Scope(Counter &, uint64_t elements, uint64_t flops, uint64_t bytes) noexcept;
+    ~Scope();
+
+    Scope(const Scope &) = delete;
+    Scope& operator=(const Scope &) = delete;
+
+private:
+    Counter &counter_;
+    uint64_t elements_;
+    uint64_t flops_;
+    uint64_t bytes_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Whether the library was built with MATRIX_INSTRUMENT
+constexpr bool enabled() noexcept
+{
+#if defined(MATRIX_INSTRUMENT)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// Route every counted call to hook, nullptr to stop
+void setHook(Hook hook) noexcept;
+Hook hook() noexcept;
+
+// Totals per operation and instantiation, merging the call sites of a function
+std::vector<Stat> snapshot();
+// Zero every counter
+void reset() noexcept;
+// Write the snapshot as a table, the slowest and then the most bytes first
+void dump(std::ostream &);
+
+namespace detail {
+
+template <typename Site>
+constexpr void count(Site site, const char *operation, const char *function,
+                     uint64_t elements, uint64_t flops, uint64_t bytes)
+{
+    if (!MySimd::isConstantEvaluated()) {
+        counter(site, operation, function).add(elements, flops, bytes);
+    }
+}
+
+} // namespace detail
+
+} // namespace MyStats
+
+#if defined(MATRIX_INSTRUMENT)
+#if defined(_MSC_VER)
+#define MYSTATS_FUNCTION __FUNCSIG__
+#else
+#define MYSTATS_FUNCTION __PRETTY_FUNCTION__
+#endif
+// Count a call of operation, producing elements with flops operations and bytes of memory traffic
+#define MYSTATS_COUNT(operation, elements, flops, bytes) \
+    MyStats::detail::count([]{}, operation, MYSTATS_FUNCTION, elements, flops, bytes)
+// Count and time the rest of the enclosing scope
+#define MYSTATS_SCOPE(operation, elements, flops, bytes) \
+    MyStats::Scope mystatsScope_(MyStats::counter([]{}, operation, MYSTATS_FUNCTION), elements, flops, bytes)
+#else
+#define MYSTATS_COUNT(operation, elements, flops, bytes) ((void)0)
+#define MYSTATS_SCOPE(operation, elements, flops, bytes) ((void)0)
+#endif
+
+#include "mystats.tpp"
+
+#endif // MYSTATS_H
@@ -0,0 +1,179 @@
+//
+//  mystats.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace MyStats {
+
+namespace detail {
+
+struct Registry {
+    std::mutex mutex;
+    std::deque<Counter> counters;   // a deque doesn't move the counters the call sites refer to
+    std::atomic<Hook> hook{nullptr};
+};
+
+inline Registry& registry()
+{
+    static Registry r;
+    return r;
+}
+
+inline Counter& addCounter(const char *operation, const char *function)
+{
+    Registry &r = registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    return r.counters.emplace_back(operation, function);
+}
+
+} // namespace detail
+
+// Counter
+
+inline Counter::Counter(const char *operation, const char *function) noexcept :
+    operation_(operation),
+    function_(function)
+{
+}
+
+inline void Counter::add(uint64_t elements, uint64_t flops, uint64_t bytes, uint64_t nanoseconds) noexcept
+{
+    calls_.fetch_add(1, std::memory_order_relaxed);
+    elements_.fetch_add(elements, std::memory_order_relaxed);
+    flops_.fetch_add(flops, std::memory_order_relaxed);
+    bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    nanoseconds_.fetch_add(nanoseconds, std::memory_order_relaxed);
+    if (Hook h = hook()) {
+        h(Event{operation_, function_, elements, flops, bytes, nanoseconds});
+    }
+}
+
+inline Stat Counter::stat() const
+{
+    Stat s;
+    s.operation = operation_;
+    s.function = function_;
+    s.calls = calls_.load(std::memory_order_relaxed);
+    s.elements = elements_.load(std::memory_order_relaxed);
+    s.flops = flops_.load(std::memory_order_relaxed);
+    s.bytes = bytes_.load(std::memory_order_relaxed);
+    s.nanoseconds = nanoseconds_.load(std::memory_order_relaxed);
+    return s;
+}
+
+inline void Counter::reset() noexcept
+{
+    calls_.store(0, std::memory_order_relaxed);
+    elements_.store(0, std::memory_order_relaxed);
+    flops_.store(0, std::memory_order_relaxed);
+    bytes_.store(0, std::memory_order_relaxed);
+    nanoseconds_.store(0, std::memory_order_relaxed);
+}
+
+template <typename Site>
+Counter& counter(Site, const char *operation, const char *function)
+{
+    static Counter &c = detail::addCounter(operation, function);
+    return c;
+}
+
+// Scope
+
+inline Scope::Scope(Counter &counter, uint64_t elements, uint64_t flops, uint64_t bytes) noexcept :
+    counter_(counter),
+    elements_(elements),
+    flops_(flops),
+    bytes_(bytes),
+    start_(std::chrono::steady_clock::now())
+{
+}
+
+inline Scope::~Scope()
+{
+    auto elapsed = std::chrono::steady_clock::now() - start_;
+    counter_.add(elements_, flops_, bytes_,
+                 static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()));
+}
+
+// Related non-members
+
+inline void setHook(Hook hook) noexcept
+{
+    detail::registry().hook.store(hook, std::memory_order_release);
+}
+
+inline Hook hook() noexcept
+{
+    return detail::registry().hook.load(std::memory_order_acquire);
+}
+
+inline std::vector<Stat> snapshot()
+{
+    detail::Registry &r = detail::registry();
+    std::map<std::pair<std::string, std::string>, Stat> merged;
+    {
+        std::lock_guard<std::mutex> lock(r.mutex);
+        for (const Counter &c : r.counters) {
+            Stat s = c.stat();
+            if (s.calls == 0) {
+                continue;
+            }
+            Stat &m = merged[{s.operation, s.function}];
+            if (m.calls == 0) {
+                m.operation = s.operation;
+                m.function = s.function;
+            }
+            m.calls += s.calls;
+            m.elements += s.elements;
+            m.flops += s.flops;
+            m.bytes += s.bytes;
+            m.nanoseconds += s.nanoseconds;
+        }
+    }
+    std::vector<Stat> stats;
+    stats.reserve(merged.size());
+    for (auto &entry : merged) {
+        stats.push_back(std::move(entry.second));
+    }
+    std::sort(stats.begin(), stats.end(), [](const Stat &a, const Stat &b) {
+        return std::make_pair(a.nanoseconds, a.bytes) > std::make_pair(b.nanoseconds, b.bytes);
+    });
+    return stats;
+}
+
+inline void reset() noexcept
+{
+    detail::Registry &r = detail::registry();
+    std::lock_guard<std::mutex> lock(r.mutex);
+    for (Counter &c : r.counters) {
+        c.reset();
+    }
+}
+
+inline void dump(std::ostream &os)
+{
+    if (!enabled()) {
+        os << "MyStats: build with MATRIX_INSTRUMENT to count the operations\n";
+        return;
+    }
+    char line[128];
+    std::snprintf(line, sizeof(line), "%12s %14s %12s %12s %10s  %s\n", "calls", "elements", "MFLOP", "MB", "ms", "operation");
+    os << line;
+    for (const Stat &s : snapshot()) {
+        std::snprintf(line, sizeof(line), "%12llu %14llu %12.3f %12.3f %10.3f  ",
+                      static_cast<unsigned long long>(s.calls), static_cast<unsigned long long>(s.elements),
+                      s.flops * 1e-6, s.bytes * 1e-6, s.nanoseconds * 1e-6);
+        os << line << s.operation << "  " << s.function << "\n";
+    }
+}
+
+} // namespace MyStats
@@ -0,0 +1,89 @@
+//
+//  mytext.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYTEXT_H
+#define MYTEXT_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myview.h"
+#include "myexec.h"
+#include "myio.h"
+#include "mystats.h"
+
+/*!
+ * \brief Text import and export of matrices, one row per line
+ * \details writeText formats a matrix or a view with one row per line and the elements
+ * separated by a space, or by another separator such as a comma for CSV. readText
+ * reads such text from a stream or a file into a MyMat or a MyDynMat, and parseText
+ * from memory:
+ *
+ * \verbatim
+ * writeText("a.csv", a, ',');
+ * MyDynMat<> b;
+ * if (readText("a.csv", b)) { ... }
+ * \endverbatim
+ *
+ * Numbers are converted with std::to_chars and std::from_chars, which don't depend on
+ * the locale and don't go through iostream formatting. Floating point values are
+ * written in the shortest form that reads back to the same value, so a matrix makes
+ * an exact round trip. The writer formats into a buffer of textBufferBytes, and hands
+ * it to the stream when full.
+ *
+ * The reader takes the number of columns from the first row, and fails when a row has
+ * another number of elements, or something that isn't a number. Elements are separated
+ * by spaces, tabs and commas, blank lines are skipped and "\r\n" line ends are accepted.
+ * A file is mapped into memory (see myio.h) and parsed in place. Text of more than
+ * a couple of textChunkBytes is split into chunks at line ends, that are parsed by the
+ * MyExec thread pool straight into the matrix rows, so the context decides whether
+ * it runs in parallel (see myexec.h).
+ *
+ * On standard libraries without floating point std::to_chars / std::from_chars, floating
+ * point values fall back to printf and strtod with the digits needed for a round trip.
+ */
+namespace MyMatrix {
+
+// Size of the output buffer of the writer
+constexpr size_t textBufferBytes = 64 * 1024;
+// Size of the pieces of text parsed by one thread
+constexpr size_t textChunkBytes = 1 << 20;
+
+// Write a matrix or a view, one row per line
+template <typename M, typename = std::enable_if_t<isMatrix<M>>>
+bool writeText(std::ostream &, const M &, char separator = ' ');
+template <typename M, typename = std::enable_if_t<isMatrix<M>>>
+bool writeText(const std::string &path, const M &, char separator = ' ');
+
+// Parse text in memory into a matrix, a MyMat must have the dimensions of the text
+template <typename T, size_t R, size_t C, Layout L>
+bool parseText(std::string_view text, MyMat<T,R,C,L> &);
+template <typename T, typename A>
+bool parseText(std::string_view text, MyDynMat<T,A> &);
+template <typename T, typename A>
+bool parseText(std::string_view text, MyDynMat<T,A> &, const MyExec::Context &);
+
+// Read a stream or a file
+template <typename T, size_t R, size_t C, Layout L>
+bool readText(std::istream &, MyMat<T,R,C,L> &);
+template <typename T, typename A>
+bool readText(std::istream &, MyDynMat<T,A> &);
+
+template <typename T, size_t R, size_t C, Layout L>
+bool readText(const std::string &path, MyMat<T,R,C,L> &);
+template <typename T, typename A>
+bool readText(const std::string &path, MyDynMat<T,A> &);
+template <typename T, typename A>
+bool readText(const std::string &path, MyDynMat<T,A> &, const MyExec::Context &);
+
+} // namespace MyMatrix
+
+#include "mytext.tpp"
+
+#endif // MYTEXT_H
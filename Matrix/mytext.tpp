@@ -0,0 +1,310 @@
+//
+//  mytext.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace MyMatrix {
+
+namespace detail {
+
+#if defined(__cpp_lib_to_chars) && __cpp_lib_to_chars >= 201611L
+constexpr bool hasFloatCharconv = true;
+#else
+constexpr bool hasFloatCharconv = false;
+#endif
+
+// Longest formatted value: a double with 17 digits, sign, point and exponent, with room to spare
+constexpr size_t maxValueChars = 64;
+
+inline bool isTextSeparator(char c)
+{
+    return c == ' ' || c == '\t' || c == ',' || c == '\r';
+}
+
+inline const char* lineEnd(const char *first, const char *last)
+{
+    const void *eol = std::memchr(first, '\n', static_cast<size_t>(last - first));
+    return eol ? static_cast<const char*>(eol) : last;
+}
+
+// Format value at first, there must be room for maxValueChars
+template <typename T>
+char* formatValue(char *first, char *last, T value)
+{
+    if constexpr (std::is_integral_v<T> || hasFloatCharconv) {
+        return std::to_chars(first, last, value).ptr;
+    }
+    else {
+        int n = std::snprintf(first, static_cast<size_t>(last - first), "%.*g",
+                              std::numeric_limits<T>::max_digits10, static_cast<double>(value));
+        return first + n;
+    }
+}
+
+// Parse the number at first, nullptr when there isn't one
+template <typename T>
+const char* parseValue(const char *first, const char *last, T &value)
+{
+    if (*first == '+' && last - first > 1 && first[1] != '-') {
+        ++first;
+    }
+    if constexpr (std::is_integral_v<T> || hasFloatCharconv) {
+        auto [ptr, ec] = std::from_chars(first, last, value);
+        return ec == std::errc() ? ptr : nullptr;
+    }
+    else {
+        char token[maxValueChars];
+        size_t n = 0;
+        while (first + n < last && n + 1 < maxValueChars && !isTextSeparator(first[n]) && first[n] != '\n') {
+            token[n] = first[n];
+            ++n;
+        }
+        token[n] = '\0';
+        char *end = nullptr;
+        value = static_cast<T>(std::strtod(token, &end));
+        return end == token ? nullptr : first + (end - token);
+    }
+}
+
+// Number of elements on the line [first, eol)
+inline size_t countFields(const char *first, const char *eol)
+{
+    size_t fields = 0;
+    bool inField = false;
+    for (const char *p = first; p < eol; ++p) {
+        bool separator = isTextSeparator(*p);
+        fields += !separator && !inField;
+        inField = !separator;
+    }
+    return fields;
+}
+
+// Number of lines that aren't blank in [first, last)
+inline size_t countRows(const char *first, const char *last)
+{
+    size_t rows = 0;
+    while (first < last) {
+        const char *eol = lineEnd(first, last);
+        rows += std::find_if(first, eol, [](char c) { return !isTextSeparator(c); }) != eol;
+        first = eol + 1;
+    }
+    return rows;
+}
+
+// The text split into pieces of about textChunkBytes at line ends, and the row each piece starts at
+struct TextChunks {
+    std::vector<const char*> bounds;
+    std::vector<size_t> firstRow;
+    size_t cols = 0;
+
+    size_t count() const { return bounds.size() - 1; }
+    size_t rows() const { return firstRow.back(); }
+};
+
+inline TextChunks scanText(std::string_view text, MyExec::ThreadPool *pool)
+{
+    const char *first = text.data();
+    const char *last = first + text.size();
+    TextChunks chunks;
+    for (const char *line = first; line < last && chunks.cols == 0; ) {
+        const char *eol = lineEnd(line, last);
+        chunks.cols = countFields(line, eol);
+        line = eol + 1;
+    }
+    chunks.bounds.push_back(first);
+    while (static_cast<size_t>(last - chunks.bounds.back()) > textChunkBytes) {
+        const char *eol = lineEnd(chunks.bounds.back() + textChunkBytes, last);
+        chunks.bounds.push_back(eol < last ? eol + 1 : last);
+    }
+    if (chunks.bounds.back() != last || chunks.bounds.size() == 1) {
+        chunks.bounds.push_back(last);
+    }
+    chunks.firstRow.assign(chunks.bounds.size(), 0);
+    MyExec::forEachTile(pool, chunks.count(), [&chunks](size_t c) {
+        chunks.firstRow[c + 1] = countRows(chunks.bounds[c], chunks.bounds[c + 1]);
+    });
+    for (size_t c = 0; c < chunks.count(); ++c) {
+        chunks.firstRow[c + 1] += chunks.firstRow[c];
+    }
+    return chunks;
+}
+
+// Parse the lines of [first, last) into the rows of dst from row, false when one isn't a row of dst.cols() numbers
+template <typename T>
+bool parseLines(const char *first, const char *last, MyMatView<T> dst, size_t row)
+{
+    const size_t cols = dst.cols();
+    while (first < last) {
+        const char *eol = lineEnd(first, last);
+        size_t j = 0;
+        for (const char *p = first; ; ) {
+            while (p < eol && isTextSeparator(*p)) {
+                ++p;
+            }
+            if (p == eol) {
+                break;
+            }
+            T value;
+            if (j == cols || !(p = parseValue(p, eol, value)) || (p < eol && !isTextSeparator(*p))) {
+                return false;
+            }
+            dst(row, j++) = value;
+        }
+        if (j != 0) {
+            if (j != cols) {
+                return false;
+            }
+            ++row;
+        }
+        first = eol + 1;
+    }
+    return true;
+}
+
+template <typename T>
+bool parseChunks(const TextChunks &chunks, MyMatView<T> dst, MyExec::ThreadPool *pool)
+{
+    MYSTATS_SCOPE("parseText", dst.size(), 0, static_cast<size_t>(chunks.bounds.back() - chunks.bounds.front()));
+    std::unique_ptr<bool[]> ok(new bool[chunks.count()]);
+    MyExec::forEachTile(pool, chunks.count(), [&](size_t c) {
+        ok[c] = parseLines(chunks.bounds[c], chunks.bounds[c + 1], dst, chunks.firstRow[c]);
+    });
+    return std::all_of(ok.get(), ok.get() + chunks.count(), [](bool b) { return b; });
+}
+
+inline MyExec::ThreadPool* textPool(std::string_view text)
+{
+    return MyExec::current().poolFor(text.size(), 2 * textChunkBytes);
+}
+
+inline bool readAll(std::istream &is, std::string &text)
+{
+    char buffer[64 * 1024];
+    while (is.read(buffer, sizeof(buffer)) || is.gcount() > 0) {
+        text.append(buffer, static_cast<size_t>(is.gcount()));
+    }
+    return is.eof() && !is.bad();
+}
+
+} // namespace detail
+
+template <typename M, typename>
+bool writeText(std::ostream &os, const M &m, char separator)
+{
+    using T = std::remove_const_t<typename M::value_type>;
+    auto v = m.view();
+    MYSTATS_SCOPE("writeText", v.size(), 0, v.size() * sizeof(T));
+    std::vector<char> buffer(textBufferBytes);
+    char *const begin = buffer.data();
+    char *const end = begin + buffer.size();
+    char *out = begin;
+    for (size_t i = 0; i < v.rows() && os; ++i) {
+        for (size_t j = 0; j < v.cols(); ++j) {
+            if (static_cast<size_t>(end - out) < detail::maxValueChars + 1) {
+                os.write(begin, out - begin);
+                out = begin;
+            }
+            out = detail::formatValue<T>(out, end, v(i,j));
+            *out++ = j + 1 < v.cols() ? separator : '\n';
+        }
+    }
+    os.write(begin, out - begin);
+    return static_cast<bool>(os);
+}
+
+template <typename M, typename>
+bool writeText(const std::string &path, const M &m, char separator)
+{
+    std::ofstream os(path, std::ios::binary | std::ios::trunc);
+    return writeText(os, m, separator) && os.flush();
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+bool parseText(std::string_view text, MyMat<T,R,C,L> &m)
+{
+    MyExec::ThreadPool *pool = detail::textPool(text);
+    detail::TextChunks chunks = detail::scanText(text, pool);
+    if (chunks.rows() != R || chunks.cols != C) {
+        return false;
+    }
+    return detail::parseChunks(chunks, m.view(), pool);
+}
+
+template <typename T, typename A>
+bool parseText(std::string_view text, MyDynMat<T,A> &m)
+{
+    MyExec::ThreadPool *pool = detail::textPool(text);
+    detail::TextChunks chunks = detail::scanText(text, pool);
+    MyDynMat<T,A> parsed(chunks.rows(), chunks.cols, m.get_allocator());
+    if (!detail::parseChunks(chunks, parsed.view(), pool)) {
+        return false;
+    }
+    m = std::move(parsed);
+    return true;
+}
+
+template <typename T, typename A>
+bool parseText(std::string_view text, MyDynMat<T,A> &m, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    return parseText(text, m);
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+bool readText(std::istream &is, MyMat<T,R,C,L> &m)
+{
+    std::string text;
+    return detail::readAll(is, text) && parseText(text, m);
+}
+
+template <typename T, typename A>
+bool readText(std::istream &is, MyDynMat<T,A> &m)
+{
+    std::string text;
+    return detail::readAll(is, text) && parseText(text, m);
+}
+
+template <typename T, size_t R, size_t C, Layout L>
+bool readText(const std::string &path, MyMat<T,R,C,L> &m)
+{
+    MappedFile file(path);
+    if (file.isOpen()) {
+        return parseText(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), m);
+    }
+    // Empty files can't be mapped
+    std::ifstream is(path, std::ios::binary);
+    return is && readText(is, m);
+}
+
+template <typename T, typename A>
+bool readText(const std::string &path, MyDynMat<T,A> &m)
+{
+    MappedFile file(path);
+    if (file.isOpen()) {
+        return parseText(std::string_view(reinterpret_cast<const char*>(file.data()), file.size()), m);
+    }
+    std::ifstream is(path, std::ios::binary);
+    return is && readText(is, m);
+}
+
+template <typename T, typename A>
+bool readText(const std::string &path, MyDynMat<T,A> &m, const MyExec::Context &ctx)
+{
+    MyExec::ScopedContext scope(ctx);
+    return readText(path, m);
+}
+
+} // namespace MyMatrix
@@ -9,10 +9,13 @@
 #define MYVEC_H
 
 #include <iostream>
+#include <cstdint>
 #include <iterator>
 #include <array>
 #include <initializer_list>
 #include "utils.h"
+#include "myexpr.h"
+#include "mystats.h"
 
 /*!
  * \brief A container abstraction that represents a Euclidean vector
@@ -32,14 +35,27 @@
  * A limited set of vector operations is supported. These include basic arithmetic such as
  * addition, subtraction, scalar multiply/divide. Also available are vector dot product,
  * cross product (for 2 or 3D vectors only), and the vectors can be queried for magnitude.
+ *
+ * Addition, subtraction and scalar multiply/divide are lazy (see myexpr.h): a chain such as
+ * a + b - 2 * c is evaluated in a single pass when it is assigned to a vector.
+ *
+ * Construction, element access, arithmetic, dot and cross products are constexpr. Their
+ * loops have a compile-time trip count, so for 2 to 4 elements they compile to a few
+ * instructions. Transforming a vector by a matrix is in mymat.h.
  */
 namespace MyVector {
 
 template <typename T = double, size_t N = 3>
-class MyVec {
+class MyVec : public MyExpr::Expression<MyVec<T,N>> {
 public:
-    MyVec();
-    MyVec(std::initializer_list<T>);
+    using value_type = T;
+    using result_type = MyVec;
+
+    constexpr MyVec();
+    constexpr MyVec(std::initializer_list<T>);
+
+    template <typename E>
+    constexpr MyVec(const MyExpr::Expression<E> &);
 
     template <typename Iter>
     MyVec(Iter first, Iter last);
@@ -51,6 +67,9 @@ public:
 
     MyVec(MyVec &&) noexcept = default;
     MyVec& operator=(MyVec &&) noexcept = default;
+
+    template <typename E>
+    constexpr MyVec& operator=(const MyExpr::Expression<E> &);
     
     MyVec& normalize();
 
@@ -62,26 +81,23 @@ public:
     constexpr auto end() const noexcept { return data_.end(); }
     constexpr auto cend() const noexcept { return data_.cend(); }
 
+    constexpr T* data() noexcept { return data_.data(); }
+    constexpr const T* data() const noexcept { return data_.data(); }
+
     constexpr size_t size() const noexcept { return data_.size(); }
     constexpr bool empty() const noexcept { return data_.empty(); }
 
-          T& operator[](size_t i);
-    const T& operator[](size_t i) const;
-
-    MyVec& operator+=(const MyVec &);
-    MyVec& operator-=(const MyVec &);
-    MyVec& operator*=(double);
-
-    friend MyVec operator+(MyVec lhs, const MyVec &rhs)
-    {
-        lhs += rhs;
-        return lhs;
-    }
-    friend MyVec operator-(MyVec lhs, const MyVec &rhs)
-    {
-        lhs -= rhs;
-        return lhs;
-    }
+    constexpr       T& operator[](size_t i);
+    constexpr const T& operator[](size_t i) const;
+
+    constexpr MyVec& operator+=(const MyVec &);
+    constexpr MyVec& operator-=(const MyVec &);
+    constexpr MyVec& operator*=(double);
+
+    template <typename E>
+    constexpr MyVec& operator+=(const MyExpr::Expression<E> &);
+    template <typename E>
+    constexpr MyVec& operator-=(const MyExpr::Expression<E> &);
     
 private:
     std::array<T, N> data_;
@@ -93,24 +109,26 @@ private:
 template <typename T, size_t N>
 double magnitude(const MyVec<T,N> &);
 template <typename T, size_t N>
-T magnitude2(const MyVec<T,N> &);
+constexpr T magnitude2(const MyVec<T,N> &);
 
 template <typename T, size_t N, typename T2, size_t N2>
 double angle(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs);
 
+namespace detail {
+
+// The type dot products of T and T2 accumulate in: double for floating point, so that long
+// float sums keep their precision, and 64 bits for integers, so that the products don't overflow
+template <typename T, typename T2>
+using DotAccumulator = std::conditional_t<std::is_floating_point_v<decltype(T() * T2())>, double,
+                       std::conditional_t<std::is_signed_v<decltype(T() * T2())>, int64_t, uint64_t>>;
+
+} // namespace detail
+
 template <typename T, size_t N, typename T2>
-double dotProduct(const MyVec<T,N> &lhs, const MyVec<T2,N> &rhs);
+constexpr double dotProduct(const MyVec<T,N> &lhs, const MyVec<T2,N> &rhs);
 
 template <typename T, size_t N, typename T2, size_t N2>
-MyVec<T,3> crossProduct(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs);
-
-// Scalar multiplication and division
-template <typename T, size_t N>
-MyVec<T,N> operator*(double, const MyVec<T,N> &);
-template <typename T, size_t N>
-MyVec<T,N> operator*(const MyVec<T,N> &, double);
-template <typename T, size_t N>
-MyVec<T,N> operator/(const MyVec<T,N> &, double);
+constexpr MyVec<T,3> crossProduct(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs);
 
 // Comparison operators
 template <typename T, size_t N, typename T2, size_t N2>
@@ -6,26 +6,27 @@
 //
 
 #include <algorithm>
-#include <numeric>
 #include <cmath>
 #include <type_traits>
 
 namespace MyVector {
 
 template <typename T, size_t N>
-MyVec<T,N>::MyVec() :
+constexpr MyVec<T,N>::MyVec() :
     data_(std::array<T,N>())
 {
     static_assert (std::is_arithmetic_v<T>, "MyVec requires an arithmetic type");
 }
 
 template <typename T, size_t N>
-MyVec<T,N>::MyVec(std::initializer_list<T> li) :
+constexpr MyVec<T,N>::MyVec(std::initializer_list<T> li) :
     data_(std::array<T,N>())
 {
     static_assert (std::is_arithmetic_v<T>, "MyVec requires an arithmetic type");
     size_t count = std::min(N, li.size());
-    std::copy_n(li.begin(), count, data_.begin());
+    for (size_t i = 0; i < count; ++i) {
+        data_[i] = li.begin()[i];
+    }
 }
 
 template <typename T, size_t N>
@@ -42,6 +43,27 @@ MyVec<T,N>::MyVec(Iter first, Iter last) :
     }
 }
 
+template <typename T, size_t N>
+template <typename E>
+constexpr MyVec<T,N>::MyVec(const MyExpr::Expression<E> &expr) :
+    data_(std::array<T,N>())
+{
+    *this = expr;
+}
+
+template <typename T, size_t N>
+template <typename E>
+constexpr MyVec<T,N>& MyVec<T,N>::operator=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyVec>, "Expression doesn't evaluate to this vector type");
+    MYSTATS_COUNT("evaluate", N, N * MyExpr::Cost<E>::flops, N * sizeof(T) * (MyExpr::Cost<E>::reads + 1));
+    const E &e = expr.self();
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] = MyExpr::at(e, i);
+    }
+    return *this;
+}
+
 template <typename T, size_t N>
 MyVec<T,N>& MyVec<T,N>::normalize()
 {
@@ -50,41 +72,77 @@ MyVec<T,N>& MyVec<T,N>::normalize()
         return *this;
     }
     
+    MYSTATS_COUNT("normalize", N, N, 2 * N * sizeof(T));
     double invMagnitude = 1 / mag;
     std::for_each(data_.begin(), data_.end(), [invMagnitude](T &n) { n *= invMagnitude; });
     return *this;
 }
 
 template <typename T, size_t N>
-T& MyVec<T,N>::operator[](size_t i)
+constexpr T& MyVec<T,N>::operator[](size_t i)
 {
     return data_[i];
 }
 
 template <typename T, size_t N>
-const T& MyVec<T,N>::operator[](size_t i) const
+constexpr const T& MyVec<T,N>::operator[](size_t i) const
 {
     return data_[i];
 }
 
 template <typename T, size_t N>
-MyVec<T,N>& MyVec<T,N>::operator+=(const MyVec &rhs)
+constexpr MyVec<T,N>& MyVec<T,N>::operator+=(const MyVec &rhs)
 {
-    std::transform(rhs.data_.cbegin(), rhs.data_.cend(), data_.cbegin(), data_.begin(), std::plus<>());
+    MYSTATS_COUNT("add", N, N, 3 * N * sizeof(T));
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] += rhs.data_[i];
+    }
     return *this;
 }
 
 template <typename T, size_t N>
-MyVec<T,N>& MyVec<T,N>::operator-=(const MyVec &rhs)
+constexpr MyVec<T,N>& MyVec<T,N>::operator-=(const MyVec &rhs)
 {
-    std::transform(rhs.data_.cbegin(), rhs.data_.cend(), data_.cbegin(), data_.begin(), std::minus<>());
+    MYSTATS_COUNT("subtract", N, N, 3 * N * sizeof(T));
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] -= rhs.data_[i];
+    }
     return *this;
 }
 
 template <typename T, size_t N>
-MyVec<T,N>& MyVec<T,N>::operator*=(double rhs)
+constexpr MyVec<T,N>& MyVec<T,N>::operator*=(double rhs)
 {
-    std::for_each(data_.begin(), data_.end(), [rhs](double &v) { v *= rhs; });
+    MYSTATS_COUNT("scale", N, N, 2 * N * sizeof(T));
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] *= rhs;
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+template <typename E>
+constexpr MyVec<T,N>& MyVec<T,N>::operator+=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyVec>, "Expression doesn't evaluate to this vector type");
+    MYSTATS_COUNT("add", N, N * (MyExpr::Cost<E>::flops + 1), N * sizeof(T) * (MyExpr::Cost<E>::reads + 2));
+    const E &e = expr.self();
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] += MyExpr::at(e, i);
+    }
+    return *this;
+}
+
+template <typename T, size_t N>
+template <typename E>
+constexpr MyVec<T,N>& MyVec<T,N>::operator-=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (std::is_same_v<typename E::result_type, MyVec>, "Expression doesn't evaluate to this vector type");
+    MYSTATS_COUNT("subtract", N, N * (MyExpr::Cost<E>::flops + 1), N * sizeof(T) * (MyExpr::Cost<E>::reads + 2));
+    const E &e = expr.self();
+    for (size_t i = 0; i < N; ++i) {
+        data_[i] -= MyExpr::at(e, i);
+    }
     return *this;
 }
 
@@ -98,11 +156,14 @@ double magnitude(const MyVec<T,N> &vec)
 
 // Square of the magnitude
 template <typename T, size_t N>
-T magnitude2(const MyVec<T,N> &vec)
+constexpr T magnitude2(const MyVec<T,N> &vec)
 {
-    return std::accumulate(vec.cbegin(), vec.cend(), 0, [](const T &sum, const T &el) {
-        return sum + el * el;
-    });
+    MYSTATS_COUNT("magnitude", N, 2 * N, N * sizeof(T));
+    T sum = 0;
+    for (size_t i = 0; i < N; ++i) {
+        sum += vec[i] * vec[i];
+    }
+    return sum;
 }
 
 template <typename T, size_t N, typename T2, size_t N2>
@@ -119,20 +180,23 @@ double angle(const MyVec<T,N> &lhs, MyVec<T2,N2> &rhs)
 }
 
 template <typename T, size_t N, typename T2>
-double dotProduct(const MyVec<T,N> &lhs, const MyVec<T2,N> &rhs)
+constexpr double dotProduct(const MyVec<T,N> &lhs, const MyVec<T2,N> &rhs)
 {
-    double product = 0.0;
+    MYSTATS_COUNT("dotProduct", N, 2 * N, N * (sizeof(T) + sizeof(T2)));
+    using Acc = detail::DotAccumulator<T,T2>;
+    Acc product = 0;
     for (size_t i = 0; i < N; ++i) {
-        product += lhs[i] * rhs[i];
+        product += static_cast<Acc>(lhs[i]) * static_cast<Acc>(rhs[i]);
     }
-    return product;
+    return static_cast<double>(product);
 }
 
 template <typename T, size_t N, typename T2, size_t N2>
-MyVec<T,3> crossProduct(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs)
+constexpr MyVec<T,3> crossProduct(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs)
 {
     static_assert (N == 2 || N == 3, "Vector cross product requires vector of length 2 or 3");
     static_assert (N2 == 2 || N2 == 3, "Vector cross product requires vector of length 2 or 3");
+    MYSTATS_COUNT("crossProduct", 3, 9, N * sizeof(T) + N2 * sizeof(T2) + 3 * sizeof(T));
     T lz = 0;
     T rz = 0;
     if constexpr (N == 3) {
@@ -148,36 +212,13 @@ MyVec<T,3> crossProduct(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs)
     return ret;
 }
 
-template <typename T, size_t N>
-MyVec<T,N> operator*(double scalar, const MyVec<T,N> &vec)
-{
-    MyVec<T,N> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return scalar * v;} );
-    return result;
-}
-
-template <typename T, size_t N>
-MyVec<T,N> operator*(const MyVec<T,N> &vec, double scalar)
-{
-    MyVec<T,N> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return scalar * v;} );
-    return result;
-}
-
-template <typename T, size_t N>
-MyVec<T,N> operator/(const MyVec<T,N> &vec, double scalar)
-{
-    MyVec<T,N> result;
-    std::transform(vec.cbegin(), vec.cend(), result.begin(), [scalar](const T &v) { return v / scalar;} );
-    return result;
-}
-
 template <typename T, size_t N, typename T2, size_t N2>
 bool operator==(const MyVec<T,N> &lhs, const MyVec<T2,N2> &rhs)
 {
     if constexpr (N != N2) {
         return false;
     }
+    MYSTATS_COUNT("compare", N, N, N * (sizeof(T) + sizeof(T2)));
     if constexpr (std::is_integral_v<T> || std::is_integral_v<T2>) {
         for (size_t i = 0; i < N; ++i) {
             if (lhs[i] != rhs[i]) {
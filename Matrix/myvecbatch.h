@@ -0,0 +1,138 @@
+//
+//  myvecbatch.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYVECBATCH_H
+#define MYVECBATCH_H
+
+#include <vector>
+#include "allocator.h"
+#include "simd.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "mymat.h"
+#include "mystats.h"
+
+/*!
+ * \brief A structure-of-arrays container for many vectors of the same size
+ * \details MyVecBatch holds count vectors of N components. Instead of storing each
+ * vector contiguously (as an array of MyVec would), it stores each component in its own
+ * contiguous lane: all the x components, then all the y components, and so on. Each
+ * lane is 64-byte aligned.
+ *
+ * That layout lets the batch versions of dotProduct, crossProduct, magnitude and
+ * normalize process one full SIMD register of vectors per instruction, instead of
+ * one vector at a time.
+ *
+ * \verbatim
+ * std::vector<MyVec<double,3>> points = ...;
+ * MyVecBatch<double,3> batch(points.begin(), points.end());
+ * batch.normalizeFast();
+ * auto dots = dotProduct(batch, direction);  // MyDynVec<double> with one entry per vector
+ * batch.copyTo(points.begin());
+ * \endverbatim
+ *
+ * transformPoints and transformVectors apply the affine part of a 4x4 matrix to a batch
+ * of 3D vectors in place, the batch version of transformPoint and transformVector.
+ *
+ * normalize() computes an exact square root and division. normalizeFast() uses the
+ * hardware reciprocal square root estimate refined with Newton-Raphson steps, where the
+ * target has one for T, and is accurate to a few units in the last place. Both leave
+ * zero-length vectors at zero.
+ */
+namespace MyVector {
+
+template <typename T = double, size_t N = 3, typename Alloc = MyMemory::AlignedAllocator<T>>
+class MyVecBatch {
+public:
+    using value_type = MyVec<T,N>;
+    using allocator_type = Alloc;
+
+    explicit MyVecBatch(const Alloc &alloc = Alloc());
+    explicit MyVecBatch(size_t count, const Alloc &alloc = Alloc());
+
+    // Build from a range of MyVec<T,N>
+    template <typename Iter>
+    MyVecBatch(Iter first, Iter last, const Alloc &alloc = Alloc());
+
+    ~MyVecBatch() = default;
+
+    MyVecBatch(const MyVecBatch &) = default;
+    MyVecBatch& operator=(const MyVecBatch &) = default;
+
+    MyVecBatch(MyVecBatch &&) noexcept = default;
+    MyVecBatch& operator=(MyVecBatch &&) noexcept = default;
+
+    // Write the vectors back as MyVec<T,N>, to a range of at least size() elements
+    template <typename OutIter>
+    OutIter copyTo(OutIter out) const;
+
+    template <typename Iter>
+    void assign(Iter first, Iter last);
+
+    size_t size() const noexcept { return count_; }
+    bool empty() const noexcept { return count_ == 0; }
+    constexpr size_t components() const noexcept { return N; }
+    void resize(size_t count);
+    void clear() noexcept { count_ = 0; }
+
+    allocator_type get_allocator() const { return data_.get_allocator(); }
+
+    // Contiguous storage of component c for every vector
+          T* lane(size_t c) noexcept { return data_.data() + c * stride_; }
+    const T* lane(size_t c) const noexcept { return data_.data() + c * stride_; }
+
+    MyVec<T,N> operator[](size_t i) const;
+    void set(size_t i, const MyVec<T,N> &);
+    void push_back(const MyVec<T,N> &);
+
+    MyVecBatch& normalize();
+    MyVecBatch& normalizeFast();
+
+private:
+    // Lane length, rounded up to keep every lane on a cache line boundary
+    static size_t strideFor(size_t count);
+    void reallocate(size_t stride);
+
+    std::vector<T, Alloc> data_;
+    size_t count_ = 0;
+    size_t stride_ = 0;
+};
+
+// Batch magnitude, one entry per vector
+template <typename T, size_t N, typename A>
+MyDynVec<T> magnitude(const MyVecBatch<T,N,A> &);
+template <typename T, size_t N, typename A>
+MyDynVec<T> magnitude2(const MyVecBatch<T,N,A> &);
+
+// Pairwise dot product of two batches of the same size, or of every vector with one vector
+template <typename T, size_t N, typename A, typename A2>
+MyDynVec<T> dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs);
+template <typename T, size_t N, typename A>
+MyDynVec<T> dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVec<T,N> &rhs);
+
+// Same as above, writing lhs.size() results to out
+template <typename T, size_t N, typename A, typename A2>
+void dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs, T *out);
+template <typename T, size_t N, typename A>
+void dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVec<T,N> &rhs, T *out);
+
+// Pairwise cross product of two batches of 2 or 3D vectors
+template <typename T, size_t N, typename A, typename A2>
+MyVecBatch<T,3,A> crossProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs);
+
+// Transform every vector by the first three rows of m, in place, as points (w = 1) or
+// as directions (w = 0)
+template <typename T, MyMatrix::Layout L, typename A>
+MyVecBatch<T,3,A>& transformPoints(const MyMatrix::MyMat<T,4,4,L> &m, MyVecBatch<T,3,A> &batch);
+template <typename T, MyMatrix::Layout L, typename A>
+MyVecBatch<T,3,A>& transformVectors(const MyMatrix::MyMat<T,4,4,L> &m, MyVecBatch<T,3,A> &batch);
+
+} // namespace MyVector
+
+#include "myvecbatch.tpp"
+
+#endif // MYVECBATCH_H
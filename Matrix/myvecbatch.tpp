@@ -0,0 +1,467 @@
+//
+//  myvecbatch.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+
+namespace MyVector {
+
+namespace detail {
+
+// out[i] = sum_c a[c][i] * b[c][i]
+template <typename T, size_t N>
+void batchDot(size_t count, const T *const *a, const T *const *b, T *out)
+{
+    MYSTATS_COUNT("batchDot", count, 2 * N * count, (2 * N + 1) * count * sizeof(T));
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    size_t i = 0;
+    for (; i + W <= count; i += W) {
+        auto acc = P::mul(P::load(a[0] + i), P::load(b[0] + i));
+        MYSIMD_UNROLL
+        for (size_t c = 1; c < N; ++c) {
+            acc = P::fmadd(P::load(a[c] + i), P::load(b[c] + i), acc);
+        }
+        P::store(out + i, acc);
+    }
+    for (; i < count; ++i) {
+        T sum = a[0][i] * b[0][i];
+        for (size_t c = 1; c < N; ++c) {
+            sum += a[c][i] * b[c][i];
+        }
+        out[i] = sum;
+    }
+}
+
+// out[i] = sum_c a[c][i] * v[c]
+template <typename T, size_t N>
+void batchDot(size_t count, const T *const *a, const MyVec<T,N> &v, T *out)
+{
+    MYSTATS_COUNT("batchDot", count, 2 * N * count, (N + 1) * count * sizeof(T));
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    typename P::type bv[N];
+    for (size_t c = 0; c < N; ++c) {
+        bv[c] = P::set1(v[c]);
+    }
+    size_t i = 0;
+    for (; i + W <= count; i += W) {
+        auto acc = P::mul(P::load(a[0] + i), bv[0]);
+        MYSIMD_UNROLL
+        for (size_t c = 1; c < N; ++c) {
+            acc = P::fmadd(P::load(a[c] + i), bv[c], acc);
+        }
+        P::store(out + i, acc);
+    }
+    for (; i < count; ++i) {
+        T sum = a[0][i] * v[0];
+        for (size_t c = 1; c < N; ++c) {
+            sum += a[c][i] * v[c];
+        }
+        out[i] = sum;
+    }
+}
+
+template <typename T>
+void batchSqrt(size_t count, T *inout)
+{
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    size_t i = 0;
+    for (; i + W <= count; i += W) {
+        P::store(inout + i, P::sqrt(P::load(inout + i)));
+    }
+    for (; i < count; ++i) {
+        inout[i] = std::sqrt(inout[i]);
+    }
+}
+
+// Scale every vector by the inverse of its magnitude. Squared magnitudes are clamped
+// to the smallest normal value, so that zero vectors are multiplied by a finite
+// number and stay zero.
+template <typename T, size_t N, bool Fast>
+void batchNormalize(size_t count, T *const *lanes)
+{
+    static_assert (std::is_floating_point_v<T>, "Normalization requires a floating point type");
+    MYSTATS_COUNT("batchNormalize", count, 4 * N * count, 2 * N * count * sizeof(T));
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+    const auto tiny = P::set1(std::numeric_limits<T>::min());
+    const auto one = P::set1(T(1));
+    size_t i = 0;
+    for (; i + W <= count; i += W) {
+        typename P::type v[N];
+        v[0] = P::load(lanes[0] + i);
+        auto mag2 = P::mul(v[0], v[0]);
+        MYSIMD_UNROLL
+        for (size_t c = 1; c < N; ++c) {
+            v[c] = P::load(lanes[c] + i);
+            mag2 = P::fmadd(v[c], v[c], mag2);
+        }
+        mag2 = P::max(mag2, tiny);
+
+        typename P::type inv;
+        if constexpr (Fast) {
+            inv = P::rsqrt(mag2);
+            for (int s = 0; s < P::rsqrtSteps; ++s) {
+                inv = MySimd::rsqrtStep<T>(mag2, inv);
+            }
+        }
+        else {
+            inv = P::div(one, P::sqrt(mag2));
+        }
+
+        MYSIMD_UNROLL
+        for (size_t c = 0; c < N; ++c) {
+            P::store(lanes[c] + i, P::mul(v[c], inv));
+        }
+    }
+    for (; i < count; ++i) {
+        T mag2 = 0;
+        for (size_t c = 0; c < N; ++c) {
+            mag2 += lanes[c][i] * lanes[c][i];
+        }
+        T inv = T(1) / std::sqrt(std::max(mag2, std::numeric_limits<T>::min()));
+        for (size_t c = 0; c < N; ++c) {
+            lanes[c][i] *= inv;
+        }
+    }
+}
+
+// The first three rows of a 4x4 matrix, row-major
+template <typename T>
+using Affine = std::array<T,12>;
+
+template <typename T, MyMatrix::Layout L>
+Affine<T> affineOf(const MyMatrix::MyMat<T,4,4,L> &m)
+{
+    Affine<T> a;
+    for (size_t i = 0; i < 3; ++i) {
+        for (size_t j = 0; j < 4; ++j) {
+            a[i * 4 + j] = m(i, j);
+        }
+    }
+    return a;
+}
+
+// (x, y, z) = m * (x, y, z, W) for every vector, in place. W is 1 for points, 0 for directions.
+template <typename T, int W>
+void batchTransform(size_t count, T *const *lanes, const Affine<T> &m)
+{
+    MYSTATS_COUNT("batchTransform", count, (W ? 18 : 15) * count, 6 * count * sizeof(T));
+    using P = MySimd::Pack<T>;
+    constexpr size_t PW = P::width;
+    typename P::type bm[12];
+    for (size_t k = 0; k < 12; ++k) {
+        bm[k] = P::set1(m[k]);
+    }
+    T *x = lanes[0], *y = lanes[1], *z = lanes[2];
+    size_t i = 0;
+    for (; i + PW <= count; i += PW) {
+        auto vx = P::load(x + i), vy = P::load(y + i), vz = P::load(z + i);
+        typename P::type out[3];
+        MYSIMD_UNROLL
+        for (size_t r = 0; r < 3; ++r) {
+            auto acc = W ? P::fmadd(bm[r * 4], vx, bm[r * 4 + 3]) : P::mul(bm[r * 4], vx);
+            acc = P::fmadd(bm[r * 4 + 1], vy, acc);
+            out[r] = P::fmadd(bm[r * 4 + 2], vz, acc);
+        }
+        P::store(x + i, out[0]);
+        P::store(y + i, out[1]);
+        P::store(z + i, out[2]);
+    }
+    for (; i < count; ++i) {
+        T v[3] = {x[i], y[i], z[i]};
+        T out[3];
+        for (size_t r = 0; r < 3; ++r) {
+            out[r] = m[r * 4] * v[0] + m[r * 4 + 1] * v[1] + m[r * 4 + 2] * v[2] + m[r * 4 + 3] * T(W);
+        }
+        x[i] = out[0];
+        y[i] = out[1];
+        z[i] = out[2];
+    }
+}
+
+template <typename T, size_t N, typename A>
+std::array<const T*, N> lanesOf(const MyVecBatch<T,N,A> &batch)
+{
+    std::array<const T*, N> lanes;
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = batch.lane(c);
+    }
+    return lanes;
+}
+
+template <typename T, size_t N, typename A>
+std::array<T*, N> lanesOf(MyVecBatch<T,N,A> &batch)
+{
+    std::array<T*, N> lanes;
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = batch.lane(c);
+    }
+    return lanes;
+}
+
+} // namespace detail
+
+template <typename T, size_t N, typename A>
+MyVecBatch<T,N,A>::MyVecBatch(const A &alloc) :
+    data_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyVecBatch requires an arithmetic type");
+}
+
+template <typename T, size_t N, typename A>
+MyVecBatch<T,N,A>::MyVecBatch(size_t count, const A &alloc) :
+    data_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyVecBatch requires an arithmetic type");
+    resize(count);
+}
+
+template <typename T, size_t N, typename A>
+template <typename Iter>
+MyVecBatch<T,N,A>::MyVecBatch(Iter first, Iter last, const A &alloc) :
+    data_(alloc)
+{
+    static_assert (std::is_arithmetic_v<T>, "MyVecBatch requires an arithmetic type");
+    assign(first, last);
+}
+
+template <typename T, size_t N, typename A>
+template <typename Iter>
+void MyVecBatch<T,N,A>::assign(Iter first, Iter last)
+{
+    resize(static_cast<size_t>(std::distance(first, last)));
+    T *lanes[N];
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = lane(c);
+    }
+    for (size_t i = 0; first != last; ++first, ++i) {
+        const MyVec<T,N> &v = *first;
+        for (size_t c = 0; c < N; ++c) {
+            lanes[c][i] = v[c];
+        }
+    }
+}
+
+template <typename T, size_t N, typename A>
+template <typename OutIter>
+OutIter MyVecBatch<T,N,A>::copyTo(OutIter out) const
+{
+    const T *lanes[N];
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = lane(c);
+    }
+    for (size_t i = 0; i < count_; ++i, ++out) {
+        MyVec<T,N> &v = *out;
+        for (size_t c = 0; c < N; ++c) {
+            v[c] = lanes[c][i];
+        }
+    }
+    return out;
+}
+
+template <typename T, size_t N, typename A>
+size_t MyVecBatch<T,N,A>::strideFor(size_t count)
+{
+    constexpr size_t perLine = std::max<size_t>(1, MyMemory::cacheLine / sizeof(T));
+    return (count + perLine - 1) / perLine * perLine;
+}
+
+template <typename T, size_t N, typename A>
+void MyVecBatch<T,N,A>::reallocate(size_t stride)
+{
+    std::vector<T, A> grown(N * stride, T(), data_.get_allocator());
+    for (size_t c = 0; c < N; ++c) {
+        std::copy_n(lane(c), count_, grown.data() + c * stride);
+    }
+    data_.swap(grown);
+    stride_ = stride;
+}
+
+template <typename T, size_t N, typename A>
+void MyVecBatch<T,N,A>::resize(size_t count)
+{
+    if (count > stride_) {
+        reallocate(strideFor(count));
+    }
+    if (count > count_) {
+        for (size_t c = 0; c < N; ++c) {
+            std::fill(lane(c) + count_, lane(c) + count, T(0));
+        }
+    }
+    count_ = count;
+}
+
+template <typename T, size_t N, typename A>
+MyVec<T,N> MyVecBatch<T,N,A>::operator[](size_t i) const
+{
+    MyVec<T,N> v;
+    for (size_t c = 0; c < N; ++c) {
+        v[c] = lane(c)[i];
+    }
+    return v;
+}
+
+template <typename T, size_t N, typename A>
+void MyVecBatch<T,N,A>::set(size_t i, const MyVec<T,N> &v)
+{
+    for (size_t c = 0; c < N; ++c) {
+        lane(c)[i] = v[c];
+    }
+}
+
+template <typename T, size_t N, typename A>
+void MyVecBatch<T,N,A>::push_back(const MyVec<T,N> &v)
+{
+    if (count_ == stride_) {
+        reallocate(strideFor(std::max<size_t>(2 * count_, 1)));
+    }
+    ++count_;
+    set(count_ - 1, v);
+}
+
+template <typename T, size_t N, typename A>
+MyVecBatch<T,N,A>& MyVecBatch<T,N,A>::normalize()
+{
+    T *lanes[N];
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = lane(c);
+    }
+    detail::batchNormalize<T,N,false>(count_, lanes);
+    return *this;
+}
+
+template <typename T, size_t N, typename A>
+MyVecBatch<T,N,A>& MyVecBatch<T,N,A>::normalizeFast()
+{
+    T *lanes[N];
+    for (size_t c = 0; c < N; ++c) {
+        lanes[c] = lane(c);
+    }
+    detail::batchNormalize<T,N,true>(count_, lanes);
+    return *this;
+}
+
+// Related non-members
+
+template <typename T, size_t N, typename A>
+MyDynVec<T> magnitude(const MyVecBatch<T,N,A> &batch)
+{
+    MyDynVec<T> result = magnitude2(batch);
+    detail::batchSqrt(result.size(), result.data());
+    return result;
+}
+
+template <typename T, size_t N, typename A>
+MyDynVec<T> magnitude2(const MyVecBatch<T,N,A> &batch)
+{
+    MyDynVec<T> result(batch.size());
+    auto lanes = detail::lanesOf(batch);
+    detail::batchDot<T,N>(batch.size(), lanes.data(), lanes.data(), result.data());
+    return result;
+}
+
+template <typename T, size_t N, typename A, typename A2>
+MyDynVec<T> dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs)
+{
+    MyDynVec<T> result(lhs.size());
+    dotProduct(lhs, rhs, result.data());
+    return result;
+}
+
+template <typename T, size_t N, typename A>
+MyDynVec<T> dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVec<T,N> &rhs)
+{
+    MyDynVec<T> result(lhs.size());
+    dotProduct(lhs, rhs, result.data());
+    return result;
+}
+
+template <typename T, size_t N, typename A, typename A2>
+void dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs, T *out)
+{
+    assert(lhs.size() == rhs.size());
+    auto l = detail::lanesOf(lhs);
+    auto r = detail::lanesOf(rhs);
+    detail::batchDot<T,N>(lhs.size(), l.data(), r.data(), out);
+}
+
+template <typename T, size_t N, typename A>
+void dotProduct(const MyVecBatch<T,N,A> &lhs, const MyVec<T,N> &rhs, T *out)
+{
+    auto l = detail::lanesOf(lhs);
+    detail::batchDot<T,N>(lhs.size(), l.data(), rhs, out);
+}
+
+template <typename T, size_t N, typename A, typename A2>
+MyVecBatch<T,3,A> crossProduct(const MyVecBatch<T,N,A> &lhs, const MyVecBatch<T,N,A2> &rhs)
+{
+    static_assert (N == 2 || N == 3, "Vector cross product requires vector of length 2 or 3");
+    assert(lhs.size() == rhs.size());
+    using P = MySimd::Pack<T>;
+    constexpr size_t W = P::width;
+
+    const size_t count = lhs.size();
+    MyVecBatch<T,3,A> result(count, lhs.get_allocator());
+    const T *l0 = lhs.lane(0), *l1 = lhs.lane(1);
+    const T *r0 = rhs.lane(0), *r1 = rhs.lane(1);
+    T *o0 = result.lane(0), *o1 = result.lane(1), *o2 = result.lane(2);
+
+    size_t i = 0;
+    if constexpr (N == 3) {
+        const T *l2 = lhs.lane(2), *r2 = rhs.lane(2);
+        for (; i + W <= count; i += W) {
+            auto a0 = P::load(l0 + i), a1 = P::load(l1 + i), a2 = P::load(l2 + i);
+            auto b0 = P::load(r0 + i), b1 = P::load(r1 + i), b2 = P::load(r2 + i);
+            P::store(o0 + i, P::sub(P::mul(a1, b2), P::mul(a2, b1)));
+            P::store(o1 + i, P::sub(P::mul(a2, b0), P::mul(a0, b2)));
+            P::store(o2 + i, P::sub(P::mul(a0, b1), P::mul(a1, b0)));
+        }
+        for (; i < count; ++i) {
+            o0[i] = l1[i] * r2[i] - l2[i] * r1[i];
+            o1[i] = l2[i] * r0[i] - l0[i] * r2[i];
+            o2[i] = l0[i] * r1[i] - l1[i] * r0[i];
+        }
+    }
+    else {
+        // 2D vectors have z == 0, only the z component of the product is non-zero
+        for (; i + W <= count; i += W) {
+            auto a0 = P::load(l0 + i), a1 = P::load(l1 + i);
+            auto b0 = P::load(r0 + i), b1 = P::load(r1 + i);
+            P::store(o2 + i, P::sub(P::mul(a0, b1), P::mul(a1, b0)));
+        }
+        for (; i < count; ++i) {
+            o2[i] = l0[i] * r1[i] - l1[i] * r0[i];
+        }
+    }
+    return result;
+}
+
+template <typename T, MyMatrix::Layout L, typename A>
+MyVecBatch<T,3,A>& transformPoints(const MyMatrix::MyMat<T,4,4,L> &m, MyVecBatch<T,3,A> &batch)
+{
+    auto lanes = detail::lanesOf(batch);
+    detail::batchTransform<T,1>(batch.size(), lanes.data(), detail::affineOf(m));
+    return batch;
+}
+
+template <typename T, MyMatrix::Layout L, typename A>
+MyVecBatch<T,3,A>& transformVectors(const MyMatrix::MyMat<T,4,4,L> &m, MyVecBatch<T,3,A> &batch)
+{
+    auto lanes = detail::lanesOf(batch);
+    detail::batchTransform<T,0>(batch.size(), lanes.data(), detail::affineOf(m));
+    return batch;
+}
+
+} // namespace MyVector
@@ -0,0 +1,170 @@
+//
+//  myview.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef MYVIEW_H
+#define MYVIEW_H
+
+#include <iostream>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include "utils.h"
+#include "myexpr.h"
+#include "myexec.h"
+#include "mystats.h"
+#include "transpose.h"
+
+namespace MyMatrix {
+
+// Storage order of a matrix
+enum class Layout {
+    RowMajor,   // element (i,j) at i * cols + j
+    ColMajor    // element (i,j) at j * rows + i
+};
+
+// The container a view evaluates to, defined along with MyDynMat
+template <typename T>
+struct ViewResult;
+
+template <typename M>
+struct IsMatrix : std::false_type {};
+template <typename M>
+constexpr bool isMatrix = IsMatrix<std::decay_t<M>>::value;
+
+template <typename M>
+struct IsView : std::false_type {};
+template <typename M>
+constexpr bool isView = IsView<std::decay_t<M>>::value;
+
+/*!
+ * \brief A non-owning, strided window on the elements of a matrix
+ * \details MyMatView refers to rows x cols elements of some other matrix storage, with
+ * element (i,j) at data[i * rowStride + j * colStride]. Views are cheap to create and
+ * copy, and are returned by the transposed(), block(), row() and col() members of the
+ * matrix types (and of views themselves), so they can be nested:
+ *
+ * \verbatim
+ * MyDynMat<> big(1024, 1024);
+ * auto tile = big.block(256, 512, 64, 64);   // 64x64 tile, no copy
+ * tile *= 2;                                 // scales the tile inside big
+ * tile.row(0) = other.col(3).transposed();   // copies a column into the tile's first row
+ * \endverbatim
+ *
+ * A view of const T is read-only. Assigning to a view writes through to the
+ * referenced elements: views take part in the lazy element-wise expressions, and in
+ * the matrix multiply. A view (or an expression of views only) evaluates to a MyDynMat.
+ * Copying a view to a view or a MyDynMat of the other layout, as in
+ * dst = src.transposed(), runs the tiled transpose of transpose.h.
+ *
+ * The referenced matrix must outlive the view. Assigning an expression to a view that
+ * overlaps one of its operands in a different arrangement (e.g. a matrix and its own
+ * transpose) is not supported.
+ */
+template <typename T>
+class MyMatView : public MyExpr::Expression<MyMatView<T>> {
+public:
+    using value_type = std::remove_const_t<T>;
+    using result_type = typename ViewResult<value_type>::type;
+    static constexpr bool viewResult = true;
+
+    MyMatView(T *data, size_t rows, size_t cols, ptrdiff_t rowStride, ptrdiff_t colStride) noexcept;
+
+    // A view of T converts to a view of const T
+    template <typename U, typename = std::enable_if_t<std::is_same_v<const U, T>>>
+    MyMatView(const MyMatView<U> &other) noexcept :
+        MyMatView(other.data(), other.rows(), other.cols(), other.rowStride(), other.colStride())
+    {
+    }
+
+    MyMatView(const MyMatView &) = default;
+
+    // Assignment copies elements, it doesn't rebind the view
+    MyMatView& operator=(const MyMatView &);
+    template <typename E>
+    MyMatView& operator=(const MyExpr::Expression<E> &);
+
+    T* data() const noexcept { return data_; }
+    size_t rows() const noexcept { return rows_; }
+    size_t cols() const noexcept { return cols_; }
+    size_t size() const noexcept { return rows_ * cols_; }
+    bool empty() const noexcept { return size() == 0; }
+    ptrdiff_t rowStride() const noexcept { return rowStride_; }
+    ptrdiff_t colStride() const noexcept { return colStride_; }
+    bool isContiguous(Layout) const noexcept;
+    auto get_allocator() const { return typename result_type::allocator_type(); }
+
+    T& operator() (size_t row, size_t col) const;
+
+    MyMatView view() const noexcept { return *this; }
+    MyMatView transposed() const noexcept;
+    MyMatView block(size_t row, size_t col, size_t rows, size_t cols) const;
+    MyMatView row(size_t i) const;
+    MyMatView col(size_t j) const;
+
+    template <typename E>
+    MyMatView& operator+=(const MyExpr::Expression<E> &);
+    template <typename E>
+    MyMatView& operator-=(const MyExpr::Expression<E> &);
+    MyMatView& operator*=(double);
+
+    std::ostream& renderToStream(std::ostream &) const;
+
+private:
+    T *data_;
+    size_t rows_;
+    size_t cols_;
+    ptrdiff_t rowStride_;
+    ptrdiff_t colStride_;
+};
+
+template <typename T>
+struct IsMatrix<MyMatView<T>> : std::true_type {};
+template <typename T>
+struct IsView<MyMatView<T>> : std::true_type {};
+
+// Comparison of any two matrices where at least one is a view
+template <typename L, typename R, typename = std::enable_if_t<isMatrix<L> && isMatrix<R> && (isView<L> || isView<R>)>>
+bool operator==(const L &lhs, const R &rhs);
+template <typename L, typename R, typename = std::enable_if_t<isMatrix<L> && isMatrix<R> && (isView<L> || isView<R>)>>
+bool operator!=(const L &lhs, const R &rhs);
+
+// Render the view contents to the output stream
+template <typename T>
+std::ostream& operator<<(std::ostream &, const MyMatView<T> &);
+
+namespace detail {
+
+// Apply op(dst(i,j), expr(i,j)) over a strided destination. A single flat loop is used
+// when the destination and every operand are densely stored in the same order. Large
+// destinations are split into tiles of rows (or columns) that run on the MyExec pool.
+template <typename T, typename E, typename Op>
+void evalInto(T *data, size_t rows, size_t cols, ptrdiff_t rs, ptrdiff_t cs, Layout order,
+              bool contiguous, const E &e, Op op);
+
+// evalInto for the fixed size R x C storage of a MyMat. Small matrices use plain loops
+// over the compile-time extents, which the compiler unrolls and which also run in
+// constant expressions.
+template <size_t R, size_t C, Layout L, typename T, typename E, typename Op>
+constexpr void evalFixed(T *data, const E &e, Op op);
+
+template <typename T, typename E>
+constexpr void checkShape(const MyExpr::Expression<E> &, size_t rows, size_t cols);
+
+// Whether e reads a view of the storage [data, data + size) in another order than the
+// strides rs and cs the result is written with, so that evaluating e straight into that
+// storage could overwrite elements before they are read. Containers are read at the index
+// they are written to, which is safe.
+template <typename T, typename E>
+constexpr bool readsAcross(const T *data, size_t size, ptrdiff_t rs, ptrdiff_t cs, const E &e);
+
+} // namespace detail
+
+} // namespace MyMatrix
+
+#include "myview.tpp"
+
+#endif // MYVIEW_H
@@ -0,0 +1,327 @@
+//
+//  myview.tpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+namespace MyMatrix {
+
+namespace detail {
+
+template <typename T, typename E, typename Op>
+void evalInto(T *data, size_t rows, size_t cols, ptrdiff_t rs, ptrdiff_t cs, Layout order,
+              bool contiguous, const E &e, Op op)
+{
+    MYSTATS_COUNT("evaluate", rows * cols, rows * cols * MyExpr::Cost<E>::flops,
+                  rows * cols * sizeof(T) * (MyExpr::Cost<E>::reads + 1));
+    if (contiguous && e.isContiguous(order)) {
+        MyExec::parallelFor<T>(rows * cols, 1, [&](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                op(data[k], MyExpr::at(e, k));
+            }
+        });
+        return;
+    }
+    if (order == Layout::RowMajor) {
+        MyExec::parallelFor<T>(rows, cols, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                T *row = data + static_cast<ptrdiff_t>(i) * rs;
+                for (size_t j = 0; j < cols; ++j) {
+                    op(row[static_cast<ptrdiff_t>(j) * cs], MyExpr::at(e, i, j));
+                }
+            }
+        });
+    }
+    else {
+        MyExec::parallelFor<T>(cols, rows, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                T *col = data + static_cast<ptrdiff_t>(j) * cs;
+                for (size_t i = 0; i < rows; ++i) {
+                    op(col[static_cast<ptrdiff_t>(i) * rs], MyExpr::at(e, i, j));
+                }
+            }
+        });
+    }
+}
+
+// Copy a view into storage of the other layout, which is a transpose of the storage.
+// Returns false, having done nothing, unless e is a view and the layouts differ.
+template <typename T, typename E>
+bool copyAcrossLayouts(T *data, size_t rows, size_t cols, ptrdiff_t rs, ptrdiff_t cs, const E &e)
+{
+    if constexpr (isView<E>) {
+        if (rows < 2 || cols < 2) {
+            return false;
+        }
+        if (cs == 1 && e.rowStride() == 1) {
+            transposeCopy<T>(cols, rows, e.data(), e.colStride(), data, rs);
+            return true;
+        }
+        if (rs == 1 && e.colStride() == 1) {
+            transposeCopy<T>(rows, cols, e.data(), e.rowStride(), data, cs);
+            return true;
+        }
+    }
+    (void)data;
+    (void)rows;
+    (void)cols;
+    (void)rs;
+    (void)cs;
+    (void)e;
+    return false;
+}
+
+template <size_t R, size_t C, Layout L, typename T, typename E, typename Op>
+constexpr void evalFixed(T *data, const E &e, Op op)
+{
+    if constexpr (R * C < MyExec::minParallelElements) {
+        MYSTATS_COUNT("evaluate", R * C, R * C * MyExpr::Cost<E>::flops, R * C * sizeof(T) * (MyExpr::Cost<E>::reads + 1));
+        if (e.isContiguous(L)) {
+            for (size_t k = 0; k < R * C; ++k) {
+                op(data[k], MyExpr::at(e, k));
+            }
+            return;
+        }
+        for (size_t i = 0; i < R; ++i) {
+            for (size_t j = 0; j < C; ++j) {
+                op(data[L == Layout::RowMajor ? i * C + j : j * R + i], MyExpr::at(e, i, j));
+            }
+        }
+    }
+    else {
+        constexpr ptrdiff_t rs = L == Layout::RowMajor ? C : 1;
+        constexpr ptrdiff_t cs = L == Layout::RowMajor ? 1 : R;
+        evalInto(data, R, C, rs, cs, L, true, e, op);
+    }
+}
+
+template <typename T, typename E>
+constexpr void checkShape(const MyExpr::Expression<E> &expr, size_t rows, size_t cols)
+{
+    static_assert (std::is_same_v<typename E::value_type, T>, "Expression has a different value type");
+    assert(expr.self().rows() == rows && expr.self().cols() == cols);
+    (void)expr;
+    (void)rows;
+    (void)cols;
+}
+
+// True for the nodes of a single operand, false for the binary ones
+template <typename E, typename = void>
+struct HasOperand : std::false_type {};
+template <typename E>
+struct HasOperand<E, std::void_t<decltype(std::declval<const E&>().operand())>> : std::true_type {};
+
+template <typename T, typename E>
+constexpr bool readsAcross(const T *data, size_t size, ptrdiff_t rs, ptrdiff_t cs, const E &e)
+{
+    if constexpr (MyExpr::isNode<E>) {
+        if constexpr (HasOperand<E>::value) {
+            return readsAcross(data, size, rs, cs, e.operand());
+        }
+        else {
+            return readsAcross(data, size, rs, cs, e.lhs()) || readsAcross(data, size, rs, cs, e.rhs());
+        }
+    }
+    else if constexpr (isView<E>) {
+        if (e.size() == 0 || size == 0) {
+            return false;
+        }
+        // The elements of the view span [first, last]
+        ptrdiff_t down = static_cast<ptrdiff_t>(e.rows() - 1) * e.rowStride();
+        ptrdiff_t across = static_cast<ptrdiff_t>(e.cols() - 1) * e.colStride();
+        const T *first = e.data() + std::min<ptrdiff_t>(down, 0) + std::min<ptrdiff_t>(across, 0);
+        const T *last = e.data() + std::max<ptrdiff_t>(down, 0) + std::max<ptrdiff_t>(across, 0);
+        std::less<const T*> before;
+        if (before(last, data) || !before(first, data + size)) {
+            return false;
+        }
+        // Read in the order it is written: a single row or column only needs the one stride
+        return !(e.data() == data && (e.rows() < 2 || e.rowStride() == rs) && (e.cols() < 2 || e.colStride() == cs));
+    }
+    else {
+        (void)data;
+        (void)size;
+        (void)rs;
+        (void)cs;
+        (void)e;
+        return false;
+    }
+}
+
+// Traverse a view in the order of its smallest stride
+inline Layout naturalOrder(ptrdiff_t rs, ptrdiff_t cs)
+{
+    return (rs == 1 && cs != 1) ? Layout::ColMajor : Layout::RowMajor;
+}
+
+} // namespace detail
+
+template <typename T>
+MyMatView<T>::MyMatView(T *data, size_t rows, size_t cols, ptrdiff_t rowStride, ptrdiff_t colStride) noexcept :
+    data_(data),
+    rows_(rows),
+    cols_(cols),
+    rowStride_(rowStride),
+    colStride_(colStride)
+{
+}
+
+template <typename T>
+MyMatView<T>& MyMatView<T>::operator=(const MyMatView &rhs)
+{
+    return *this = static_cast<const MyExpr::Expression<MyMatView> &>(rhs);
+}
+
+template <typename T>
+template <typename E>
+MyMatView<T>& MyMatView<T>::operator=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (!std::is_const_v<T>, "Can't assign to a read-only view");
+    detail::checkShape<value_type>(expr, rows_, cols_);
+    if (detail::copyAcrossLayouts(data_, rows_, cols_, rowStride_, colStride_, expr.self())) {
+        return *this;
+    }
+    detail::evalInto(data_, rows_, cols_, rowStride_, colStride_, detail::naturalOrder(rowStride_, colStride_),
+                     isContiguous(detail::naturalOrder(rowStride_, colStride_)), expr.self(),
+                     [](value_type &d, const auto &v) { d = v; });
+    return *this;
+}
+
+template <typename T>
+bool MyMatView<T>::isContiguous(Layout order) const noexcept
+{
+    if (order == Layout::RowMajor) {
+        return (colStride_ == 1 || cols_ <= 1) && (rowStride_ == static_cast<ptrdiff_t>(cols_) || rows_ <= 1);
+    }
+    return (rowStride_ == 1 || rows_ <= 1) && (colStride_ == static_cast<ptrdiff_t>(rows_) || cols_ <= 1);
+}
+
+template <typename T>
+T& MyMatView<T>::operator()(size_t row, size_t col) const
+{
+    return data_[static_cast<ptrdiff_t>(row) * rowStride_ + static_cast<ptrdiff_t>(col) * colStride_];
+}
+
+template <typename T>
+MyMatView<T> MyMatView<T>::transposed() const noexcept
+{
+    return MyMatView(data_, cols_, rows_, colStride_, rowStride_);
+}
+
+template <typename T>
+MyMatView<T> MyMatView<T>::block(size_t row, size_t col, size_t rows, size_t cols) const
+{
+    assert(row + rows <= rows_ && col + cols <= cols_);
+    return MyMatView(&(*this)(row, col), rows, cols, rowStride_, colStride_);
+}
+
+template <typename T>
+MyMatView<T> MyMatView<T>::row(size_t i) const
+{
+    return block(i, 0, 1, cols_);
+}
+
+template <typename T>
+MyMatView<T> MyMatView<T>::col(size_t j) const
+{
+    return block(0, j, rows_, 1);
+}
+
+template <typename T>
+template <typename E>
+MyMatView<T>& MyMatView<T>::operator+=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (!std::is_const_v<T>, "Can't assign to a read-only view");
+    detail::checkShape<value_type>(expr, rows_, cols_);
+    detail::evalInto(data_, rows_, cols_, rowStride_, colStride_, detail::naturalOrder(rowStride_, colStride_),
+                     isContiguous(detail::naturalOrder(rowStride_, colStride_)), expr.self(),
+                     [](value_type &d, const auto &v) { d += v; });
+    return *this;
+}
+
+template <typename T>
+template <typename E>
+MyMatView<T>& MyMatView<T>::operator-=(const MyExpr::Expression<E> &expr)
+{
+    static_assert (!std::is_const_v<T>, "Can't assign to a read-only view");
+    detail::checkShape<value_type>(expr, rows_, cols_);
+    detail::evalInto(data_, rows_, cols_, rowStride_, colStride_, detail::naturalOrder(rowStride_, colStride_),
+                     isContiguous(detail::naturalOrder(rowStride_, colStride_)), expr.self(),
+                     [](value_type &d, const auto &v) { d -= v; });
+    return *this;
+}
+
+template <typename T>
+MyMatView<T>& MyMatView<T>::operator*=(double rhs)
+{
+    static_assert (!std::is_const_v<T>, "Can't assign to a read-only view");
+    MyExec::parallelFor<value_type>(rows_, cols_, [this, rhs](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            for (size_t j = 0; j < cols_; ++j) {
+                (*this)(i,j) *= rhs;
+            }
+        }
+    });
+    return *this;
+}
+
+template <typename T>
+std::ostream& MyMatView<T>::renderToStream(std::ostream &os) const
+{
+    for (size_t i = 0; i < rows_; ++i) {
+        for (size_t j = 0; j < cols_; ++j) {
+            os << (*this)(i,j) << " ";
+        }
+        os << "\n";
+    }
+
+    return os;
+}
+
+// Related non-members
+
+template <typename L, typename R, typename>
+bool operator==(const L &lhs, const R &rhs)
+{
+    using T = typename L::value_type;
+    static_assert (std::is_same_v<T, typename R::value_type>, "Matrices must have the same value type");
+
+    auto numRows = lhs.rows();
+    auto numCols = lhs.cols();
+    if (numRows != rhs.rows() ||
+        numCols != rhs.cols()) {
+        return false;
+    }
+    MYSTATS_COUNT("compare", numRows * numCols, numRows * numCols, 2 * numRows * numCols * sizeof(T));
+
+    for (size_t i = 0; i < numRows; ++i) {
+        for (size_t j = 0; j < numCols; ++j) {
+            if constexpr (std::is_integral_v<T>) {
+                if (lhs(i,j) != rhs(i,j)) {
+                    return false;
+                }
+            }
+            else {
+                if (!almost_equal(lhs(i,j), rhs(i,j), 2)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <typename L, typename R, typename>
+bool operator!=(const L &lhs, const R &rhs)
+{
+    return !(lhs == rhs);
+}
+
+template <typename T>
+std::ostream& operator<<(std::ostream &os, const MyMatView<T> &v)
+{
+    return v.renderToStream(os);
+}
+
+} // namespace MyMatrix
@@ -0,0 +1,299 @@
+//
+//  simd.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <cstddef>
+#include <cmath>
+
+#if defined(__AVX512F__) || defined(__AVX2__) || defined(__AVX__) || defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// Ask the compiler to fully unroll a loop with a small constant trip count, so that
+// arrays of vector registers (e.g. micro-kernel accumulators) are kept in registers
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSIMD_UNROLL _Pragma("GCC unroll 16")
+#else
+#define MYSIMD_UNROLL
+#endif
+
+// Inline every call made from a function's body, including calls to lambdas, so that
+// kernels written as nested compile-time loops (see mydecomp.tpp) become straight-line code
+#if defined(__GNUC__) || defined(__clang__)
+#define MYSIMD_FLATTEN __attribute__((flatten))
+#else
+#define MYSIMD_FLATTEN
+#endif
+
+// Whether the compiler can tell constant evaluation from a runtime call, see isConstantEvaluated()
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define MYSIMD_HAS_CONSTANT_EVALUATED 1
+#endif
+#endif
+#if !defined(MYSIMD_HAS_CONSTANT_EVALUATED) && defined(_MSC_VER) && _MSC_VER >= 1925
+#define MYSIMD_HAS_CONSTANT_EVALUATED 1
+#endif
+
+/*!
+ * \brief A thin wrapper around the native vector registers of the target
+ * \details Pack<T> exposes a fixed set of operations (load, store, broadcast,
+ * arithmetic, fused multiply-add, max, sqrt and a reciprocal square root estimate)
+ * on the widest register the compiler is allowed to use for T. The widest
+ * instruction set enabled at compile time is picked: AVX-512, AVX2/FMA, SSE2 or
+ * NEON. Any other type, or a target without vector support, falls back to the
+ * generic template which has a width of 1 and works on plain scalars, so kernels
+ * written against Pack<T> always compile.
+ *
+ * Loads and stores are unaligned; aligned storage is still faster, but it is
+ * not required for correctness.
+ */
+namespace MySimd {
+
+template <typename T>
+struct Pack {
+    using type = T;
+    static constexpr size_t width = 1;
+    // Newton-Raphson steps needed after rsqrt() to reach full precision
+    static constexpr int rsqrtSteps = 0;
+
+    static type load(const T *p) { return *p; }
+    static void store(T *p, type v) { *p = v; }
+    static type set1(T v) { return v; }
+    static type zero() { return T(0); }
+    static type add(type a, type b) { return a + b; }
+    static type sub(type a, type b) { return a - b; }
+    static type mul(type a, type b) { return a * b; }
+    static type div(type a, type b) { return a / b; }
+    // a * b + c
+    static type fmadd(type a, type b, type c) { return a * b + c; }
+    static type max(type a, type b) { return a < b ? b : a; }
+    static type sqrt(type a) { return std::sqrt(a); }
+    // Estimate of 1/sqrt(a), refine with rsqrtStep for more precision
+    static type rsqrt(type a) { return T(1) / std::sqrt(a); }
+};
+
+#if defined(__AVX512F__)
+
+// GCC 12 warns that the unmasked AVX-512 max, sqrt and rsqrt14 intrinsics may use an
+// uninitialized value: they are written as masked operations on an undefined source
+// with an all-ones mask, so the undefined value is never read
+#if defined(__GNUC__) && !defined(__clang__)
+#define MYSIMD_AVX512_SUPPRESS_BEGIN \
+    _Pragma("GCC diagnostic push") \
+    _Pragma("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+#define MYSIMD_AVX512_SUPPRESS_END _Pragma("GCC diagnostic pop")
+#else
+#define MYSIMD_AVX512_SUPPRESS_BEGIN
+#define MYSIMD_AVX512_SUPPRESS_END
+#endif
+
+template <>
+struct Pack<double> {
+    using type = __m512d;
+    static constexpr size_t width = 8;
+    static constexpr int rsqrtSteps = 2;
+
+    static type load(const double *p) { return _mm512_loadu_pd(p); }
+    static void store(double *p, type v) { _mm512_storeu_pd(p, v); }
+    static type set1(double v) { return _mm512_set1_pd(v); }
+    static type zero() { return _mm512_setzero_pd(); }
+    static type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm512_div_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+MYSIMD_AVX512_SUPPRESS_BEGIN
+    static type max(type a, type b) { return _mm512_max_pd(a, b); }
+    static type sqrt(type a) { return _mm512_sqrt_pd(a); }
+    static type rsqrt(type a) { return _mm512_rsqrt14_pd(a); }
+MYSIMD_AVX512_SUPPRESS_END
+};
+
+template <>
+struct Pack<float> {
+    using type = __m512;
+    static constexpr size_t width = 16;
+    static constexpr int rsqrtSteps = 1;
+
+    static type load(const float *p) { return _mm512_loadu_ps(p); }
+    static void store(float *p, type v) { _mm512_storeu_ps(p, v); }
+    static type set1(float v) { return _mm512_set1_ps(v); }
+    static type zero() { return _mm512_setzero_ps(); }
+    static type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm512_div_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_ps(a, b, c); }
+MYSIMD_AVX512_SUPPRESS_BEGIN
+    static type max(type a, type b) { return _mm512_max_ps(a, b); }
+    static type sqrt(type a) { return _mm512_sqrt_ps(a); }
+    static type rsqrt(type a) { return _mm512_rsqrt14_ps(a); }
+MYSIMD_AVX512_SUPPRESS_END
+};
+
+#elif defined(__AVX2__) && defined(__FMA__)
+
+template <>
+struct Pack<double> {
+    using type = __m256d;
+    static constexpr size_t width = 4;
+    static constexpr int rsqrtSteps = 0;
+
+    static type load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, type v) { _mm256_storeu_pd(p, v); }
+    static type set1(double v) { return _mm256_set1_pd(v); }
+    static type zero() { return _mm256_setzero_pd(); }
+    static type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm256_div_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+    static type max(type a, type b) { return _mm256_max_pd(a, b); }
+    static type sqrt(type a) { return _mm256_sqrt_pd(a); }
+    // No double precision estimate before AVX-512, and converting through single precision
+    // loses the range of double, so this one is exact
+    static type rsqrt(type a) { return _mm256_div_pd(_mm256_set1_pd(1.0), _mm256_sqrt_pd(a)); }
+};
+
+template <>
+struct Pack<float> {
+    using type = __m256;
+    static constexpr size_t width = 8;
+    static constexpr int rsqrtSteps = 1;
+
+    static type load(const float *p) { return _mm256_loadu_ps(p); }
+    static void store(float *p, type v) { _mm256_storeu_ps(p, v); }
+    static type set1(float v) { return _mm256_set1_ps(v); }
+    static type zero() { return _mm256_setzero_ps(); }
+    static type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm256_div_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_ps(a, b, c); }
+    static type max(type a, type b) { return _mm256_max_ps(a, b); }
+    static type sqrt(type a) { return _mm256_sqrt_ps(a); }
+    static type rsqrt(type a) { return _mm256_rsqrt_ps(a); }
+};
+
+#elif defined(__SSE2__) || defined(_M_X64)
+
+template <>
+struct Pack<double> {
+    using type = __m128d;
+    static constexpr size_t width = 2;
+    static constexpr int rsqrtSteps = 0;
+
+    static type load(const double *p) { return _mm_loadu_pd(p); }
+    static void store(double *p, type v) { _mm_storeu_pd(p, v); }
+    static type set1(double v) { return _mm_set1_pd(v); }
+    static type zero() { return _mm_setzero_pd(); }
+    static type add(type a, type b) { return _mm_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm_div_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static type max(type a, type b) { return _mm_max_pd(a, b); }
+    static type sqrt(type a) { return _mm_sqrt_pd(a); }
+    // No double precision estimate, and converting through single precision loses
+    // the range of double, so this one is exact
+    static type rsqrt(type a) { return _mm_div_pd(_mm_set1_pd(1.0), _mm_sqrt_pd(a)); }
+};
+
+template <>
+struct Pack<float> {
+    using type = __m128;
+    static constexpr size_t width = 4;
+    static constexpr int rsqrtSteps = 1;
+
+    static type load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, type v) { _mm_storeu_ps(p, v); }
+    static type set1(float v) { return _mm_set1_ps(v); }
+    static type zero() { return _mm_setzero_ps(); }
+    static type add(type a, type b) { return _mm_add_ps(a, b); }
+    static type sub(type a, type b) { return _mm_sub_ps(a, b); }
+    static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+    static type div(type a, type b) { return _mm_div_ps(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static type max(type a, type b) { return _mm_max_ps(a, b); }
+    static type sqrt(type a) { return _mm_sqrt_ps(a); }
+    static type rsqrt(type a) { return _mm_rsqrt_ps(a); }
+};
+
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+
+template <>
+struct Pack<double> {
+    using type = float64x2_t;
+    static constexpr size_t width = 2;
+    static constexpr int rsqrtSteps = 3;
+
+    static type load(const double *p) { return vld1q_f64(p); }
+    static void store(double *p, type v) { vst1q_f64(p, v); }
+    static type set1(double v) { return vdupq_n_f64(v); }
+    static type zero() { return vdupq_n_f64(0.0); }
+    static type add(type a, type b) { return vaddq_f64(a, b); }
+    static type sub(type a, type b) { return vsubq_f64(a, b); }
+    static type mul(type a, type b) { return vmulq_f64(a, b); }
+    static type div(type a, type b) { return vdivq_f64(a, b); }
+    static type fmadd(type a, type b, type c) { return vfmaq_f64(c, a, b); }
+    static type max(type a, type b) { return vmaxq_f64(a, b); }
+    static type sqrt(type a) { return vsqrtq_f64(a); }
+    static type rsqrt(type a) { return vrsqrteq_f64(a); }
+};
+
+template <>
+struct Pack<float> {
+    using type = float32x4_t;
+    static constexpr size_t width = 4;
+    static constexpr int rsqrtSteps = 2;
+
+    static type load(const float *p) { return vld1q_f32(p); }
+    static void store(float *p, type v) { vst1q_f32(p, v); }
+    static type set1(float v) { return vdupq_n_f32(v); }
+    static type zero() { return vdupq_n_f32(0.0f); }
+    static type add(type a, type b) { return vaddq_f32(a, b); }
+    static type sub(type a, type b) { return vsubq_f32(a, b); }
+    static type mul(type a, type b) { return vmulq_f32(a, b); }
+    static type div(type a, type b) { return vdivq_f32(a, b); }
+    static type fmadd(type a, type b, type c) { return vfmaq_f32(c, a, b); }
+    static type max(type a, type b) { return vmaxq_f32(a, b); }
+    static type sqrt(type a) { return vsqrtq_f32(a); }
+    static type rsqrt(type a) { return vrsqrteq_f32(a); }
+};
+
+#endif
+
+// One Newton-Raphson step on an estimate y of 1/sqrt(x): y * (1.5 - 0.5 * x * y * y).
+// Each step roughly doubles the number of correct bits.
+template <typename T>
+typename Pack<T>::type rsqrtStep(typename Pack<T>::type x, typename Pack<T>::type y)
+{
+    using P = Pack<T>;
+    auto halfXYY = P::mul(P::mul(P::set1(T(0.5)), x), P::mul(y, y));
+    return P::mul(y, P::sub(P::set1(T(1.5)), halfXYY));
+}
+
+// True while a constexpr function is evaluated in a constant expression, where the
+// intrinsics above can't be used. constexpr kernels check it to pick their scalar code.
+// Compilers that can't tell always get the scalar code.
+constexpr bool isConstantEvaluated() noexcept
+{
+#ifdef MYSIMD_HAS_CONSTANT_EVALUATED
+    return __builtin_is_constant_evaluated();
+#else
+    return true;
+#endif
+}
+
+} // namespace MySimd
+
+#endif // SIMD_H
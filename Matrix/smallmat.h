@@ -0,0 +1,403 @@
+//
+//  smallmat.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef SMALLMAT_H
+#define SMALLMAT_H
+
+#include <cstddef>
+#include "simd.h"
+
+/*!
+ * \brief Unrolled kernels for 2x2, 3x3 and 4x4 matrices
+ * \details These are the sizes of geometric transforms, for which the general code
+ * (gemm.h, mydecomp.h) spends more time on setup than on arithmetic. Each kernel is
+ * written for its size and has no loop left once compiled. Determinant and inverse use
+ * the closed forms (cofactor expansion), instead of an LU factorization.
+ *
+ * The kernels are constexpr. In a constant expression they run their scalar code, so
+ * that a transform made of constants folds at compile time. At runtime a 4x4 float
+ * matrix is held in four SSE or NEON registers, one per row, and a 4x4 double matrix
+ * in four AVX registers: a product is four broadcast multiply-adds per row, and a
+ * transpose a few shuffles. The 2x2 and 3x3 kernels are straight-line scalar code,
+ * which the compiler vectorizes as it sees fit, rather than padding 3 elements to 4.
+ *
+ * Matrices are in row-major storage. Column-major matrices reuse the kernels through
+ * the transpose, as the storage of a column-major A is the row-major storage of A^T.
+ * MyMat (mymat.h) and the decompositions (mydecomp.h) dispatch to them.
+ */
+namespace MyMatrix {
+
+namespace detail {
+
+// Four elements of T in one register, when the target has one
+template <typename T>
+struct Quad {
+    static constexpr bool available = false;
+};
+
+#if defined(__SSE2__) || defined(_M_X64)
+
+template <>
+struct Quad<float> {
+    using type = __m128;
+    static constexpr bool available = true;
+
+    static type load(const float *p) { return _mm_loadu_ps(p); }
+    static void store(float *p, type v) { _mm_storeu_ps(p, v); }
+    static type set1(float v) { return _mm_set1_ps(v); }
+    static type add(type a, type b) { return _mm_add_ps(a, b); }
+    static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+#if defined(__FMA__)
+    static type fmadd(type a, type b, type c) { return _mm_fmadd_ps(a, b, c); }
+#else
+    static type fmadd(type a, type b, type c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+    static void transpose(type &r0, type &r1, type &r2, type &r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+};
+
+#elif defined(__ARM_NEON)
+
+template <>
+struct Quad<float> {
+    using type = float32x4_t;
+    static constexpr bool available = true;
+
+    static type load(const float *p) { return vld1q_f32(p); }
+    static void store(float *p, type v) { vst1q_f32(p, v); }
+    static type set1(float v) { return vdupq_n_f32(v); }
+    static type add(type a, type b) { return vaddq_f32(a, b); }
+    static type mul(type a, type b) { return vmulq_f32(a, b); }
+#if defined(__aarch64__)
+    static type fmadd(type a, type b, type c) { return vfmaq_f32(c, a, b); }
+#else
+    static type fmadd(type a, type b, type c) { return vmlaq_f32(c, a, b); }
+#endif
+    static void transpose(type &r0, type &r1, type &r2, type &r3)
+    {
+        float32x4x2_t t01 = vtrnq_f32(r0, r1);
+        float32x4x2_t t23 = vtrnq_f32(r2, r3);
+        r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+        r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+        r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+        r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+    }
+};
+
+#endif
+
+#if defined(__AVX__)
+
+template <>
+struct Quad<double> {
+    using type = __m256d;
+    static constexpr bool available = true;
+
+    static type load(const double *p) { return _mm256_loadu_pd(p); }
+    static void store(double *p, type v) { _mm256_storeu_pd(p, v); }
+    static type set1(double v) { return _mm256_set1_pd(v); }
+    static type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+#if defined(__FMA__)
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static type fmadd(type a, type b, type c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+    static void transpose(type &r0, type &r1, type &r2, type &r3)
+    {
+        type t0 = _mm256_unpacklo_pd(r0, r1);
+        type t1 = _mm256_unpackhi_pd(r0, r1);
+        type t2 = _mm256_unpacklo_pd(r2, r3);
+        type t3 = _mm256_unpackhi_pd(r2, r3);
+        r0 = _mm256_permute2f128_pd(t0, t2, 0x20);
+        r1 = _mm256_permute2f128_pd(t1, t3, 0x20);
+        r2 = _mm256_permute2f128_pd(t0, t2, 0x31);
+        r3 = _mm256_permute2f128_pd(t1, t3, 0x31);
+    }
+};
+
+#endif
+
+// Whether the 4x4 kernels have a vector version for T
+template <typename T, size_t N>
+constexpr bool hasQuadKernel = N == 4 && Quad<T>::available;
+
+// The vector versions, only called when hasQuadKernel
+template <typename T>
+void quadMultiply(const T *a, const T *b, T *c)
+{
+    using Q = Quad<T>;
+    const auto b0 = Q::load(b);
+    const auto b1 = Q::load(b + 4);
+    const auto b2 = Q::load(b + 8);
+    const auto b3 = Q::load(b + 12);
+    MYSIMD_UNROLL
+    for (size_t i = 0; i < 4; ++i) {
+        const T *ai = a + 4 * i;
+        auto r = Q::mul(Q::set1(ai[0]), b0);
+        r = Q::fmadd(Q::set1(ai[1]), b1, r);
+        r = Q::fmadd(Q::set1(ai[2]), b2, r);
+        r = Q::fmadd(Q::set1(ai[3]), b3, r);
+        Q::store(c + 4 * i, r);
+    }
+}
+
+template <typename T>
+void quadTranspose(const T *a, T *c)
+{
+    using Q = Quad<T>;
+    auto r0 = Q::load(a);
+    auto r1 = Q::load(a + 4);
+    auto r2 = Q::load(a + 8);
+    auto r3 = Q::load(a + 12);
+    Q::transpose(r0, r1, r2, r3);
+    Q::store(c, r0);
+    Q::store(c + 4, r1);
+    Q::store(c + 8, r2);
+    Q::store(c + 12, r3);
+}
+
+// y = Ax: the four row products, transposed so that their sums are lane-wise
+template <typename T>
+void quadTransform(const T *a, const T *x, T *y)
+{
+    using Q = Quad<T>;
+    const auto vx = Q::load(x);
+    auto p0 = Q::mul(Q::load(a), vx);
+    auto p1 = Q::mul(Q::load(a + 4), vx);
+    auto p2 = Q::mul(Q::load(a + 8), vx);
+    auto p3 = Q::mul(Q::load(a + 12), vx);
+    Q::transpose(p0, p1, p2, p3);
+    Q::store(y, Q::add(Q::add(p0, p1), Q::add(p2, p3)));
+}
+
+// y = A^Tx: the rows of A scaled by the elements of x
+template <typename T>
+void quadTransformTransposed(const T *a, const T *x, T *y)
+{
+    using Q = Quad<T>;
+    auto r = Q::mul(Q::set1(x[0]), Q::load(a));
+    r = Q::fmadd(Q::set1(x[1]), Q::load(a + 4), r);
+    r = Q::fmadd(Q::set1(x[2]), Q::load(a + 8), r);
+    r = Q::fmadd(Q::set1(x[3]), Q::load(a + 12), r);
+    Q::store(y, r);
+}
+
+// c = ab for N x N matrices, c can be a but not b
+template <size_t N, typename T>
+constexpr void smallMultiply(const T *a, const T *b, T *c)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    if constexpr (hasQuadKernel<T,N>) {
+        if (!MySimd::isConstantEvaluated()) {
+            quadMultiply(a, b, c);
+            return;
+        }
+    }
+    MYSIMD_UNROLL
+    for (size_t i = 0; i < N; ++i) {
+        T row[N] = {};
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < N; ++j) {
+            T sum = a[i * N] * b[j];
+            MYSIMD_UNROLL
+            for (size_t k = 1; k < N; ++k) {
+                sum += a[i * N + k] * b[k * N + j];
+            }
+            row[j] = sum;
+        }
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < N; ++j) {
+            c[i * N + j] = row[j];
+        }
+    }
+}
+
+// c = a^T for an N x N matrix, c can be a
+template <size_t N, typename T>
+constexpr void smallTranspose(const T *a, T *c)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    if constexpr (hasQuadKernel<T,N>) {
+        if (!MySimd::isConstantEvaluated()) {
+            quadTranspose(a, c);
+            return;
+        }
+    }
+    T t[N * N] = {};
+    MYSIMD_UNROLL
+    for (size_t k = 0; k < N * N; ++k) {
+        t[k] = a[k];
+    }
+    MYSIMD_UNROLL
+    for (size_t i = 0; i < N; ++i) {
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < N; ++j) {
+            c[j * N + i] = t[i * N + j];
+        }
+    }
+}
+
+// y = Ax for an N x N matrix, y can't be x
+template <size_t N, typename T>
+constexpr void smallTransform(const T *a, const T *x, T *y)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    if constexpr (hasQuadKernel<T,N>) {
+        if (!MySimd::isConstantEvaluated()) {
+            quadTransform(a, x, y);
+            return;
+        }
+    }
+    MYSIMD_UNROLL
+    for (size_t i = 0; i < N; ++i) {
+        T sum = a[i * N] * x[0];
+        MYSIMD_UNROLL
+        for (size_t j = 1; j < N; ++j) {
+            sum += a[i * N + j] * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+// y = A^Tx for an N x N matrix, y can't be x
+template <size_t N, typename T>
+constexpr void smallTransformTransposed(const T *a, const T *x, T *y)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    if constexpr (hasQuadKernel<T,N>) {
+        if (!MySimd::isConstantEvaluated()) {
+            quadTransformTransposed(a, x, y);
+            return;
+        }
+    }
+    MYSIMD_UNROLL
+    for (size_t j = 0; j < N; ++j) {
+        y[j] = a[j] * x[0];
+    }
+    MYSIMD_UNROLL
+    for (size_t i = 1; i < N; ++i) {
+        MYSIMD_UNROLL
+        for (size_t j = 0; j < N; ++j) {
+            y[j] += a[i * N + j] * x[i];
+        }
+    }
+}
+
+// The 2x2 sub-determinants of rows 0-1 (s) and rows 2-3 (c) of a 4x4 matrix, shared by
+// the determinant and the inverse
+template <typename T>
+struct Minors4 {
+    T s0, s1, s2, s3, s4, s5;
+    T c0, c1, c2, c3, c4, c5;
+
+    constexpr explicit Minors4(const T *m) :
+        s0(m[0] * m[5] - m[1] * m[4]),
+        s1(m[0] * m[6] - m[2] * m[4]),
+        s2(m[0] * m[7] - m[3] * m[4]),
+        s3(m[1] * m[6] - m[2] * m[5]),
+        s4(m[1] * m[7] - m[3] * m[5]),
+        s5(m[2] * m[7] - m[3] * m[6]),
+        c0(m[8] * m[13] - m[9] * m[12]),
+        c1(m[8] * m[14] - m[10] * m[12]),
+        c2(m[8] * m[15] - m[11] * m[12]),
+        c3(m[9] * m[14] - m[10] * m[13]),
+        c4(m[9] * m[15] - m[11] * m[13]),
+        c5(m[10] * m[15] - m[11] * m[14])
+    {
+    }
+
+    constexpr T determinant() const { return s0 * c5 - s1 * c4 + s2 * c3 + s3 * c2 - s4 * c1 + s5 * c0; }
+};
+
+// Determinant of an N x N matrix, the same for both storage orders
+template <size_t N, typename T>
+constexpr T smallDeterminant(const T *m)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    if constexpr (N == 1) {
+        return m[0];
+    }
+    else if constexpr (N == 2) {
+        return m[0] * m[3] - m[1] * m[2];
+    }
+    else if constexpr (N == 3) {
+        return m[0] * (m[4] * m[8] - m[5] * m[7])
+             - m[1] * (m[3] * m[8] - m[5] * m[6])
+             + m[2] * (m[3] * m[7] - m[4] * m[6]);
+    }
+    else {
+        return Minors4<T>(m).determinant();
+    }
+}
+
+// inv = m^-1 for an N x N matrix, false when m is singular. The inverse of the
+// transpose is the transpose of the inverse, so both storage orders work. inv can be m.
+template <size_t N, typename T>
+constexpr bool smallInverse(const T *m, T *inv)
+{
+    static_assert (N >= 1 && N <= 4, "Small matrix kernels are for orders 1 to 4");
+    T r[N * N] = {};
+    T det = 0;
+    if constexpr (N == 1) {
+        det = m[0];
+        r[0] = 1;
+    }
+    else if constexpr (N == 2) {
+        det = m[0] * m[3] - m[1] * m[2];
+        r[0] = m[3];
+        r[1] = -m[1];
+        r[2] = -m[2];
+        r[3] = m[0];
+    }
+    else if constexpr (N == 3) {
+        r[0] = m[4] * m[8] - m[5] * m[7];
+        r[1] = m[2] * m[7] - m[1] * m[8];
+        r[2] = m[1] * m[5] - m[2] * m[4];
+        r[3] = m[5] * m[6] - m[3] * m[8];
+        r[4] = m[0] * m[8] - m[2] * m[6];
+        r[5] = m[2] * m[3] - m[0] * m[5];
+        r[6] = m[3] * m[7] - m[4] * m[6];
+        r[7] = m[1] * m[6] - m[0] * m[7];
+        r[8] = m[0] * m[4] - m[1] * m[3];
+        det = m[0] * r[0] + m[1] * r[3] + m[2] * r[6];
+    }
+    else {
+        const Minors4<T> k(m);
+        det = k.determinant();
+        r[0] = m[5] * k.c5 - m[6] * k.c4 + m[7] * k.c3;
+        r[1] = -m[1] * k.c5 + m[2] * k.c4 - m[3] * k.c3;
+        r[2] = m[13] * k.s5 - m[14] * k.s4 + m[15] * k.s3;
+        r[3] = -m[9] * k.s5 + m[10] * k.s4 - m[11] * k.s3;
+        r[4] = -m[4] * k.c5 + m[6] * k.c2 - m[7] * k.c1;
+        r[5] = m[0] * k.c5 - m[2] * k.c2 + m[3] * k.c1;
+        r[6] = -m[12] * k.s5 + m[14] * k.s2 - m[15] * k.s1;
+        r[7] = m[8] * k.s5 - m[10] * k.s2 + m[11] * k.s1;
+        r[8] = m[4] * k.c4 - m[5] * k.c2 + m[7] * k.c0;
+        r[9] = -m[0] * k.c4 + m[1] * k.c2 - m[3] * k.c0;
+        r[10] = m[12] * k.s4 - m[13] * k.s2 + m[15] * k.s0;
+        r[11] = -m[8] * k.s4 + m[9] * k.s2 - m[11] * k.s0;
+        r[12] = -m[4] * k.c3 + m[5] * k.c1 - m[6] * k.c0;
+        r[13] = m[0] * k.c3 - m[1] * k.c1 + m[2] * k.c0;
+        r[14] = -m[12] * k.s3 + m[13] * k.s1 - m[14] * k.s0;
+        r[15] = m[8] * k.s3 - m[9] * k.s1 + m[10] * k.s0;
+    }
+    if (det == T(0)) {
+        return false;
+    }
+    const T invDet = T(1) / det;
+    MYSIMD_UNROLL
+    for (size_t k = 0; k < N * N; ++k) {
+        inv[k] = r[k] * invDet;
+    }
+    return true;
+}
+
+} // namespace detail
+
+} // namespace MyMatrix
+
+#endif // SMALLMAT_H
@@ -0,0 +1,346 @@
+//
+//  transpose.h
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+#ifndef TRANSPOSE_H
+#define TRANSPOSE_H
+
+#include <cstddef>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "simd.h"
+#include "smallmat.h"
+#include "myexec.h"
+
+/*!
+ * \brief Cache-oblivious transpose kernels
+ * \details The kernels work on row-major storage: a matrix is a base pointer and a row
+ * stride, its rows are contiguous. A column-major matrix is the row-major storage of its
+ * transpose, so the same kernels convert between the layouts.
+ *
+ * A naive transpose writes the destination one column at a time, a cache line and
+ * often a TLB entry per element once the matrix is larger than L1. Here the matrix is
+ * split in half along its larger dimension until the blocks fit in L1 (transposeLeaf
+ * elements on a side), whatever the size of the caches. Within a block, TransposeTile
+ * transposes E x E micro-tiles in registers: 8x8 floats with AVX, 4x4 floats with SSE
+ * or NEON, 4x4 doubles with AVX, scalar code otherwise.
+ *
+ * transposeSquare transposes a square matrix in place, swapping the blocks on either
+ * side of the diagonal. transposeCycles transposes a rectangular matrix in place by
+ * following the permutation cycles of the elements. It needs one bit per element
+ * instead of a copy of the matrix, but its accesses are scattered, so it is several
+ * times slower than transposeCopy.
+ *
+ * Large transposes are split into tiles of about tileBytes of the MyExec context, run
+ * on its thread pool.
+ */
+namespace MyMatrix {
+namespace detail {
+
+// Largest side of a block transposed directly, two such blocks of doubles fit in L1
+constexpr size_t transposeLeaf = 32;
+
+// b = a^T for one E x E tile, a and b must not overlap
+template <typename T, typename = void>
+struct TransposeTile {
+    static constexpr size_t E = 4;
+
+    static void copy(const T *a, ptrdiff_t rsa, T *b, ptrdiff_t rsb)
+    {
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < E; ++i) {
+            MYSIMD_UNROLL
+            for (size_t j = 0; j < E; ++j) {
+                b[static_cast<ptrdiff_t>(j) * rsb + static_cast<ptrdiff_t>(i)] = a[static_cast<ptrdiff_t>(i) * rsa + static_cast<ptrdiff_t>(j)];
+            }
+        }
+    }
+};
+
+// The 4x4 register transposes of smallmat.h
+template <typename T>
+struct TransposeTile<T, std::enable_if_t<Quad<T>::available>> {
+    static constexpr size_t E = 4;
+
+    static void copy(const T *a, ptrdiff_t rsa, T *b, ptrdiff_t rsb)
+    {
+        using Q = Quad<T>;
+        auto r0 = Q::load(a);
+        auto r1 = Q::load(a + rsa);
+        auto r2 = Q::load(a + 2 * rsa);
+        auto r3 = Q::load(a + 3 * rsa);
+        Q::transpose(r0, r1, r2, r3);
+        Q::store(b, r0);
+        Q::store(b + rsb, r1);
+        Q::store(b + 2 * rsb, r2);
+        Q::store(b + 3 * rsb, r3);
+    }
+};
+
+#if defined(__AVX__)
+
+template <>
+struct TransposeTile<float> {
+    static constexpr size_t E = 8;
+
+    static void copy(const float *a, ptrdiff_t rsa, float *b, ptrdiff_t rsb)
+    {
+        __m256 r[8];
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < 8; ++i) {
+            r[i] = _mm256_loadu_ps(a + static_cast<ptrdiff_t>(i) * rsa);
+        }
+        // Interleave pairs of rows, then pairs of pairs, then swap the 128-bit halves
+        __m256 t[8];
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < 8; i += 2) {
+            t[i] = _mm256_unpacklo_ps(r[i], r[i + 1]);
+            t[i + 1] = _mm256_unpackhi_ps(r[i], r[i + 1]);
+        }
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < 8; i += 4) {
+            r[i] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 1] = _mm256_shuffle_ps(t[i], t[i + 2], _MM_SHUFFLE(3, 2, 3, 2));
+            r[i + 2] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(1, 0, 1, 0));
+            r[i + 3] = _mm256_shuffle_ps(t[i + 1], t[i + 3], _MM_SHUFFLE(3, 2, 3, 2));
+        }
+        MYSIMD_UNROLL
+        for (size_t i = 0; i < 4; ++i) {
+            _mm256_storeu_ps(b + static_cast<ptrdiff_t>(i) * rsb, _mm256_permute2f128_ps(r[i], r[i + 4], 0x20));
+            _mm256_storeu_ps(b + static_cast<ptrdiff_t>(i + 4) * rsb, _mm256_permute2f128_ps(r[i], r[i + 4], 0x31));
+        }
+    }
+};
+
+#endif
+
+// b = a^T for a block of at most transposeLeaf on a side: whole tiles, then the edges
+template <typename T>
+void transposeBlock(size_t rows, size_t cols, const T *a, ptrdiff_t rsa, T *b, ptrdiff_t rsb)
+{
+    constexpr size_t E = TransposeTile<T>::E;
+    size_t rows0 = rows / E * E;
+    size_t cols0 = cols / E * E;
+    for (size_t i = 0; i < rows0; i += E) {
+        for (size_t j = 0; j < cols0; j += E) {
+            TransposeTile<T>::copy(a + static_cast<ptrdiff_t>(i) * rsa + static_cast<ptrdiff_t>(j), rsa,
+                                   b + static_cast<ptrdiff_t>(j) * rsb + static_cast<ptrdiff_t>(i), rsb);
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        const T *row = a + static_cast<ptrdiff_t>(i) * rsa;
+        for (size_t j = i < rows0 ? cols0 : 0; j < cols; ++j) {
+            b[static_cast<ptrdiff_t>(j) * rsb + static_cast<ptrdiff_t>(i)] = row[j];
+        }
+    }
+}
+
+// Split point of a dimension, a multiple of the tile size so that the halves stay aligned on tiles
+template <typename T>
+size_t transposeSplit(size_t n)
+{
+    constexpr size_t E = TransposeTile<T>::E;
+    return std::max(E, n / 2 / E * E);
+}
+
+// b = a^T, a is rows x cols and b cols x rows, recursively halving the larger dimension
+template <typename T>
+void transposeRecursive(size_t rows, size_t cols, const T *a, ptrdiff_t rsa, T *b, ptrdiff_t rsb)
+{
+    if (rows <= transposeLeaf && cols <= transposeLeaf) {
+        transposeBlock(rows, cols, a, rsa, b, rsb);
+    }
+    else if (rows >= cols) {
+        size_t h = transposeSplit<T>(rows);
+        transposeRecursive(h, cols, a, rsa, b, rsb);
+        transposeRecursive(rows - h, cols, a + static_cast<ptrdiff_t>(h) * rsa, rsa, b + h, rsb);
+    }
+    else {
+        size_t h = transposeSplit<T>(cols);
+        transposeRecursive(rows, h, a, rsa, b, rsb);
+        transposeRecursive(rows, cols - h, a + h, rsa, b + static_cast<ptrdiff_t>(h) * rsb, rsb);
+    }
+}
+
+// Side of the square tiles a parallel transpose is split into, a whole number of micro-tiles
+template <typename T>
+size_t transposeTileSide(const MyExec::Context &ctx)
+{
+    constexpr size_t E = TransposeTile<T>::E;
+    size_t side = static_cast<size_t>(std::sqrt(static_cast<double>(ctx.tileBytes / sizeof(T))));
+    return std::max(transposeLeaf, side / E * E);
+}
+
+// b = a^T, a is rows x cols with row stride rsa, b is cols x rows with row stride rsb.
+// a and b must not overlap.
+template <typename T>
+void transposeCopy(size_t rows, size_t cols, const T *a, ptrdiff_t rsa, T *b, ptrdiff_t rsb)
+{
+    size_t n = rows * cols;
+    MyExec::ThreadPool *pool = n >= MyExec::minParallelElements ?
+        MyExec::current().poolFor(n, MyExec::current().serialElements) : nullptr;
+    if (!pool) {
+        transposeRecursive(rows, cols, a, rsa, b, rsb);
+        return;
+    }
+    size_t side = transposeTileSide<T>(MyExec::current());
+    size_t rowTiles = (rows + side - 1) / side;
+    size_t colTiles = (cols + side - 1) / side;
+    MyExec::forEachTile(pool, rowTiles * colTiles, [&](size_t t) {
+        size_t i = t / colTiles * side;
+        size_t j = t % colTiles * side;
+        transposeRecursive(std::min(side, rows - i), std::min(side, cols - j),
+                           a + static_cast<ptrdiff_t>(i) * rsa + static_cast<ptrdiff_t>(j), rsa,
+                           b + static_cast<ptrdiff_t>(j) * rsb + static_cast<ptrdiff_t>(i), rsb);
+    });
+}
+
+// Exchange a (rows x cols) with the transpose of b (cols x rows): a = b^T and b = a^T.
+// Both are in the same matrix, with row stride rs, and don't overlap.
+template <typename T>
+void transposeSwap(size_t rows, size_t cols, T *a, T *b, ptrdiff_t rs)
+{
+    constexpr size_t E = TransposeTile<T>::E;
+    if (rows > transposeLeaf || cols > transposeLeaf) {
+        if (rows >= cols) {
+            size_t h = transposeSplit<T>(rows);
+            transposeSwap(h, cols, a, b, rs);
+            transposeSwap(rows - h, cols, a + static_cast<ptrdiff_t>(h) * rs, b + h, rs);
+        }
+        else {
+            size_t h = transposeSplit<T>(cols);
+            transposeSwap(rows, h, a, b, rs);
+            transposeSwap(rows, cols - h, a + h, b + static_cast<ptrdiff_t>(h) * rs, rs);
+        }
+        return;
+    }
+
+    size_t rows0 = rows / E * E;
+    size_t cols0 = cols / E * E;
+    alignas(64) T tile[E * E];
+    for (size_t i = 0; i < rows0; i += E) {
+        for (size_t j = 0; j < cols0; j += E) {
+            T *ta = a + static_cast<ptrdiff_t>(i) * rs + static_cast<ptrdiff_t>(j);
+            T *tb = b + static_cast<ptrdiff_t>(j) * rs + static_cast<ptrdiff_t>(i);
+            TransposeTile<T>::copy(ta, rs, tile, E);
+            TransposeTile<T>::copy(tb, rs, ta, rs);
+            for (size_t k = 0; k < E; ++k) {
+                std::copy_n(tile + k * E, E, tb + static_cast<ptrdiff_t>(k) * rs);
+            }
+        }
+    }
+    for (size_t i = 0; i < rows; ++i) {
+        for (size_t j = i < rows0 ? cols0 : 0; j < cols; ++j) {
+            std::swap(a[static_cast<ptrdiff_t>(i) * rs + static_cast<ptrdiff_t>(j)],
+                      b[static_cast<ptrdiff_t>(j) * rs + static_cast<ptrdiff_t>(i)]);
+        }
+    }
+}
+
+// a = a^T for an n x n block on the diagonal
+template <typename T>
+void transposeDiagonal(size_t n, T *a, ptrdiff_t rs)
+{
+    if (n > transposeLeaf) {
+        size_t h = transposeSplit<T>(n);
+        transposeDiagonal(h, a, rs);
+        transposeDiagonal(n - h, a + static_cast<ptrdiff_t>(h) * rs + static_cast<ptrdiff_t>(h), rs);
+        transposeSwap(h, n - h, a + h, a + static_cast<ptrdiff_t>(h) * rs, rs);
+        return;
+    }
+
+    constexpr size_t E = TransposeTile<T>::E;
+    size_t n0 = n / E * E;
+    alignas(64) T tile[E * E];
+    for (size_t i = 0; i < n0; i += E) {
+        T *d = a + static_cast<ptrdiff_t>(i) * rs + static_cast<ptrdiff_t>(i);
+        TransposeTile<T>::copy(d, rs, tile, E);
+        for (size_t k = 0; k < E; ++k) {
+            std::copy_n(tile + k * E, E, d + static_cast<ptrdiff_t>(k) * rs);
+        }
+        if (i + E < n0) {
+            transposeSwap(E, n0 - i - E, d + E, d + static_cast<ptrdiff_t>(E) * rs, rs);
+        }
+    }
+    for (size_t i = 0; i < n; ++i) {
+        for (size_t j = std::max(i + 1, n0); j < n; ++j) {
+            std::swap(a[static_cast<ptrdiff_t>(i) * rs + static_cast<ptrdiff_t>(j)],
+                      a[static_cast<ptrdiff_t>(j) * rs + static_cast<ptrdiff_t>(i)]);
+        }
+    }
+}
+
+// a = a^T in place, a is n x n with row stride rs
+template <typename T>
+void transposeSquare(size_t n, T *a, ptrdiff_t rs)
+{
+    size_t elements = n * n;
+    MyExec::ThreadPool *pool = elements >= MyExec::minParallelElements ?
+        MyExec::current().poolFor(elements, MyExec::current().serialElements) : nullptr;
+    if (!pool) {
+        transposeDiagonal(n, a, rs);
+        return;
+    }
+    // One tile per block on the diagonal, and per pair of blocks on either side of it
+    size_t side = transposeTileSide<T>(MyExec::current());
+    size_t blocks = (n + side - 1) / side;
+    std::vector<std::pair<size_t, size_t>> pairs;
+    pairs.reserve(blocks * (blocks + 1) / 2);
+    for (size_t i = 0; i < blocks; ++i) {
+        for (size_t j = i; j < blocks; ++j) {
+            pairs.emplace_back(i * side, j * side);
+        }
+    }
+    MyExec::forEachTile(pool, pairs.size(), [&](size_t t) {
+        auto [i, j] = pairs[t];
+        T *upper = a + static_cast<ptrdiff_t>(i) * rs + static_cast<ptrdiff_t>(j);
+        if (i == j) {
+            transposeDiagonal(std::min(side, n - i), upper, rs);
+        }
+        else {
+            transposeSwap(std::min(side, n - i), std::min(side, n - j), upper,
+                          a + static_cast<ptrdiff_t>(j) * rs + static_cast<ptrdiff_t>(i), rs);
+        }
+    });
+}
+
+// a = a^T in place for contiguous rows x cols storage, which becomes cols x rows. The
+// element at k = i * cols + j goes to j * rows + i = k * rows mod (rows * cols - 1);
+// each cycle of that permutation is rotated once, with a bit per element marking the
+// elements already moved.
+template <typename T>
+void transposeCycles(size_t rows, size_t cols, T *a)
+{
+    if (rows <= 1 || cols <= 1) {
+        return;
+    }
+    if (rows == cols) {
+        transposeSquare(rows, a, static_cast<ptrdiff_t>(cols));
+        return;
+    }
+    const size_t last = rows * cols - 1;
+    std::vector<bool> moved(last);
+    for (size_t start = 1; start < last; ++start) {
+        if (moved[start]) {
+            continue;
+        }
+        T carry = a[start];
+        size_t k = start;
+        do {
+            k = k * rows % last;
+            std::swap(carry, a[k]);
+            moved[k] = true;
+        } while (k != start);
+    }
+}
+
+} // namespace detail
+} // namespace MyMatrix
+
+#endif // TRANSPOSE_H
@@ -0,0 +1,1004 @@
+//
+//  tests.cpp
+//  Matrix
+//
+//  Created by Sylvan Canales on 10/17/26.
+//
+
+/*!
+ * \brief Checks of the kernels against naive reference implementations
+ * \details Every test computes a result with the library and with plain loops, and
+ * compares the two. The tests run twice: once on the calling thread only, and once
+ * with a thread pool and no serial threshold, so that the tiled parallel paths of
+ * myexec.h are taken by everything large enough to be split.
+ *
+ * \verbatim
+ * tests [filter]
+ * \endverbatim
+ *
+ * Only the tests whose name contains filter run. The exit status is the number of
+ * failed checks, capped at 1.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "mymat.h"
+#include "mydynmat.h"
+#include "myvec.h"
+#include "mydynvec.h"
+#include "myvecbatch.h"
+#include "myblas.h"
+#include "mydecomp.h"
+#include "myquant.h"
+#include "mysparse.h"
+#include "myio.h"
+#include "mytext.h"
+#include "mypipeline.h"
+
+using namespace MyMatrix;
+using namespace MyVector;
+
+namespace {
+
+int failures = 0;
+const char *currentTest = "";
+const char *currentMode = "";
+
+void fail(const char *file, int line, const char *what)
+{
+    ++failures;
+    std::cerr << file << ":" << line << ": " << currentTest << " (" << currentMode << "): " << what << "\n";
+}
+
+#define CHECK(cond) do { if (!(cond)) { fail(__FILE__, __LINE__, #cond); } } while (0)
+
+template <typename Iter>
+void fillRandom(Iter first, Iter last, unsigned seed, double lo = -1, double hi = 1)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<double> dist(lo, hi);
+    for (; first != last; ++first) {
+        *first = static_cast<typename std::iterator_traits<Iter>::value_type>(dist(gen));
+    }
+}
+
+template <typename T = double>
+MyDynMat<T> randomMat(size_t rows, size_t cols, unsigned seed)
+{
+    MyDynMat<T> m(rows, cols);
+    fillRandom(m.data(), m.data() + m.size(), seed);
+    return m;
+}
+
+template <typename T = double>
+MyDynVec<T> randomVec(size_t n, unsigned seed)
+{
+    MyDynVec<T> v(n);
+    fillRandom(v.data(), v.data() + v.size(), seed);
+    return v;
+}
+
+// Largest difference between two matrices of the same shape, relative to the largest element
+template <typename M1, typename M2>
+double relError(const M1 &a, const M2 &b)
+{
+    if (a.rows() != b.rows() || a.cols() != b.cols()) {
+        return INFINITY;
+    }
+    double diff = 0;
+    double scale = 1;
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < a.cols(); ++j) {
+            diff = std::max(diff, std::fabs(double(a(i, j)) - double(b(i, j))));
+            scale = std::max(scale, std::fabs(double(b(i, j))));
+        }
+    }
+    return diff / scale;
+}
+
+template <typename V1, typename V2>
+double relErrorVec(const V1 &a, const V2 &b, size_t n)
+{
+    double diff = 0;
+    double scale = 1;
+    for (size_t i = 0; i < n; ++i) {
+        diff = std::max(diff, std::fabs(double(a[i]) - double(b[i])));
+        scale = std::max(scale, std::fabs(double(b[i])));
+    }
+    return diff / scale;
+}
+
+// The naive references
+
+template <typename MA, typename MB>
+MyDynMat<double> naiveMultiply(const MA &a, const MB &b)
+{
+    MyDynMat<double> c(a.rows(), b.cols());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < b.cols(); ++j) {
+            double sum = 0;
+            for (size_t k = 0; k < a.cols(); ++k) {
+                sum += double(a(i, k)) * double(b(k, j));
+            }
+            c(i, j) = sum;
+        }
+    }
+    return c;
+}
+
+template <typename M>
+MyDynMat<double> naiveTranspose(const M &a)
+{
+    MyDynMat<double> t(a.cols(), a.rows());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        for (size_t j = 0; j < a.cols(); ++j) {
+            t(j, i) = a(i, j);
+        }
+    }
+    return t;
+}
+
+// The tests
+
+void testGemm()
+{
+    const size_t sizes[][3] = {{1, 1, 1}, {3, 5, 2}, {17, 31, 9}, {64, 64, 64}, {130, 70, 90}, {257, 129, 65}};
+    unsigned seed = 1;
+    for (const auto &s : sizes) {
+        auto a = randomMat(s[0], s[1], seed++);
+        auto b = randomMat(s[1], s[2], seed++);
+        CHECK(relError(a * b, naiveMultiply(a, b)) < 1e-12);
+        auto af = randomMat<float>(s[0], s[1], seed++);
+        auto bf = randomMat<float>(s[1], s[2], seed++);
+        CHECK(relError(af * bf, naiveMultiply(af, bf)) < 1e-4);
+
+        // Views, and gemm with alpha and beta
+        auto at = randomMat(s[1], s[0], seed++);
+        CHECK(relError(at.transposed() * b, naiveMultiply(naiveTranspose(at), b)) < 1e-12);
+        auto c = randomMat(s[0], s[2], seed++);
+        MyDynMat<double> expected = naiveMultiply(a, b) * 2.0 + c * 0.5;
+        gemm(2.0, a, b, 0.5, c);
+        CHECK(relError(c, expected) < 1e-12);
+
+        // Matrix x vector
+        auto x = randomVec(s[1], seed++);
+        MyDynVec<double> y = a * x;
+        MyDynMat<double> xm(s[1], 1);
+        std::copy_n(x.data(), x.size(), xm.data());
+        CHECK(relErrorVec(y, naiveMultiply(a, xm).data(), s[0]) < 1e-12);
+    }
+
+    MyMat<double,5,7> a5;
+    MyMat<double,7,3,Layout::ColMajor> b5;
+    fillRandom(a5.begin(), a5.end(), 7);
+    fillRandom(b5.data(), b5.data() + b5.size(), 8);
+    MyMat<double,3,3> a3;
+    fillRandom(a3.begin(), a3.end(), 9);
+    MyMat<double,5,3> c5 = a5 * MyMat<double,7,3>(b5.view());
+    CHECK(relError(c5, naiveMultiply(a5, b5)) < 1e-12);
+    CHECK(relError(a3 * a3, naiveMultiply(a3, a3)) < 1e-12);
+}
+
+// Element i of a vector, or of a view of one row or column
+template <typename V>
+double elementOf(const V &v, size_t i)
+{
+    if constexpr (isView<V>) {
+        return v.rows() == 1 ? v(0, i) : v(i, 0);
+    }
+    else {
+        return v[i];
+    }
+}
+
+template <typename M, typename X>
+std::vector<double> naiveGemv(double alpha, const M &a, const X &x, double beta, const std::vector<double> &y)
+{
+    std::vector<double> r(a.rows());
+    for (size_t i = 0; i < a.rows(); ++i) {
+        double sum = 0;
+        for (size_t j = 0; j < a.cols(); ++j) {
+            sum += double(a(i, j)) * elementOf(x, j);
+        }
+        r[i] = alpha * sum + (beta == 0 ? 0 : beta * y[i]);
+    }
+    return r;
+}
+
+void testBlas()
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    for (size_t rows : {1, 4, 37, 300}) {
+        for (size_t cols : {1, 5, 64, 129}) {
+            const unsigned seed = unsigned(rows * 1000 + cols);
+            auto a = randomMat(rows, cols, seed);
+            auto at = randomMat(cols, rows, seed + 1);
+            auto x = randomVec(cols, seed + 2);
+            auto y = randomVec(rows, seed + 3);
+            std::vector<double> y0(y.begin(), y.end());
+
+            // Row-major a, then a column-major one through a transposed view
+            MyDynVec<double> r = y;
+            gemv(1.5, a, x, 0.5, r);
+            CHECK(relErrorVec(r, naiveGemv(1.5, a, x, 0.5, y0), rows) < 1e-12);
+            r = y;
+            gemv(-1.0, at.transposed(), x, 2.0, r);
+            CHECK(relErrorVec(r, naiveGemv(-1.0, at.transposed(), x, 2.0, y0), rows) < 1e-12);
+
+            // Strided x and y: a column of a matrix, and a row of one
+            auto xs = randomMat(cols, 3, seed + 4);
+            MyDynMat<double> ys(2, rows);
+            std::fill(ys.data(), ys.data() + ys.size(), nan);
+            gemv(1.0, a, xs.col(1), 0.0, ys.row(1));
+            CHECK(relErrorVec(ys.row(1).data(), naiveGemv(1.0, a, xs.col(1), 0, y0), rows) < 1e-12);
+            gemv(1.0, at.transposed(), xs.col(2), 0.0, ys.row(0));
+            CHECK(relErrorVec(ys.row(0).data(), naiveGemv(1.0, at.transposed(), xs.col(2), 0, y0), rows) < 1e-12);
+
+            // beta == 0 overwrites NaNs
+            std::fill(r.begin(), r.end(), nan);
+            gemv(1.0, a, x, 0.0, r);
+            CHECK(relErrorVec(r, naiveGemv(1.0, a, x, 0, y0), rows) < 1e-12);
+            MyDynMat<double> c(rows, rows);
+            std::fill(c.data(), c.data() + c.size(), nan);
+            gemm(1.0, a, at, 0.0, c);
+            CHECK(relError(c, naiveMultiply(a, at)) < 1e-12);
+
+            // ger, on a row-major matrix and on a column-major view
+            MyDynMat<double> g = a;
+            ger(0.25, y, x, g);
+            MyDynMat<double> expected = a;
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    expected(i, j) += 0.25 * y[i] * x[j];
+                }
+            }
+            CHECK(relError(g, expected) < 1e-12);
+            MyDynMat<double> gt = a.copyTransposed();
+            ger(0.25, y, xs.col(0), gt.transposed());
+            for (size_t i = 0; i < rows; ++i) {
+                for (size_t j = 0; j < cols; ++j) {
+                    expected(i, j) = a(i, j) + 0.25 * y[i] * xs(j, 0);
+                }
+            }
+            CHECK(relError(gt.transposed(), expected) < 1e-12);
+        }
+    }
+
+    // axpy, scal and dot, contiguous and strided
+    for (size_t n : {1, 7, 1000, 10007}) {
+        auto x = randomVec(n, unsigned(n));
+        auto y = randomVec(n, unsigned(n + 1));
+        auto m = randomMat(n, 3, unsigned(n + 2));
+        double expectedDot = 0;
+        double expectedStrided = 0;
+        for (size_t i = 0; i < n; ++i) {
+            expectedDot += x[i] * y[i];
+            expectedStrided += x[i] * m(i, 2);
+        }
+        CHECK(std::fabs(dot(x, y) - expectedDot) < 1e-9);
+        CHECK(std::fabs(dot(x, m.col(2)) - expectedStrided) < 1e-9);
+
+        MyDynVec<double> z = y;
+        axpy(3.0, x, z);
+        MyDynMat<double> mz = m;
+        axpy(3.0, x, mz.col(1));
+        scal(-2.0, mz.col(0));
+        for (size_t i = 0; i < n; ++i) {
+            CHECK(std::fabs(z[i] - (y[i] + 3.0 * x[i])) < 1e-12);
+            CHECK(std::fabs(mz(i, 1) - (m(i, 1) + 3.0 * x[i])) < 1e-12);
+            CHECK(mz(i, 0) == -2.0 * m(i, 0));
+        }
+        scal(0.5, z);
+        CHECK(std::fabs(z[0] - 0.5 * (y[0] + 3.0 * x[0])) < 1e-12);
+    }
+
+    // Every operand of fixed size, small and large
+    MyMat<double,3,4> a3;
+    MyVec<double,4> x3;
+    MyVec<double,3> y3{nan, nan, nan};
+    fillRandom(a3.begin(), a3.end(), 100);
+    fillRandom(x3.begin(), x3.end(), 101);
+    gemv(2.0, a3, x3, 0.0, y3);
+    CHECK(relErrorVec(y3, naiveGemv(2.0, a3, x3, 0, {}), 3) < 1e-12);
+    MyMat<double,4,4> c4;
+    std::fill(c4.begin(), c4.end(), nan);
+    gemm(1.0, a3.transposed(), a3, 0.0, c4);
+    CHECK(relError(c4, naiveMultiply(a3.transposed(), a3)) < 1e-12);
+
+    static MyMat<float,96,80> a96;
+    static MyMat<float,80,72,Layout::ColMajor> b80;
+    static MyMat<float,96,72> c96;
+    fillRandom(a96.begin(), a96.end(), 102);
+    fillRandom(b80.data(), b80.data() + b80.size(), 103);
+    std::fill(c96.begin(), c96.end(), std::numeric_limits<float>::quiet_NaN());
+    gemm(1.0f, a96, b80, 0.0f, c96);
+    CHECK(relError(c96, naiveMultiply(a96, b80)) < 1e-4);
+    MyVec<float,80> x80;
+    MyVec<float,96> y96;
+    fillRandom(x80.begin(), x80.end(), 104);
+    gemv(1.0f, a96, x80, 0.0f, y96);
+    CHECK(relErrorVec(y96, naiveGemv(1.0, a96, x80, 0, {}), 96) < 1e-4);
+    MyMat<float,96,80> g96 = a96;
+    ger(1.0f, y96, x80, g96);
+    CHECK(std::fabs(g96(95, 79) - (a96(95, 79) + y96[95] * x80[79])) < 1e-4);
+}
+
+void testDecompositions()
+{
+    for (size_t n : {3, 8, 50, 150}) {
+        auto a = randomMat(n, n, unsigned(n));
+        for (size_t i = 0; i < n; ++i) {
+            a(i, i) += 2;
+        }
+        auto b = randomVec(n, unsigned(n + 1));
+        MyDynVec<double> x;
+        CHECK(solve(a, b, x));
+        CHECK(relErrorVec(a * x, b, n) < 1e-9);
+
+        // PA = LU
+        MyDynMat<double> lu = a;
+        std::vector<size_t> pivots;
+        CHECK(luDecompose(lu, pivots));
+        MyDynMat<double> l(n, n), u(n, n), pa = a;
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n; ++j) {
+                l(i, j) = i == j ? 1 : (j < i ? lu(i, j) : 0);
+                u(i, j) = j >= i ? lu(i, j) : 0;
+            }
+        }
+        for (size_t k = 0; k < n; ++k) {
+            for (size_t j = 0; j < n; ++j) {
+                std::swap(pa(k, j), pa(pivots[k], j));
+            }
+        }
+        CHECK(relError(naiveMultiply(l, u), pa) < 1e-10);
+
+        // A = LL^T of a symmetric positive definite matrix
+        MyDynMat<double> spd = naiveMultiply(a, naiveTranspose(a));
+        for (size_t i = 0; i < n; ++i) {
+            spd(i, i) += double(n);
+        }
+        MyDynMat<double> chol = spd;
+        CHECK(choleskyDecompose(chol));
+        CHECK(relError(naiveMultiply(chol, naiveTranspose(chol)), spd) < 1e-10);
+
+        MyDynMat<double> inv;
+        CHECK(inverse(a, inv));
+        CHECK(relError(naiveMultiply(a, inv), makeIdentity(n)) < 1e-9);
+    }
+
+    // Least squares: the residual of the QR solution is orthogonal to the columns of A
+    for (size_t cols : {3, 20, 70}) {
+        size_t rows = 2 * cols + 5;
+        auto a = randomMat(rows, cols, unsigned(cols));
+        auto b = randomMat(rows, 1, unsigned(cols + 1));
+        MyDynMat<double> qr = a;
+        std::vector<double> tau;
+        qrDecompose(qr, tau);
+        MyDynMat<double> x = b;
+        CHECK(qrSolve(qr.view(), tau.data(), x.view()));
+        MyDynMat<double> solution(cols, 1);
+        for (size_t j = 0; j < cols; ++j) {
+            solution(j, 0) = x(j, 0);
+        }
+        MyDynMat<double> residual = naiveMultiply(a, solution) - b;
+        MyDynMat<double> normal = naiveMultiply(naiveTranspose(a), residual);
+        CHECK(relError(normal, MyDynMat<double>(cols, 1)) < 1e-9);
+    }
+
+    MyMat<double,4,4> m4;
+    fillRandom(m4.begin(), m4.end(), 11);
+    MyMat<double,4,4> inv4;
+    CHECK(inverse(m4, inv4));
+    CHECK(relError(m4 * inv4, (makeIdentity<double,4,4>())) < 1e-9);
+}
+
+void testTransposes()
+{
+    unsigned seed = 20;
+    for (size_t rows : {1, 2, 7, 33, 64, 200}) {
+        for (size_t cols : {1, 3, 16, 65, 300}) {
+            auto a = randomMat(rows, cols, seed++);
+            auto ref = naiveTranspose(a);
+            CHECK(relError(a.copyTransposed(), ref) == 0);
+
+            MyDynMat<double> t = a;
+            t.transpose();
+            CHECK(relError(t, ref) == 0);
+
+            // Across layouts, through views
+            MyDynMat<double> u(cols, rows);
+            u.view() = a.transposed();
+            CHECK(relError(u, ref) == 0);
+        }
+    }
+
+    MyMat<float,40,24> f;
+    fillRandom(f.begin(), f.end(), 30);
+    CHECK(relError(f.copyTransposed(), naiveTranspose(f)) == 0);
+    MyMat<float,40,40,Layout::ColMajor> g;
+    fillRandom(g.data(), g.data() + g.size(), 31);
+    auto gt = naiveTranspose(g);
+    g.transpose();
+    CHECK(relError(g, gt) == 0);
+}
+
+void testAliasing()
+{
+    unsigned seed = 40;
+    for (size_t rows : {1, 2, 5, 64, 130}) {
+        for (size_t cols : {1, 3, 64, 97}) {
+            const auto a = randomMat(rows, cols, seed++);
+            const auto ref = a.copyTransposed();
+
+            MyDynMat<double> m = a;
+            m = m.transposed();
+            CHECK(m == ref);
+
+            m = a;
+            m = m.transposed() * 2.0;
+            CHECK(relError(m, MyDynMat<double>(ref * 2.0)) == 0);
+
+            if (rows == cols) {
+                m = a;
+                m = m.transposed() + m;
+                CHECK(relError(m, MyDynMat<double>(ref + a)) == 0);
+            }
+            if (rows > 2 && cols > 2) {
+                m = a;
+                m = m.block(1, 1, rows - 1, cols - 1);
+                MyDynMat<double> block(rows - 1, cols - 1);
+                for (size_t i = 0; i + 1 < rows; ++i) {
+                    for (size_t j = 0; j + 1 < cols; ++j) {
+                        block(i, j) = a(i + 1, j + 1);
+                    }
+                }
+                CHECK(m == block);
+            }
+            m = a;
+            m = m.view();
+            CHECK(m == a);
+        }
+    }
+
+    MyMat<double,6,6> f;
+    fillRandom(f.begin(), f.end(), 50);
+    const auto fixedRef = f.copyTransposed();
+    f = f.transposed();
+    CHECK(f == fixedRef);
+    MyMat<float,70,70,Layout::ColMajor> g;
+    fillRandom(g.data(), g.data() + g.size(), 51);
+    const auto g0 = g;
+    g = g.transposed() - g;
+    CHECK(relError(g, MyMat<float,70,70,Layout::ColMajor>(g0.copyTransposed() - g0)) == 0);
+}
+
+void testAllocators()
+{
+    using ArenaMat = MyDynMat<double, MyMemory::ArenaAllocator<double>>;
+    MyMemory::Arena arena;
+    const MyMemory::ArenaAllocator<double> alloc(arena);
+
+    const auto a = randomMat(37, 21, 60);
+    ArenaMat b(a.rows(), a.cols(), alloc);
+    b.view() = a.view();
+
+    // A view has no arena, so it is passed along
+    ArenaMat t(b.transposed(), alloc);
+    CHECK(t.get_allocator() == alloc && t == a.copyTransposed());
+    ArenaMat block(b.block(2, 3, 20, 10), alloc);
+    CHECK(block.rows() == 20 && block.cols() == 10);
+    CHECK(block.get_allocator() == alloc && block(0, 0) == a(2, 3) && block(19, 9) == a(21, 12));
+
+    // An expression over arena matrices keeps their arena
+    ArenaMat sum = b * 2.0 + b;
+    CHECK(sum.get_allocator() == alloc && relError(sum, MyDynMat<double>(a * 3.0)) < 1e-15);
+
+    // Alignments above a cache line, within a block and for a new one
+    MyMemory::Arena small(1 << 14);
+    for (size_t align : {size_t(1), size_t(8), size_t(64), size_t(256), size_t(4096)}) {
+        small.allocate(24, 8);
+        auto p = reinterpret_cast<uintptr_t>(small.allocate(100, align));
+        CHECK(p % std::max<size_t>(align, MyMemory::cacheLine) == 0);
+        auto q = reinterpret_cast<uintptr_t>(small.allocate(1 << 15, align));
+        CHECK(q % std::max<size_t>(align, MyMemory::cacheLine) == 0);
+    }
+}
+
+void testQuantized()
+{
+    for (size_t rows : {1, 5, 64}) {
+        for (size_t depth : {3, 64, 200}) {
+            auto a = randomMat<float>(rows, depth, unsigned(rows * depth));
+            auto b = randomMat<float>(37, depth, unsigned(rows + depth));
+            for (QuantScheme scheme : {QuantScheme::PerTensor, QuantScheme::PerRow}) {
+                auto qa = quantize<int8_t>(a, scheme);
+                auto qb = quantize<int8_t>(b, scheme);
+                MyDynMat<int32_t> c(rows, 37);
+                multiplyTransposed(qa, qb, c.view());
+                MyDynMat<double> real(rows, 37);
+                for (size_t i = 0; i < rows; ++i) {
+                    for (size_t j = 0; j < 37; ++j) {
+                        int64_t sum = 0;
+                        double value = 0;
+                        for (size_t k = 0; k < depth; ++k) {
+                            sum += int64_t(qa(i, k) - qa.params(i).zeroPoint) * (qb(j, k) - qb.params(j).zeroPoint);
+                            value += double(qa.value(i, k)) * qb.value(j, k);
+                        }
+                        CHECK(c(i, j) == sum);
+                        real(i, j) = value;
+                    }
+                }
+                CHECK(relError(multiplyTransposed(qa, qb), real) < 1e-4);
+            }
+
+            auto x = randomVec<float>(depth, unsigned(depth));
+            auto qa16 = quantize<int16_t>(a);
+            auto qx16 = quantize<int16_t>(x);
+            MyDynVec<int64_t> y(rows);
+            multiply(qa16, qx16, y);
+            for (size_t i = 0; i < rows; ++i) {
+                int64_t sum = 0;
+                for (size_t k = 0; k < depth; ++k) {
+                    sum += int64_t(qa16(i, k) - qa16.params(i).zeroPoint) * (qx16[k] - qx16.params().zeroPoint);
+                }
+                CHECK(y[i] == sum);
+            }
+        }
+    }
+
+    // A long row of positive values, as after a ReLU: the zero point is -127 and the sums
+    // of (q - zp)^2 leave int32, past which only the float results are exact
+    for (size_t depth : {40000, 300000}) {
+        MyDynMat<float> a(1, depth);
+        for (size_t k = 0; k < depth; ++k) {
+            a(0, k) = float(k % 7) / 6;
+        }
+        auto qa = quantize<int8_t>(a);
+        CHECK(qa.params().zeroPoint == -127);
+        double expected = 0;
+        for (size_t k = 0; k < depth; ++k) {
+            expected += double(qa.value(0, k)) * qa.value(0, k);
+        }
+        CHECK(std::fabs(multiplyTransposed(qa, qa)(0, 0) / expected - 1) < 1e-5);
+        MyQuantVec<int8_t> x(depth, qa.params());
+        std::copy_n(qa.row(0), depth, x.data());
+        CHECK(std::fabs((qa * x)[0] / expected - 1) < 1e-5);
+    }
+}
+
+void testSparse()
+{
+    std::mt19937 gen(60);
+    for (size_t n : {1, 10, 300}) {
+        MyDynMat<double> dense(n, n + 7);
+        MyCooMat<double> coo(n, n + 7);
+        std::uniform_real_distribution<double> dist(-1, 1);
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t j = 0; j < n + 7; ++j) {
+                if (gen() % 10 == 0) {
+                    double v = dist(gen);
+                    coo.add(i, j, v);
+                    dense(i, j) += v;
+                }
+            }
+        }
+        MyCsrMat<double> csr(coo);
+        CHECK(csr.toDense() == dense);
+        CHECK(MyCsrMat<double>(dense).toDense() == dense);
+        CHECK(relError(csr.copyTransposed().toDense(), naiveTranspose(dense)) == 0);
+
+        auto x = randomVec(n + 7, unsigned(n));
+        MyDynVec<double> y = csr * x;
+        CHECK(relErrorVec(y, MyDynVec<double>(dense * x), n) < 1e-12);
+        auto b = randomMat(n + 7, 5, unsigned(n + 1));
+        CHECK(relError(csr * b, naiveMultiply(dense, b)) < 1e-12);
+    }
+}
+
+void testBinaryIO()
+{
+    auto a = randomMat(37, 19, 70);
+    std::stringstream ss;
+    CHECK(writeBinary(ss, a));
+    const std::string file = ss.str();
+    MyDynMat<double> back;
+    std::istringstream is(file);
+    CHECK(readBinary(is, back) && back == a);
+
+    // A view of the other layout, read into a column-major MyMat
+    std::stringstream st;
+    CHECK(writeBinary(st, a.block(0, 0, 4, 3).transposed()));
+    MyMat<double,3,4,Layout::ColMajor> fixed;
+    CHECK(readBinary(st, fixed));
+    CHECK(relError(fixed, naiveTranspose(a.block(0, 0, 4, 3))) == 0);
+
+    MyVecBatch<float,3> batch(1000);
+    for (size_t c = 0; c < 3; ++c) {
+        fillRandom(batch.lane(c), batch.lane(c) + batch.size(), unsigned(c));
+    }
+    std::stringstream sb;
+    CHECK(writeBinary(sb, batch));
+    MyVecBatch<float,3> batchBack;
+    CHECK(readBinary(sb, batchBack) && batchBack.size() == batch.size());
+    for (size_t c = 0; c < 3; ++c) {
+        CHECK(std::equal(batch.lane(c), batch.lane(c) + batch.size(), batchBack.lane(c)));
+    }
+    // Read with the allocator of the destination
+    MyMemory::Arena arena;
+    MyVecBatch<float,3,MyMemory::ArenaAllocator<float>> arenaBatch{MyMemory::ArenaAllocator<float>(arena)};
+    sb.clear();
+    sb.seekg(0);
+    CHECK(readBinary(sb, arenaBatch) && arenaBatch.size() == batch.size());
+    CHECK(arenaBatch.get_allocator().arena() == &arena && arenaBatch[999] == batch[999]);
+
+    // Malformed headers and truncated files
+    const uint64_t dataOffset = sizeof(BinaryHeader);
+    auto patched = [&](uint64_t rows, uint64_t cols, uint64_t offset = sizeof(BinaryHeader)) {
+        std::string s = file;
+        BinaryHeader header;
+        std::memcpy(&header, s.data(), sizeof(header));
+        header.rows = rows;
+        header.cols = cols;
+        header.dataOffset = offset;
+        std::memcpy(&s[0], &header, sizeof(header));
+        return s;
+    };
+    // Padding between the header and the elements is skipped
+    std::string padded = patched(37, 19, dataOffset + 16);
+    padded.insert(dataOffset, 16, '\0');
+    std::istringstream paddedIs(padded);
+    back = MyDynMat<double>();
+    CHECK(readBinary(paddedIs, back) && back == a);
+    const std::string malformed[] = {
+        patched(38, 19), patched(uint64_t(1) << 62, 4), patched(uint64_t(1) << 33, uint64_t(1) << 33),
+        patched(~uint64_t(0), ~uint64_t(0)), patched(~uint64_t(0), 0), file.substr(0, file.size() - 1),
+        patched(37, 19, dataOffset + 8), patched(37, 19, file.size() + 8),
+        patched(37, 19, uint64_t(1) << 62), patched(37, 19, ~uint64_t(0) - 7),
+        file.substr(0, 10), "not a matrix file at all, but long enough for a header", ""
+    };
+    for (const std::string &s : malformed) {
+        std::istringstream bad(s);
+        MyDynMat<double> m;
+        CHECK(!readBinary(bad, m));
+        std::istringstream badBatch(s);
+        MyVecBatch<double,19> b;
+        CHECK(!readBinary(badBatch, b));
+    }
+    std::istringstream wrongType(file);
+    MyDynMat<float> f;
+    CHECK(!readBinary(wrongType, f));
+
+    // Mapped files
+    const std::string path = "matrix_tests.bin";
+    CHECK(writeBinary(path, a));
+    MyMappedMat<double> mapped(path);
+    CHECK(mapped && relError(mapped.view(), a) == 0);
+    MyMappedMat<float> mappedWrong(path);
+    CHECK(!mappedWrong);
+    std::remove(path.c_str());
+}
+
+void testTextIO()
+{
+    auto a = randomMat(130, 17, 80);
+    for (char separator : {' ', ','}) {
+        std::stringstream ss;
+        CHECK(writeText(ss, a, separator));
+        MyDynMat<double> back;
+        CHECK(parseText(ss.str(), back) && back == a);
+    }
+    MyMat<int,2,3> fixed;
+    CHECK(parseText("1 2 3\r\n\n4,5,6\n", fixed));
+    CHECK(fixed == (MyMat<int,2,3>{1, 2, 3, 4, 5, 6}));
+    MyDynMat<double> m;
+    CHECK(!parseText("1 2 3\n4 5\n", m));
+    CHECK(!parseText("1 2 x\n", m));
+    CHECK(!parseText("1 2 3\n", fixed));
+}
+
+void testVectors()
+{
+    MyVec<int,3> big{100000, 100000, 100000};
+    CHECK(dotProduct(big, big) == 3e10);
+    MyDynVec<float> f(1 << 16);
+    std::fill(f.begin(), f.end(), 0.1f);
+    CHECK(std::fabs(dotProduct(f, f) - 0.01 * (1 << 16)) < 1e-3);
+}
+
+template <typename T, size_t N>
+double vecError(const MyVec<T,N> &a, const MyVec<T,N> &b)
+{
+    double err = 0;
+    for (size_t c = 0; c < N; ++c) {
+        err = std::max(err, std::fabs(double(a[c]) - double(b[c])));
+    }
+    return err;
+}
+
+template <typename T>
+void checkBatch(size_t count, unsigned seed, double tol)
+{
+    using Vec = MyVec<T,3>;
+    std::vector<Vec> vecs(count);
+    for (Vec &v : vecs) {
+        fillRandom(v.begin(), v.end(), seed++);
+    }
+    // Zero vectors, in the SIMD body and in the tail
+    for (size_t i = 0; i < count; i += 5) {
+        vecs[i] = Vec();
+    }
+    std::vector<Vec> others(count);
+    for (Vec &v : others) {
+        fillRandom(v.begin(), v.end(), seed++);
+    }
+
+    // push_back grows the batch as the range constructor builds it
+    MyVecBatch<T,3> batch;
+    for (const Vec &v : vecs) {
+        batch.push_back(v);
+    }
+    MyVecBatch<T,3> ranged(vecs.begin(), vecs.end());
+    CHECK(batch.size() == count && ranged.size() == count);
+    std::vector<Vec> back(count);
+    batch.copyTo(back.begin());
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(back[i] == vecs[i] && ranged[i] == vecs[i]);
+    }
+
+    auto normalized = batch;
+    normalized.normalize();
+    auto fast = batch;
+    fast.normalizeFast();
+    for (size_t i = 0; i < count; ++i) {
+        if (i % 5 == 0) {
+            CHECK(normalized[i] == Vec() && fast[i] == Vec());
+            continue;
+        }
+        Vec ref = vecs[i];
+        ref.normalize();
+        CHECK(vecError(normalized[i], ref) < tol);
+        CHECK(vecError(fast[i], ref) < 4 * tol);
+    }
+
+    const MyVecBatch<T,3> rhs(others.begin(), others.end());
+    const auto cross = crossProduct(batch, rhs);
+    CHECK(cross.size() == count);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(vecError(cross[i], crossProduct(vecs[i], others[i])) < tol);
+    }
+
+    MyMat<T,4,4> m;
+    fillRandom(m.begin(), m.end(), seed++);
+    auto points = batch;
+    transformPoints(m, points);
+    auto directions = batch;
+    transformVectors(m, directions);
+    for (size_t i = 0; i < count; ++i) {
+        CHECK(vecError(points[i], transformPoint(m, vecs[i])) < 4 * tol);
+        CHECK(vecError(directions[i], transformVector(m, vecs[i])) < 4 * tol);
+    }
+}
+
+void testVecBatch()
+{
+    // Counts below, at and past the SIMD width of either type, with tails of every kind
+    unsigned seed = 100;
+    for (size_t count : {1, 3, 7, 8, 9, 16, 17, 31, 33, 100}) {
+        checkBatch<double>(count, seed, 1e-14);
+        checkBatch<float>(count, seed, 1e-6);
+        seed += 1000;
+    }
+}
+
+void testPipeline()
+{
+    using Point = MyVec<double,3>;
+    std::vector<Point> points(20011);
+    fillRandom(&points[0][0], &points[0][0] + 3 * points.size(), 90);
+    MyMat<double,4,4> m;
+    fillRandom(m.begin(), m.end(), 91);
+    m(3, 0) = m(3, 1) = m(3, 2) = 0;
+    m(3, 3) = 1;
+    const Point forward{0, 0, 1};
+
+    std::vector<Point> expected;
+    for (const Point &p : points) {
+        Point q = transformPoint(m, p);
+        double len = magnitude(q);
+        if (len > 0) {
+            q = q / len;
+        }
+        double d = dotProduct(q, forward);
+        if (d >= -0.25 && d <= 0.75) {
+            expected.push_back(q);
+        }
+    }
+
+    MyPointPipeline<double> pipeline(1000);
+    pipeline.transform(m).normalize().keepDot(forward, -0.25, 0.75);
+    std::vector<Point> kept;
+    size_t total = pipeline.run(rangeReader(points.begin(), points.end()), [&](const Point *p, size_t n) {
+        kept.insert(kept.end(), p, p + n);
+    });
+    CHECK(total == expected.size() && kept.size() == expected.size());
+    double err = 0;
+    for (size_t i = 0; i < std::min(kept.size(), expected.size()); ++i) {
+        for (size_t c = 0; c < 3; ++c) {
+            err = std::max(err, std::fabs(kept[i][c] - expected[i][c]));
+        }
+    }
+    CHECK(err < 1e-12);
+
+    // Exceptions of the reader and the sink reach the caller
+    size_t calls = 0;
+    bool caught = false;
+    try {
+        pipeline.run([&](Point *buffer, size_t capacity) {
+            if (++calls == 3) {
+                throw std::runtime_error("read");
+            }
+            std::fill(buffer, buffer + capacity, Point{0, 0, 1});
+            return capacity;
+        }, [](const Point *, size_t) {});
+    }
+    catch (const std::runtime_error &) {
+        caught = true;
+    }
+    CHECK(caught);
+    caught = false;
+    try {
+        pipeline.run(rangeReader(points.begin(), points.end()), [](const Point *, size_t) {
+            throw std::runtime_error("sink");
+        });
+    }
+    catch (const std::runtime_error &) {
+        caught = true;
+    }
+    CHECK(caught);
+}
+
+void testExceptions()
+{
+    const MyExec::Context &ctx = MyExec::current();
+    MyExec::ThreadPool *pool = ctx.poolFor(1, 0);
+    std::atomic<size_t> ran{0};
+    bool caught = false;
+    try {
+        MyExec::forEachTile(pool, 100, [&](size_t t) {
+            ++ran;
+            if (t % 9 == 4) {
+                throw std::runtime_error("tile");
+            }
+        });
+    }
+    catch (const std::runtime_error &) {
+        caught = true;
+    }
+    // Without a pool the first exception stops the loop, with one every tile runs
+    CHECK(caught && ran == (pool ? 100 : 5));
+}
+
+#if defined(MATRIX_INSTRUMENT)
+std::atomic<uint64_t> hookedDots{0};
+std::atomic<uint64_t> hookedNanoseconds{0};
+
+void countEvent(const MyStats::Event &e)
+{
+    if (std::strcmp(e.operation, "dotProduct") == 0) {
+        ++hookedDots;
+    }
+    hookedNanoseconds += e.nanoseconds;
+}
+
+void testStats()
+{
+    const auto x = randomVec<double>(100, 110);
+    const auto y = randomVec<double>(100, 111);
+    const auto a = randomMat(64, 64, 112);
+    MyDynMat<double> c(64, 64);
+
+    MyStats::reset();
+    CHECK(MyStats::snapshot().empty());
+    hookedDots = 0;
+    hookedNanoseconds = 0;
+    MyStats::setHook(countEvent);
+    double sum = 0;
+    for (int i = 0; i < 3; ++i) {
+        sum += dotProduct(x, y);
+    }
+    gemm(1.0, a, a, 0.0, c);
+    MyStats::setHook(nullptr);
+    dotProduct(x, y);
+    CHECK(std::isfinite(sum));
+
+    const MyStats::Stat *dots = nullptr;
+    const MyStats::Stat *gemms = nullptr;
+    const auto stats = MyStats::snapshot();
+    for (const MyStats::Stat &s : stats) {
+        if (s.operation == "dotProduct" && s.function.find("MyDynVec") != std::string::npos) {
+            dots = &s;
+        }
+        else if (s.operation == "gemm") {
+            gemms = &s;
+        }
+    }
+    CHECK(dots && dots->calls == 4 && dots->elements == 400 && dots->flops == 800 &&
+          dots->bytes == 4 * 100 * 2 * sizeof(double));
+    CHECK(gemms && gemms->calls == 1 && gemms->nanoseconds > 0);
+    // The hook saw the calls made while it was set, and the timed ones with their time
+    CHECK(gemms && hookedDots == 3 && hookedNanoseconds >= gemms->nanoseconds);
+
+    MyStats::reset();
+    CHECK(MyStats::snapshot().empty());
+}
+#endif
+
+struct Test {
+    const char *name;
+    void (*run)();
+};
+
+const Test tests[] = {
+    {"gemm", testGemm},
+    {"blas", testBlas},
+    {"decompositions", testDecompositions},
+    {"transposes", testTransposes},
+    {"aliasing", testAliasing},
+    {"allocators", testAllocators},
+    {"quantized", testQuantized},
+    {"sparse", testSparse},
+    {"binary_io", testBinaryIO},
+    {"text_io", testTextIO},
+    {"vectors", testVectors},
+    {"vecbatch", testVecBatch},
+    {"pipeline", testPipeline},
+    {"exceptions", testExceptions},
+#if defined(MATRIX_INSTRUMENT)
+    {"stats", testStats},
+#endif
+};
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    const std::string filter = argc > 1 ? argv[1] : "";
+
+    MyExec::ThreadPool pool(3);
+    MyExec::Context parallel;
+    parallel.pool = &pool;
+    parallel.serialElements = 0;
+
+    for (const Test &test : tests) {
+        if (std::string(test.name).find(filter) == std::string::npos) {
+            continue;
+        }
+        currentTest = test.name;
+        {
+            currentMode = "serial";
+            MyExec::ScopedContext scope(MyExec::seq);
+            test.run();
+        }
+        {
+            currentMode = "parallel";
+            MyExec::ScopedContext scope(parallel);
+            test.run();
+        }
+        std::cout << test.name << "\n";
+    }
+    std::cout << (failures ? "FAILED: " : "passed, ") << failures << " failed checks\n";
+    return failures ? 1 : 0;
+}